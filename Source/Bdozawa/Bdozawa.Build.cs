@@ -15,13 +15,15 @@ public class Bdozawa : ModuleRules
 			"InputCore",
 			"EnhancedInput",
 			"AIModule",
+			"GameplayTags",
 			"StateTreeModule",
 			"GameplayStateTreeModule",
 			"UMG",
-			"Slate"
+			"Slate",
+			"SlateCore"
 		});
 
-		PrivateDependencyModuleNames.AddRange(new string[] { });
+		PrivateDependencyModuleNames.AddRange(new string[] { "RenderCore" });
 
 		PublicIncludePaths.AddRange(new string[] {
 			"Bdozawa",
@@ -30,9 +32,13 @@ public class Bdozawa : ModuleRules
 			"Bdozawa/Variant_Combat",
 			"Bdozawa/Variant_Combat/AI",
 			"Bdozawa/Variant_Combat/Animation",
+			"Bdozawa/Variant_Combat/Components",
+			"Bdozawa/Variant_Combat/Core",
 			"Bdozawa/Variant_Combat/Gameplay",
 			"Bdozawa/Variant_Combat/Interfaces",
+			"Bdozawa/Variant_Combat/Systems",
 			"Bdozawa/Variant_Combat/UI",
+			"Bdozawa/Shared",
 			"Bdozawa/Variant_SideScrolling",
 			"Bdozawa/Variant_SideScrolling/AI",
 			"Bdozawa/Variant_SideScrolling/Gameplay",
@@ -40,9 +46,6 @@ public class Bdozawa : ModuleRules
 			"Bdozawa/Variant_SideScrolling/UI"
 		});
 
-		// Uncomment if you are using Slate UI
-		// PrivateDependencyModuleNames.AddRange(new string[] { "Slate", "SlateCore" });
-
 		// Uncomment if you are using online features
 		// PrivateDependencyModuleNames.Add("OnlineSubsystem");
 
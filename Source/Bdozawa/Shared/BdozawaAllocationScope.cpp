@@ -0,0 +1,258 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "BdozawaAllocationScope.h"
+
+#if !UE_BUILD_SHIPPING
+
+#include "Bdozawa.h"
+#include "HAL/MemoryBase.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CoreDelegates.h"
+
+namespace BdozawaAllocationCheck
+{
+	/**
+	 *  Forwards to the engine allocator, counting the allocations made on the game thread.
+	 *  Installed over GMalloc the first time a check starts and never removed, since other threads may be inside it at any time
+	 */
+	class FCountingMalloc final : public FMalloc
+	{
+		/** Allocator being forwarded to */
+		FMalloc* InnerMalloc;
+
+	public:
+
+		/** Allocations made on the game thread since the allocator was installed */
+		uint64 GameThreadAllocations = 0;
+
+		explicit FCountingMalloc(FMalloc* InInnerMalloc)
+			: InnerMalloc(InInnerMalloc)
+		{
+		}
+
+		/** Counts an allocation if it was made on the game thread. Only the game thread writes the counter */
+		void CountAllocation()
+		{
+			if (IsInGameThread())
+			{
+				++GameThreadAllocations;
+			}
+		}
+
+		// ~begin FMalloc interface
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+		{
+			CountAllocation();
+			return InnerMalloc->Malloc(Count, Alignment);
+		}
+
+		virtual void* TryMalloc(SIZE_T Count, uint32 Alignment) override
+		{
+			CountAllocation();
+			return InnerMalloc->TryMalloc(Count, Alignment);
+		}
+
+		virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			// shrinking to zero is a free
+			if (Count > 0)
+			{
+				CountAllocation();
+			}
+
+			return InnerMalloc->Realloc(Original, Count, Alignment);
+		}
+
+		virtual void* TryRealloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			if (Count > 0)
+			{
+				CountAllocation();
+			}
+
+			return InnerMalloc->TryRealloc(Original, Count, Alignment);
+		}
+
+		virtual void Free(void* Original) override { InnerMalloc->Free(Original); }
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return InnerMalloc->QuantizeSize(Count, Alignment); }
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return InnerMalloc->GetAllocationSize(Original, SizeOut); }
+		virtual void Trim(bool bTrimThreadCaches) override { InnerMalloc->Trim(bTrimThreadCaches); }
+		virtual void SetupTLSCachesOnCurrentThread() override { InnerMalloc->SetupTLSCachesOnCurrentThread(); }
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override { InnerMalloc->ClearAndDisableTLSCachesOnCurrentThread(); }
+		virtual void InitializeStatsMetadata() override { InnerMalloc->InitializeStatsMetadata(); }
+		virtual void UpdateStats() override { InnerMalloc->UpdateStats(); }
+		virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { InnerMalloc->GetAllocatorStats(OutStats); }
+		virtual void DumpAllocatorStats(FOutputDevice& Ar) override { InnerMalloc->DumpAllocatorStats(Ar); }
+		virtual bool IsInternallyThreadSafe() const override { return InnerMalloc->IsInternallyThreadSafe(); }
+		virtual bool ValidateHeap() override { return InnerMalloc->ValidateHeap(); }
+		virtual const TCHAR* GetDescriptiveName() override { return InnerMalloc->GetDescriptiveName(); }
+		// ~end FMalloc interface
+	};
+
+	/** Counting allocator, once installed */
+	static FCountingMalloc* CountingMalloc = nullptr;
+
+	/** Results for each hot path, keyed by the scope's name literal */
+	static TMap<const TCHAR*, FBdozawaAllocationResult> Results;
+
+	/** Results of the last completed check, merged by name */
+	static TMap<FString, FBdozawaAllocationResult> LastResults;
+
+	/** Frames to skip before measuring, so one-off warmup allocations aren't reported */
+	static int32 WarmupFrames = 0;
+
+	/** Frames left to measure */
+	static int32 FramesRemaining = 0;
+
+	/** True while scopes should measure */
+	static bool bMeasuring = false;
+
+	/** Handle to the end frame delegate */
+	static FDelegateHandle EndFrameHandle;
+
+	/** Returns the number of heap allocations made on the game thread so far */
+	static uint64 GetAllocationCount()
+	{
+		return CountingMalloc ? CountingMalloc->GameThreadAllocations : 0;
+	}
+
+	/** Logs the results and resets the check */
+	static void Report()
+	{
+		// merge scopes that share a name across translation units
+		LastResults.Reset();
+
+		for (const TPair<const TCHAR*, FBdozawaAllocationResult>& Pair : Results)
+		{
+			FBdozawaAllocationResult& Merged = LastResults.FindOrAdd(Pair.Key);
+			Merged.Calls += Pair.Value.Calls;
+			Merged.AllocatingCalls += Pair.Value.AllocatingCalls;
+			Merged.Allocations += Pair.Value.Allocations;
+		}
+
+		LastResults.KeySort(TLess<FString>());
+
+		bool bPassed = true;
+
+		for (const TPair<FString, FBdozawaAllocationResult>& Pair : LastResults)
+		{
+			UE_LOG(LogBdozawa, Display, TEXT("  %-40s calls: %6d  allocating calls: %6d  allocations: %8llu"), *Pair.Key, Pair.Value.Calls, Pair.Value.AllocatingCalls, Pair.Value.Allocations);
+
+			bPassed &= Pair.Value.Allocations == 0;
+		}
+
+		if (bPassed)
+		{
+			UE_LOG(LogBdozawa, Display, TEXT("Allocation check passed: %d hot paths made no heap allocations."), LastResults.Num());
+
+		} else {
+
+			UE_LOG(LogBdozawa, Warning, TEXT("Allocation check failed: some hot paths made heap allocations."));
+		}
+
+		Results.Empty();
+	}
+
+	/** Advances the check at the end of each frame */
+	static void OnEndFrame()
+	{
+		// skip the warmup frames
+		if (WarmupFrames > 0)
+		{
+			bMeasuring = --WarmupFrames == 0;
+			return;
+		}
+
+		if (--FramesRemaining > 0)
+		{
+			return;
+		}
+
+		// the check is over
+		bMeasuring = false;
+		FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+		EndFrameHandle.Reset();
+
+		Report();
+	}
+}
+
+FBdozawaAllocationScope::FBdozawaAllocationScope(const TCHAR* InName)
+	: Name(InName)
+{
+	// only measure on the game thread while a check is running
+	if (BdozawaAllocationCheck::bMeasuring && IsInGameThread())
+	{
+		bMeasuring = true;
+		StartAllocations = BdozawaAllocationCheck::GetAllocationCount();
+	}
+}
+
+FBdozawaAllocationScope::~FBdozawaAllocationScope()
+{
+	if (!bMeasuring)
+	{
+		return;
+	}
+
+	// read the count before touching the results map, which may allocate on the first call
+	const uint64 Allocations = BdozawaAllocationCheck::GetAllocationCount() - StartAllocations;
+
+	FBdozawaAllocationResult& Result = BdozawaAllocationCheck::Results.FindOrAdd(Name);
+	++Result.Calls;
+	Result.Allocations += Allocations;
+
+	if (Allocations > 0)
+	{
+		++Result.AllocatingCalls;
+	}
+}
+
+void FBdozawaAllocationScope::StartCheck(int32 NumFrames)
+{
+	using namespace BdozawaAllocationCheck;
+
+	// count game thread allocations from now on. Swapping the pointer is safe while other threads allocate,
+	// since both allocators hand out and free memory from the same heap
+	if (!CountingMalloc)
+	{
+		CountingMalloc = new FCountingMalloc(GMalloc);
+		GMalloc = CountingMalloc;
+	}
+
+	// restart any check already in progress. Reserve up front so recording results doesn't allocate inside enclosing scopes
+	Results.Empty();
+	Results.Reserve(64);
+
+	WarmupFrames = 2;
+	FramesRemaining = FMath::Max(NumFrames, 1);
+	bMeasuring = false;
+
+	if (!EndFrameHandle.IsValid())
+	{
+		EndFrameHandle = FCoreDelegates::OnEndFrame.AddStatic(&BdozawaAllocationCheck::OnEndFrame);
+	}
+
+	UE_LOG(LogBdozawa, Display, TEXT("Allocation check started for %d frames."), FramesRemaining);
+}
+
+bool FBdozawaAllocationScope::IsCheckRunning()
+{
+	return BdozawaAllocationCheck::EndFrameHandle.IsValid();
+}
+
+const TMap<FString, FBdozawaAllocationResult>& FBdozawaAllocationScope::GetLastResults()
+{
+	return BdozawaAllocationCheck::LastResults;
+}
+
+static FAutoConsoleCommandWithArgs BdozawaAllocCheckCommand(
+	TEXT("Bdozawa.AllocCheck"),
+	TEXT("Counts heap allocations made by gameplay hot paths over a number of frames and reports any that allocated. Optional argument: number of frames (default 300). Only game thread allocations are counted."),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		FBdozawaAllocationScope::StartCheck(Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 300);
+	}));
+
+#endif
@@ -0,0 +1,65 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if !UE_BUILD_SHIPPING
+
+/**
+ *  Heap allocations recorded for a hot path during an allocation check
+ */
+struct FBdozawaAllocationResult
+{
+	/** Number of times the scope was entered */
+	int32 Calls = 0;
+
+	/** Number of calls that made at least one allocation */
+	int32 AllocatingCalls = 0;
+
+	/** Total game thread allocations made inside the scope */
+	uint64 Allocations = 0;
+};
+
+/**
+ *  Counts heap allocations made while a gameplay hot path is running.
+ *  Scopes only measure while an allocation check is in progress. Start one with Bdozawa.AllocCheck or the Bdozawa.AllocCheck automation test.
+ *  Only game thread allocations are counted, through a counting allocator installed the first time a check starts.
+ */
+class FBdozawaAllocationScope
+{
+	/** Name of the hot path, used to group results */
+	const TCHAR* Name;
+
+	/** Allocation count when the scope was opened */
+	uint64 StartAllocations = 0;
+
+	/** True if a check was running when the scope was opened */
+	bool bMeasuring = false;
+
+public:
+
+	/** Opens the scope */
+	explicit FBdozawaAllocationScope(const TCHAR* InName);
+
+	/** Closes the scope and records its allocations */
+	~FBdozawaAllocationScope();
+
+	/** Starts an allocation check that runs for the given number of frames and logs its results */
+	static void StartCheck(int32 NumFrames);
+
+	/** Returns true while an allocation check is in progress */
+	static bool IsCheckRunning();
+
+	/** Returns the results of the last completed check, keyed by hot path name */
+	static const TMap<FString, FBdozawaAllocationResult>& GetLastResults();
+};
+
+/** Marks a scope as a hot path that is expected to make zero heap allocations in steady state */
+#define BDOZAWA_ZERO_ALLOC_SCOPE(Name) FBdozawaAllocationScope PREPROCESSOR_JOIN(BdozawaAllocationScope_, __LINE__)(TEXT(Name))
+
+#else
+
+#define BDOZAWA_ZERO_ALLOC_SCOPE(Name)
+
+#endif
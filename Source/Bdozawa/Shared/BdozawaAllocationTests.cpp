@@ -0,0 +1,115 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "BdozawaAllocationScope.h"
+#include "Engine/Engine.h"
+#include "Misc/AutomationTest.h"
+#include "Tests/AutomationCommon.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && !UE_BUILD_SHIPPING
+
+namespace BdozawaAllocationTests
+{
+	/** Test flags shared by all allocation tests */
+	constexpr EAutomationTestFlags Flags = EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter;
+
+	/** Map opened when the test isn't run from inside a game session. Its enemies exercise the combat hot paths */
+	const TCHAR* const CombatMap = TEXT("/Game/Variant_Combat/Lvl_Combat");
+
+	/** Frames to measure the hot paths for */
+	constexpr int32 NumFrames = 600;
+
+	/** Returns true if a game or PIE world is already running */
+	bool IsGameWorldRunning()
+	{
+		for (const FWorldContext& Context : GEngine->GetWorldContexts())
+		{
+			if ((Context.WorldType == EWorldType::Game || Context.WorldType == EWorldType::PIE) && Context.World())
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+}
+
+/**
+ *  Runs an allocation check to completion, then fails the test for every hot path that allocated
+ */
+class FBdozawaAllocationCheckCommand : public IAutomationLatentCommand
+{
+	/** Test to report results to */
+	FAutomationTestBase* Test;
+
+	/** Frames to measure */
+	int32 NumFrames;
+
+	/** True once the check has been started */
+	bool bStarted = false;
+
+public:
+
+	FBdozawaAllocationCheckCommand(FAutomationTestBase* InTest, int32 InNumFrames)
+		: Test(InTest)
+		, NumFrames(InNumFrames)
+	{
+	}
+
+	virtual bool Update() override
+	{
+		// start the check on the first update, once the world is ticking
+		if (!bStarted)
+		{
+			FBdozawaAllocationScope::StartCheck(NumFrames);
+			bStarted = true;
+
+			return false;
+		}
+
+		// wait for the check to finish
+		if (FBdozawaAllocationScope::IsCheckRunning())
+		{
+			return false;
+		}
+
+		const TMap<FString, FBdozawaAllocationResult>& Results = FBdozawaAllocationScope::GetLastResults();
+
+		if (Results.IsEmpty())
+		{
+			Test->AddWarning(TEXT("No zero allocation hot paths ran during the check."));
+		}
+
+		for (const TPair<FString, FBdozawaAllocationResult>& Pair : Results)
+		{
+			if (Pair.Value.Allocations > 0)
+			{
+				Test->AddError(FString::Printf(TEXT("%s made %llu game thread allocations in %d of %d calls."), *Pair.Key, Pair.Value.Allocations, Pair.Value.AllocatingCalls, Pair.Value.Calls));
+
+			} else {
+
+				Test->AddInfo(FString::Printf(TEXT("%s made no allocations in %d calls."), *Pair.Key, Pair.Value.Calls));
+			}
+		}
+
+		return true;
+	}
+};
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBdozawaAllocationCheckTest, "Bdozawa.AllocCheck", BdozawaAllocationTests::Flags)
+
+bool FBdozawaAllocationCheckTest::RunTest(const FString& Parameters)
+{
+	// measure the running session if there is one, otherwise load the combat map
+	if (!BdozawaAllocationTests::IsGameWorldRunning())
+	{
+		AutomationOpenMap(BdozawaAllocationTests::CombatMap);
+		ADD_LATENT_AUTOMATION_COMMAND(FWaitForMapToLoadCommand());
+	}
+
+	ADD_LATENT_AUTOMATION_COMMAND(FBdozawaAllocationCheckCommand(this, BdozawaAllocationTests::NumFrames));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS && !UE_BUILD_SHIPPING
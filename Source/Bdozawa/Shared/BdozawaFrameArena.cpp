@@ -0,0 +1,36 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "BdozawaFrameArena.h"
+#include "Misc/CoreDelegates.h"
+
+FBdozawaFrameArena& FBdozawaFrameArena::Get()
+{
+	check(IsInGameThread());
+
+	static FBdozawaFrameArena Arena;
+	return Arena;
+}
+
+FBdozawaFrameArena::FBdozawaFrameArena()
+{
+	// the arena may be created mid-frame, so open the first frame right away
+	BeginFrame();
+
+	FCoreDelegates::OnBeginFrame.AddRaw(this, &FBdozawaFrameArena::BeginFrame);
+	FCoreDelegates::OnEndFrame.AddRaw(this, &FBdozawaFrameArena::EndFrame);
+}
+
+void FBdozawaFrameArena::BeginFrame()
+{
+	if (!FrameMark.IsSet())
+	{
+		FrameMark.Emplace(*this);
+	}
+}
+
+void FBdozawaFrameArena::EndFrame()
+{
+	// popping the mark rewinds the arena. Its pages go back to the shared page pool for the next frame
+	FrameMark.Reset();
+}
@@ -0,0 +1,45 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/MemStack.h"
+
+/**
+ *  Linear allocator for transient gameplay buffers that only need to live until the end of the frame.
+ *  Game thread only. A mark is pushed at the start of every engine frame and popped at the end,
+ *  so allocations are a pointer bump and nothing is ever freed individually.
+ *  Use it with TArray through TFrameArenaAllocator.
+ */
+class FBdozawaFrameArena : public FMemStackBase
+{
+	/** Mark pushed at the start of the current frame */
+	TOptional<FMemMark> FrameMark;
+
+public:
+
+	/** Returns the game thread frame arena */
+	static FBdozawaFrameArena& Get();
+
+	/** Returns the number of bytes allocated from the arena this frame */
+	int64 GetFrameBytes() const { return GetByteCount(); }
+
+private:
+
+	/** Constructor. Hooks the arena to the engine frame delegates */
+	FBdozawaFrameArena();
+
+	/** Pushes the frame mark */
+	void BeginFrame();
+
+	/** Pops the frame mark, releasing everything allocated this frame */
+	void EndFrame();
+};
+
+/** TArray allocator that takes its memory from the frame arena. Arrays using it must not outlive the frame */
+template<uint32 Alignment = DEFAULT_ALIGNMENT>
+using TFrameArenaAllocator = TMemStackAllocatorBase<FBdozawaFrameArena, Alignment>;
+
+/** Array allocated from the frame arena */
+template<typename ElementType>
+using TFrameArray = TArray<ElementType, TFrameArenaAllocator<>>;
@@ -0,0 +1,327 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "BdozawaPerceptionSubsystem.h"
+#include "BdozawaPlayerSnapshotSubsystem.h"
+#include "Components/StateTreeComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "HAL/IConsoleManager.h"
+#include "StructUtils/StructView.h"
+
+UE_DEFINE_GAMEPLAY_TAG_COMMENT(TAG_Bdozawa_Perception_PlayerSeen, "Bdozawa.Perception.PlayerSeen", "Sent to an AI agent's StateTree when it gains sight of a player");
+UE_DEFINE_GAMEPLAY_TAG_COMMENT(TAG_Bdozawa_Perception_PlayerLost, "Bdozawa.Perception.PlayerLost", "Sent to an AI agent's StateTree when it loses sight of a player");
+
+DECLARE_CYCLE_STAT(TEXT("Bdozawa Perception Schedule"), STAT_BdozawaPerceptionSchedule, STATGROUP_Game);
+DECLARE_CYCLE_STAT(TEXT("Bdozawa Perception Resolve"), STAT_BdozawaPerceptionResolve, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Perception Observers"), STAT_BdozawaPerceptionObservers, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Perception Traces Issued"), STAT_BdozawaPerceptionTraces, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Perception Checks Without Trace"), STAT_BdozawaPerceptionRejected, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Perception Events Sent"), STAT_BdozawaPerceptionEvents, STATGROUP_Game);
+
+static int32 GBdozawaPerceptionTracesPerFrame = 8;
+static FAutoConsoleVariableRef CVarBdozawaPerceptionTracesPerFrame(
+	TEXT("Bdozawa.Perception.TracesPerFrame"),
+	GBdozawaPerceptionTracesPerFrame,
+	TEXT("Maximum number of async line of sight traces issued per frame. Observers past the budget wait for their next turn."),
+	ECVF_Default);
+
+static int32 GBdozawaPerceptionMaxChecksPerFrame = 64;
+static FAutoConsoleVariableRef CVarBdozawaPerceptionMaxChecksPerFrame(
+	TEXT("Bdozawa.Perception.MaxChecksPerFrame"),
+	GBdozawaPerceptionMaxChecksPerFrame,
+	TEXT("Maximum number of observers visited per frame, including the ones rejected by range or view cone without a trace."),
+	ECVF_Default);
+
+namespace BdozawaPerception
+{
+	/** Name sent as the origin of the perception StateTree events */
+	static const FName EventOrigin = TEXT("Perception");
+}
+
+int32 UBdozawaPerceptionSubsystem::RegisterObserver(APawn* Pawn, UStateTreeComponent* StateTree, const FBdozawaSightSettings& Settings)
+{
+	// ensure the pawn is valid
+	if (!IsValid(Pawn))
+	{
+		return INDEX_NONE;
+	}
+
+	FObserver NewObserver;
+	NewObserver.Pawn = Pawn;
+	NewObserver.StateTree = StateTree;
+	NewObserver.Settings = Settings;
+	NewObserver.Serial = NextSerial++;
+
+	return Observers.Add(MoveTemp(NewObserver));
+}
+
+void UBdozawaPerceptionSubsystem::UnregisterObserver(int32& Handle)
+{
+	if (Observers.IsValidIndex(Handle))
+	{
+		// any trace still in flight is dropped by its serial when it resolves
+		Observers.RemoveAt(Handle);
+	}
+
+	Handle = INDEX_NONE;
+}
+
+const FBdozawaPerceptionResult* UBdozawaPerceptionSubsystem::GetResult(int32 Handle) const
+{
+	return Observers.IsValidIndex(Handle) ? &Observers[Handle].Result : nullptr;
+}
+
+double UBdozawaPerceptionSubsystem::GetStaleness(int32 Handle) const
+{
+	const FBdozawaPerceptionResult* Result = GetResult(Handle);
+
+	if (!Result || Result->LastUpdateTime < 0.0)
+	{
+		return MAX_dbl;
+	}
+
+	return GetWorld()->GetTimeSeconds() - Result->LastUpdateTime;
+}
+
+void UBdozawaPerceptionSubsystem::ScheduleTraces()
+{
+	SCOPE_CYCLE_COUNTER(STAT_BdozawaPerceptionSchedule);
+
+	SET_DWORD_STAT(STAT_BdozawaPerceptionObservers, Observers.Num());
+
+	if (Observers.IsEmpty())
+	{
+		return;
+	}
+
+	UWorld* World = GetWorld();
+	const FBdozawaPlayerSnapshot& Snapshot = World->GetSubsystem<UBdozawaPlayerSnapshotSubsystem>()->GetSnapshot();
+
+	const int32 MaxTraces = FMath::Max(GBdozawaPerceptionTracesPerFrame, 0);
+	const int32 MaxChecks = FMath::Min(FMath::Max(GBdozawaPerceptionMaxChecksPerFrame, 1), Observers.Num());
+
+	int32 NumTraces = 0;
+	int32 NumRejected = 0;
+
+	// visit each observer at most once per frame, starting where the last frame left off
+	for (int32 Checks = 0, Visited = 0; Checks < MaxChecks && Visited < Observers.GetMaxIndex() && NumTraces < MaxTraces; ++Visited)
+	{
+		if (NextObserver >= Observers.GetMaxIndex())
+		{
+			NextObserver = 0;
+		}
+
+		const int32 ObserverHandle = NextObserver++;
+
+		// skip free slots and observers still waiting on a trace
+		if (!Observers.IsValidIndex(ObserverHandle) || Observers[ObserverHandle].bTracePending)
+		{
+			continue;
+		}
+
+		++Checks;
+
+		FObserver& Observer = Observers[ObserverHandle];
+		APawn* Pawn = Observer.Pawn.Get();
+
+		// skip observers that were destroyed without unregistering, or are parked out of play
+		if (!IsValid(Pawn) || Pawn->IsHidden())
+		{
+			continue;
+		}
+
+		// already seeing players are kept in sight up to the lose sight radius
+		const float Radius = Observer.Result.bCanSeePlayer ? FMath::Max(Observer.Settings.LoseSightRadius, Observer.Settings.SightRadius) : Observer.Settings.SightRadius;
+		const float CosHalfAngle = FMath::Cos(FMath::DegreesToRadians(Observer.Settings.PeripheralVisionAngle));
+
+		const FVector EyeLocation = Pawn->GetPawnViewLocation();
+		const FVector Forward = Pawn->GetActorForwardVector();
+
+		// find the nearest player in range and in the view cone. Read the live locations, since the snapshot was taken before actors moved this frame
+		APawn* BestPlayer = nullptr;
+		FVector BestLocation = FVector::ZeroVector;
+		double BestDistanceSquared = FMath::Square(static_cast<double>(Radius));
+
+		for (const FBdozawaPlayerSnapshotEntry& Player : Snapshot.Players)
+		{
+			if (!IsValid(Player.Pawn))
+			{
+				continue;
+			}
+
+			const FVector PlayerLocation = Player.Pawn->GetActorLocation();
+			const FVector ToPlayer = PlayerLocation - EyeLocation;
+			const double DistanceSquared = ToPlayer.SizeSquared();
+
+			if (DistanceSquared > BestDistanceSquared)
+			{
+				continue;
+			}
+
+			if (FVector::DotProduct(Forward, ToPlayer.GetSafeNormal()) < CosHalfAngle)
+			{
+				continue;
+			}
+
+			BestPlayer = Player.Pawn;
+			BestLocation = PlayerLocation;
+			BestDistanceSquared = DistanceSquared;
+		}
+
+		// no player can possibly be seen, so the result is known without a trace
+		if (!BestPlayer)
+		{
+			++NumRejected;
+			UpdateResult(Observer, false, nullptr, FVector::ZeroVector);
+			continue;
+		}
+
+		++NumTraces;
+
+		// ignore both ends of the trace, anything else that blocks visibility hides the player
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(BdozawaPerceptionTrace), false, Pawn);
+		QueryParams.AddIgnoredActor(BestPlayer);
+
+		// issue the async trace. Results will be available on the next frame
+		FPendingSightTrace& PendingTrace = PendingTraces.AddDefaulted_GetRef();
+		PendingTrace.Handle = World->AsyncLineTraceByChannel(EAsyncTraceType::Test, EyeLocation, BestLocation, ECC_Visibility, QueryParams);
+		PendingTrace.ObserverHandle = ObserverHandle;
+		PendingTrace.Serial = Observer.Serial;
+		PendingTrace.Player = BestPlayer;
+		PendingTrace.PlayerLocation = BestLocation;
+
+		Observer.bTracePending = true;
+	}
+
+	SET_DWORD_STAT(STAT_BdozawaPerceptionTraces, NumTraces);
+	SET_DWORD_STAT(STAT_BdozawaPerceptionRejected, NumRejected);
+}
+
+void UBdozawaPerceptionSubsystem::ResolvePendingTraces(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds)
+{
+	// the delegate is global, so ignore other worlds
+	if (InWorld != GetWorld() || PendingTraces.IsEmpty())
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_BdozawaPerceptionResolve);
+
+	FTraceDatum TraceData;
+
+	for (int32 i = 0; i < PendingTraces.Num(); ++i)
+	{
+		FPendingSightTrace& CurrentTrace = PendingTraces[i];
+
+		// ignore results for observers that unregistered while the trace was in flight
+		FObserver* Observer = Observers.IsValidIndex(CurrentTrace.ObserverHandle) && Observers[CurrentTrace.ObserverHandle].Serial == CurrentTrace.Serial
+			? &Observers[CurrentTrace.ObserverHandle]
+			: nullptr;
+
+		// have the results for this trace come in?
+		if (InWorld->QueryTraceData(CurrentTrace.Handle, TraceData))
+		{
+			if (Observer)
+			{
+				// test traces only report a hit when something blocked the line of sight
+				const bool bBlocked = TraceData.OutHits.ContainsByPredicate([](const FHitResult& Hit) { return Hit.bBlockingHit; });
+
+				UpdateResult(*Observer, !bBlocked && CurrentTrace.Player.IsValid(), CurrentTrace.Player.Get(), CurrentTrace.PlayerLocation);
+			}
+		}
+		// is the trace still in flight?
+		else if (InWorld->IsTraceHandleValid(CurrentTrace.Handle, false))
+		{
+			continue;
+		}
+
+		// the trace is either resolved or expired, so let the observer schedule another one
+		if (Observer)
+		{
+			Observer->bTracePending = false;
+		}
+
+		PendingTraces.RemoveAtSwap(i, 1, EAllowShrinking::No);
+		--i;
+	}
+}
+
+void UBdozawaPerceptionSubsystem::UpdateResult(FObserver& Observer, bool bCanSee, APawn* Player, const FVector& PlayerLocation)
+{
+	FBdozawaPerceptionResult& Result = Observer.Result;
+
+	const double WorldTime = GetWorld()->GetTimeSeconds();
+	const bool bChanged = bCanSee != Result.bCanSeePlayer || (bCanSee && Player != Result.Player.Get());
+
+	Result.bCanSeePlayer = bCanSee;
+	Result.LastUpdateTime = WorldTime;
+
+	// keep the last known location around after sight is lost, so the agent can search for the player
+	if (bCanSee)
+	{
+		Result.Player = Player;
+		Result.LastKnownLocation = PlayerLocation;
+		Result.LastSeenTime = WorldTime;
+	}
+
+	if (!bChanged)
+	{
+		return;
+	}
+
+	UStateTreeComponent* StateTree = Observer.StateTree.Get();
+
+	if (!StateTree)
+	{
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_BdozawaPerceptionEvents);
+
+	// push the change to the StateTree, so transitions react to it instead of polling the result every tick
+	FBdozawaPerceptionEvent Payload;
+	Payload.Player = Result.Player.Get();
+	Payload.Location = Result.LastKnownLocation;
+
+	StateTree->SendStateTreeEvent(bCanSee ? TAG_Bdozawa_Perception_PlayerSeen : TAG_Bdozawa_Perception_PlayerLost, FConstStructView::Make(Payload), BdozawaPerception::EventOrigin);
+}
+
+void UBdozawaPerceptionSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// the player snapshot is read when scheduling traces
+	Collection.InitializeDependency<UBdozawaPlayerSnapshotSubsystem>();
+
+	// resolve last frame's traces at a fixed point, before any actors tick
+	PreActorTickHandle = FWorldDelegates::OnWorldPreActorTick.AddUObject(this, &UBdozawaPerceptionSubsystem::ResolvePendingTraces);
+}
+
+void UBdozawaPerceptionSubsystem::Deinitialize()
+{
+	// unsubscribe from the world delegate
+	FWorldDelegates::OnWorldPreActorTick.Remove(PreActorTickHandle);
+
+	// drop any traces still in flight
+	Observers.Empty();
+	PendingTraces.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UBdozawaPerceptionSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UBdozawaPerceptionSubsystem::Tick(float DeltaTime)
+{
+	// tickable world subsystems tick after all actors and components, so observers and players are at their final locations for the frame
+	ScheduleTraces();
+}
+
+TStatId UBdozawaPerceptionSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UBdozawaPerceptionSubsystem, STATGROUP_Tickables);
+}
@@ -0,0 +1,192 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineTypes.h"
+#include "WorldCollision.h"
+#include "NativeGameplayTags.h"
+#include "BdozawaPerceptionSubsystem.generated.h"
+
+class APawn;
+class UStateTreeComponent;
+
+/** Sent to an observer's StateTree when it gains sight of a player */
+UE_DECLARE_GAMEPLAY_TAG_EXTERN(TAG_Bdozawa_Perception_PlayerSeen);
+
+/** Sent to an observer's StateTree when it loses sight of a player */
+UE_DECLARE_GAMEPLAY_TAG_EXTERN(TAG_Bdozawa_Perception_PlayerLost);
+
+/**
+ *  How far and how wide an AI agent can see
+ */
+USTRUCT(BlueprintType)
+struct FBdozawaSightSettings
+{
+	GENERATED_BODY()
+
+	/** If false, the agent doesn't register for sight checks */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Sight")
+	bool bEnabled = true;
+
+	/** Distance at which the agent can first see a player */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Sight", meta = (ClampMin = 0, ClampMax = 20000, Units="cm"))
+	float SightRadius = 2500.0f;
+
+	/** Distance at which the agent loses sight of a player it's already seeing */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Sight", meta = (ClampMin = 0, ClampMax = 20000, Units="cm"))
+	float LoseSightRadius = 3000.0f;
+
+	/** Half angle of the agent's view cone, around its facing direction */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Sight", meta = (ClampMin = 0, ClampMax = 180, Units="Degrees"))
+	float PeripheralVisionAngle = 75.0f;
+};
+
+/**
+ *  Payload of the perception StateTree events
+ */
+USTRUCT(BlueprintType)
+struct FBdozawaPerceptionEvent
+{
+	GENERATED_BODY()
+
+	/** Player pawn that was seen or lost */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Perception")
+	TObjectPtr<APawn> Player;
+
+	/** Last location the player was seen at */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Perception")
+	FVector Location = FVector::ZeroVector;
+};
+
+/**
+ *  Cached result of an observer's last sight check
+ */
+struct FBdozawaPerceptionResult
+{
+	/** True if a player was visible on the last check */
+	bool bCanSeePlayer = false;
+
+	/** Player seen on the last check, or the last player that was seen */
+	TWeakObjectPtr<APawn> Player;
+
+	/** Location the player was last seen at */
+	FVector LastKnownLocation = FVector::ZeroVector;
+
+	/** World time the player was last seen at. Negative if no player has been seen yet */
+	double LastSeenTime = -1.0;
+
+	/** World time of the last completed sight check. Negative if no check has completed yet */
+	double LastUpdateTime = -1.0;
+};
+
+/**
+ *  Gives AI agents line of sight to the players without tracing every agent every frame.
+ *  Observers are visited round-robin. Players out of range or out of the view cone are rejected without a trace,
+ *  and the rest are checked with async line traces, under a per-frame trace budget.
+ *  Traces are issued at the end of the frame and resolved before actors tick on the next one.
+ *  Results are cached with the time they were taken, and changes are sent to the observer's StateTree as events.
+ */
+UCLASS()
+class UBdozawaPerceptionSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** A registered observer */
+	struct FObserver
+	{
+		/** Pawn doing the looking */
+		TWeakObjectPtr<APawn> Pawn;
+
+		/** StateTree that receives the perception events */
+		TWeakObjectPtr<UStateTreeComponent> StateTree;
+
+		/** Sight settings */
+		FBdozawaSightSettings Settings;
+
+		/** Cached sight result */
+		FBdozawaPerceptionResult Result;
+
+		/** Incremented every time the slot is reused, so traces in flight for a previous observer are dropped */
+		uint32 Serial = 0;
+
+		/** True while a trace is in flight */
+		bool bTracePending = false;
+	};
+
+	/** An async line trace that has been issued but not resolved yet */
+	struct FPendingSightTrace
+	{
+		/** Async trace handle returned by the world */
+		FTraceHandle Handle;
+
+		/** Observer the trace was issued for */
+		int32 ObserverHandle = INDEX_NONE;
+
+		/** Serial of the observer when the trace was issued */
+		uint32 Serial = 0;
+
+		/** Player being checked */
+		TWeakObjectPtr<APawn> Player;
+
+		/** Player location the trace was aimed at */
+		FVector PlayerLocation = FVector::ZeroVector;
+	};
+
+	/** Registered observers. Handles are indices into this array */
+	TSparseArray<FObserver> Observers;
+
+	/** Sight traces waiting to be resolved */
+	TArray<FPendingSightTrace> PendingTraces;
+
+	/** Next observer to visit */
+	int32 NextObserver = 0;
+
+	/** Serial given to the next registered observer */
+	uint32 NextSerial = 1;
+
+	/** Handle to the world pre actor tick delegate */
+	FDelegateHandle PreActorTickHandle;
+
+public:
+
+	/** Starts checking an observer's line of sight to the players. Returns the handle used to query its results */
+	int32 RegisterObserver(APawn* Pawn, UStateTreeComponent* StateTree, const FBdozawaSightSettings& Settings);
+
+	/** Stops checking an observer and resets the handle */
+	void UnregisterObserver(int32& Handle);
+
+	/** Returns an observer's cached sight result, or null if the handle is invalid */
+	const FBdozawaPerceptionResult* GetResult(int32 Handle) const;
+
+	/** Returns the time in seconds since an observer's last completed sight check, or MAX_dbl if it hasn't completed one */
+	double GetStaleness(int32 Handle) const;
+
+protected:
+
+	/** Visits observers round-robin, rejecting players without traces where possible and issuing traces up to the budget */
+	void ScheduleTraces();
+
+	/** Resolves the traces issued on the previous frame. Called at the start of the world tick */
+	void ResolvePendingTraces(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds);
+
+	/** Stores a sight result and sends a StateTree event if it changed */
+	void UpdateResult(FObserver& Observer, bool bCanSee, APawn* Player, const FVector& PlayerLocation);
+
+public:
+
+	// ~begin USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	// ~end USubsystem interface
+
+	// ~begin UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	// ~end UWorldSubsystem interface
+
+	// ~begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	// ~end FTickableGameObject interface
+};
@@ -0,0 +1,78 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "BdozawaPlayerSnapshotSubsystem.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerController.h"
+
+const FBdozawaPlayerSnapshot& UBdozawaPlayerSnapshotSubsystem::GetSnapshot()
+{
+	// the world hasn't ticked yet this frame
+	if (Snapshot.FrameNumber != GFrameCounter)
+	{
+		UpdateSnapshot();
+	}
+
+	return Snapshot;
+}
+
+void UBdozawaPlayerSnapshotSubsystem::UpdateSnapshot()
+{
+	Snapshot.FrameNumber = GFrameCounter;
+
+	// keep the allocation around for the next frame
+	Snapshot.Players.Reset();
+
+	for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		const APlayerController* PlayerController = Iterator->Get();
+		APawn* Pawn = PlayerController ? PlayerController->GetPawn() : nullptr;
+
+		if (!Pawn)
+		{
+			continue;
+		}
+
+		FBdozawaPlayerSnapshotEntry& Entry = Snapshot.Players.AddDefaulted_GetRef();
+		Entry.Pawn = Pawn;
+		Entry.Character = Cast<ACharacter>(Pawn);
+		Entry.Location = Pawn->GetActorLocation();
+		Entry.Velocity = Pawn->GetVelocity();
+
+		const UCharacterMovementComponent* Movement = Entry.Character ? Entry.Character->GetCharacterMovement() : nullptr;
+		Entry.bGrounded = Movement && Movement->IsMovingOnGround();
+	}
+}
+
+void UBdozawaPlayerSnapshotSubsystem::OnWorldPreActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds)
+{
+	// the delegate is global, so ignore other worlds
+	if (InWorld == GetWorld())
+	{
+		UpdateSnapshot();
+	}
+}
+
+void UBdozawaPlayerSnapshotSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// take the snapshot at a fixed point, before any actors tick
+	PreActorTickHandle = FWorldDelegates::OnWorldPreActorTick.AddUObject(this, &UBdozawaPlayerSnapshotSubsystem::OnWorldPreActorTick);
+}
+
+void UBdozawaPlayerSnapshotSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPreActorTick.Remove(PreActorTickHandle);
+
+	Snapshot.Players.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UBdozawaPlayerSnapshotSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
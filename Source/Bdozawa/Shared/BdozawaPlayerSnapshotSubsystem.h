@@ -0,0 +1,99 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "BdozawaPlayerSnapshotSubsystem.generated.h"
+
+class APawn;
+class ACharacter;
+
+/**
+ *  State of one player pawn at the start of the frame
+ */
+USTRUCT(BlueprintType)
+struct FBdozawaPlayerSnapshotEntry
+{
+	GENERATED_BODY()
+
+	/** Pawn possessed by the player */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Player Snapshot")
+	TObjectPtr<APawn> Pawn;
+
+	/** Pawn cast to a character. Null if the pawn isn't a character */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Player Snapshot")
+	TObjectPtr<ACharacter> Character;
+
+	/** Pawn location */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Player Snapshot")
+	FVector Location = FVector::ZeroVector;
+
+	/** Pawn velocity */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Player Snapshot")
+	FVector Velocity = FVector::ZeroVector;
+
+	/** True if the pawn is a character walking on the ground */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Player Snapshot")
+	bool bGrounded = false;
+};
+
+/**
+ *  State of all player pawns at the start of the frame, in player controller order
+ */
+USTRUCT(BlueprintType)
+struct FBdozawaPlayerSnapshot
+{
+	GENERATED_BODY()
+
+	/** One entry per player controller with a pawn */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Player Snapshot")
+	TArray<FBdozawaPlayerSnapshotEntry> Players;
+
+	/** Frame the snapshot was taken on */
+	uint64 FrameNumber = 0;
+
+	/** Returns the first player's entry, or null if no player has a pawn */
+	const FBdozawaPlayerSnapshotEntry* GetFirstPlayer() const { return Players.IsEmpty() ? nullptr : &Players[0]; }
+};
+
+/**
+ *  Publishes one immutable snapshot of the player pawns per frame, taken before any actors tick.
+ *  AI tasks, evaluators and EQS contexts read player pawns, locations, velocities and grounded state from it
+ *  instead of looking up and casting the player pawn per agent.
+ */
+UCLASS()
+class UBdozawaPlayerSnapshotSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Current frame's snapshot */
+	FBdozawaPlayerSnapshot Snapshot;
+
+	/** Pre actor tick delegate handle */
+	FDelegateHandle PreActorTickHandle;
+
+public:
+
+	/** Returns this frame's snapshot. Taken on first use if it's read before the world ticks */
+	const FBdozawaPlayerSnapshot& GetSnapshot();
+
+protected:
+
+	/** Rebuilds the snapshot from the world's player controllers */
+	void UpdateSnapshot();
+
+	/** Takes the snapshot before any actors tick */
+	void OnWorldPreActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds);
+
+public:
+
+	// ~begin USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	// ~end USubsystem interface
+
+	// ~begin UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	// ~end UWorldSubsystem interface
+};
@@ -0,0 +1,201 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "BdozawaProximity.h"
+#include "Math/VectorRegister.h"
+
+void FBdozawaProximity::Reset()
+{
+	AgentX.Reset();
+	AgentY.Reset();
+	AgentZ.Reset();
+	DistanceSquared.Reset();
+	Bands.Reset();
+
+	PlayerX.Reset();
+	PlayerY.Reset();
+	PlayerZ.Reset();
+
+	Origin = FVector::ZeroVector;
+	NumAgents = 0;
+
+	FMemory::Memzero(BandCounts);
+}
+
+void FBdozawaProximity::SetPlayers(TConstArrayView<FVector> PlayerLocations)
+{
+	// keep the coordinates close to zero around the first player
+	Origin = PlayerLocations.IsEmpty() ? FVector::ZeroVector : PlayerLocations[0];
+
+	PlayerX.Reset();
+	PlayerY.Reset();
+	PlayerZ.Reset();
+
+	for (const FVector& Location : PlayerLocations)
+	{
+		const FVector3f Relative(Location - Origin);
+
+		PlayerX.Add(Relative.X);
+		PlayerY.Add(Relative.Y);
+		PlayerZ.Add(Relative.Z);
+	}
+}
+
+void FBdozawaProximity::SetBandRadii(float NearRadius, float MidRadius, float FarRadius)
+{
+	BandRadiiSquared[0] = FMath::Square(NearRadius);
+	BandRadiiSquared[1] = FMath::Square(MidRadius);
+	BandRadiiSquared[2] = FMath::Square(FarRadius);
+}
+
+int32 FBdozawaProximity::AddAgent(const FVector& Location)
+{
+	const int32 Index = NumAgents++;
+
+	// grow the padded arrays four lanes at a time
+	if (Index % 4 == 0)
+	{
+		AgentX.AddZeroed(4);
+		AgentY.AddZeroed(4);
+		AgentZ.AddZeroed(4);
+		DistanceSquared.AddZeroed(4);
+	}
+
+	Bands.Add(0);
+
+	SetAgentLocation(Index, Location);
+
+	// the agent gets valid results before the next compute
+	ComputeAgent(Index);
+	++BandCounts[Bands[Index]];
+
+	return Index;
+}
+
+void FBdozawaProximity::RemoveAgentAtSwap(int32 Index)
+{
+	check(Index >= 0 && Index < NumAgents);
+
+	--BandCounts[Bands[Index]];
+
+	const int32 LastIndex = NumAgents - 1;
+
+	// move the last agent into the removed agent's lane
+	AgentX[Index] = AgentX[LastIndex];
+	AgentY[Index] = AgentY[LastIndex];
+	AgentZ[Index] = AgentZ[LastIndex];
+	DistanceSquared[Index] = DistanceSquared[LastIndex];
+	Bands[Index] = Bands[LastIndex];
+
+	// the last lane becomes padding
+	AgentX[LastIndex] = 0.0f;
+	AgentY[LastIndex] = 0.0f;
+	AgentZ[LastIndex] = 0.0f;
+	Bands.Pop(EAllowShrinking::No);
+
+	NumAgents = LastIndex;
+
+	// drop a whole block of padding once it's empty
+	if (NumAgents % 4 == 0)
+	{
+		AgentX.SetNum(NumAgents, EAllowShrinking::No);
+		AgentY.SetNum(NumAgents, EAllowShrinking::No);
+		AgentZ.SetNum(NumAgents, EAllowShrinking::No);
+		DistanceSquared.SetNum(NumAgents, EAllowShrinking::No);
+	}
+}
+
+void FBdozawaProximity::SetAgentLocation(int32 Index, const FVector& Location)
+{
+	const FVector3f Relative(Location - Origin);
+
+	AgentX[Index] = Relative.X;
+	AgentY[Index] = Relative.Y;
+	AgentZ[Index] = Relative.Z;
+}
+
+void FBdozawaProximity::ComputeSIMD()
+{
+	FMemory::Memzero(BandCounts);
+
+	const int32 NumPlayers = PlayerX.Num();
+
+	const VectorRegister4Float NearRadiusSquared = VectorSetFloat1(BandRadiiSquared[0]);
+	const VectorRegister4Float MidRadiusSquared = VectorSetFloat1(BandRadiiSquared[1]);
+	const VectorRegister4Float FarRadiusSquared = VectorSetFloat1(BandRadiiSquared[2]);
+	const VectorRegister4Float One = VectorOneFloat();
+	const VectorRegister4Float NoPlayer = VectorSetFloat1(MAX_flt);
+
+	alignas(16) float BandLanes[4];
+
+	for (int32 i = 0; i < NumAgents; i += 4)
+	{
+		const VectorRegister4Float X = VectorLoadAligned(&AgentX[i]);
+		const VectorRegister4Float Y = VectorLoadAligned(&AgentY[i]);
+		const VectorRegister4Float Z = VectorLoadAligned(&AgentZ[i]);
+
+		// find the nearest player for all four agents
+		VectorRegister4Float Nearest = NoPlayer;
+
+		for (int32 Player = 0; Player < NumPlayers; ++Player)
+		{
+			const VectorRegister4Float DeltaX = VectorSubtract(X, VectorSetFloat1(PlayerX[Player]));
+			const VectorRegister4Float DeltaY = VectorSubtract(Y, VectorSetFloat1(PlayerY[Player]));
+			const VectorRegister4Float DeltaZ = VectorSubtract(Z, VectorSetFloat1(PlayerZ[Player]));
+
+			const VectorRegister4Float Distance = VectorMultiplyAdd(DeltaX, DeltaX, VectorMultiplyAdd(DeltaY, DeltaY, VectorMultiply(DeltaZ, DeltaZ)));
+
+			Nearest = VectorMin(Nearest, Distance);
+		}
+
+		VectorStoreAligned(Nearest, &DistanceSquared[i]);
+
+		// the band is the number of radii the agent is past
+		VectorRegister4Float Band = VectorBitwiseAnd(VectorCompareGE(Nearest, NearRadiusSquared), One);
+		Band = VectorAdd(Band, VectorBitwiseAnd(VectorCompareGE(Nearest, MidRadiusSquared), One));
+		Band = VectorAdd(Band, VectorBitwiseAnd(VectorCompareGE(Nearest, FarRadiusSquared), One));
+
+		VectorStoreAligned(Band, BandLanes);
+
+		// write out the bands, skipping the padding lanes
+		const int32 NumLanes = FMath::Min(4, NumAgents - i);
+
+		for (int32 Lane = 0; Lane < NumLanes; ++Lane)
+		{
+			const uint8 AgentBand = static_cast<uint8>(BandLanes[Lane]);
+
+			Bands[i + Lane] = AgentBand;
+			++BandCounts[AgentBand];
+		}
+	}
+}
+
+void FBdozawaProximity::ComputeScalar()
+{
+	FMemory::Memzero(BandCounts);
+
+	for (int32 i = 0; i < NumAgents; ++i)
+	{
+		ComputeAgent(i);
+		++BandCounts[Bands[i]];
+	}
+}
+
+void FBdozawaProximity::ComputeAgent(int32 Index)
+{
+	float Nearest = MAX_flt;
+
+	for (int32 Player = 0; Player < PlayerX.Num(); ++Player)
+	{
+		const float DeltaX = AgentX[Index] - PlayerX[Player];
+		const float DeltaY = AgentY[Index] - PlayerY[Player];
+		const float DeltaZ = AgentZ[Index] - PlayerZ[Player];
+
+		Nearest = FMath::Min(Nearest, (DeltaX * DeltaX) + (DeltaY * DeltaY) + (DeltaZ * DeltaZ));
+	}
+
+	DistanceSquared[Index] = Nearest;
+
+	// the band is the number of radii the agent is past
+	Bands[Index] = (Nearest >= BandRadiiSquared[0] ? 1 : 0) + (Nearest >= BandRadiiSquared[1] ? 1 : 0) + (Nearest >= BandRadiiSquared[2] ? 1 : 0);
+}
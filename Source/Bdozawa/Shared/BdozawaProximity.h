@@ -0,0 +1,87 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ *  Struct of arrays holding agent locations and their distance to the nearest player.
+ *  Agent coordinates are stored as floats relative to the first player, so precision holds up in large worlds.
+ *  Arrays are padded to a multiple of four, so the vectorized kernel processes four agents per iteration with no scalar tail.
+ */
+class FBdozawaProximity
+{
+	/** Agent coordinates relative to the origin. Padded to a multiple of four */
+	TArray<float, TAlignedHeapAllocator<16>> AgentX;
+	TArray<float, TAlignedHeapAllocator<16>> AgentY;
+	TArray<float, TAlignedHeapAllocator<16>> AgentZ;
+
+	/** Squared distance from each agent to the nearest player. Padded to a multiple of four */
+	TArray<float, TAlignedHeapAllocator<16>> DistanceSquared;
+
+	/** Range band of each agent */
+	TArray<uint8> Bands;
+
+	/** Player coordinates relative to the origin */
+	TArray<float> PlayerX;
+	TArray<float> PlayerY;
+	TArray<float> PlayerZ;
+
+	/** World location the coordinates are relative to */
+	FVector Origin = FVector::ZeroVector;
+
+	/** Squared radius of the near, mid and far bands */
+	float BandRadiiSquared[3] = { 0.0f, 0.0f, 0.0f };
+
+	/** Number of agents in each band */
+	int32 BandCounts[4] = { 0, 0, 0, 0 };
+
+	/** Number of agents, excluding padding */
+	int32 NumAgents = 0;
+
+public:
+
+	/** Number of range bands. Agents past the far radius are in the last band */
+	static constexpr int32 NumBands = 4;
+
+	/** Removes all agents and players, keeping the allocations */
+	void Reset();
+
+	/** Sets the player locations. Agent locations set after this are relative to the first player */
+	void SetPlayers(TConstArrayView<FVector> PlayerLocations);
+
+	/** Sets the radii of the near, mid and far bands */
+	void SetBandRadii(float NearRadius, float MidRadius, float FarRadius);
+
+	/** Adds an agent and computes its distance right away. Returns its index */
+	int32 AddAgent(const FVector& Location);
+
+	/** Removes an agent by moving the last agent into its place */
+	void RemoveAgentAtSwap(int32 Index);
+
+	/** Updates an agent's location. Distances aren't updated until the next compute */
+	void SetAgentLocation(int32 Index, const FVector& Location);
+
+	/** Computes every agent's squared distance to the nearest player and buckets it into a range band, four agents at a time */
+	void ComputeSIMD();
+
+	/** Same as ComputeSIMD, one agent at a time */
+	void ComputeScalar();
+
+	/** Returns the number of agents */
+	int32 Num() const { return NumAgents; }
+
+	/** Returns an agent's squared distance to the nearest player, or MAX_flt if there are no players */
+	float GetDistanceSquared(int32 Index) const { return DistanceSquared[Index]; }
+
+	/** Returns an agent's range band */
+	uint8 GetBand(int32 Index) const { return Bands[Index]; }
+
+	/** Returns the number of agents in a range band */
+	int32 GetBandCount(int32 Band) const { return BandCounts[Band]; }
+
+protected:
+
+	/** Computes the distance and band for a single agent */
+	void ComputeAgent(int32 Index);
+};
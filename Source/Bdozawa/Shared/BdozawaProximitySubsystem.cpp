@@ -0,0 +1,302 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "BdozawaProximitySubsystem.h"
+#include "BdozawaPlayerSnapshotSubsystem.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+#include "Bdozawa.h"
+
+DECLARE_CYCLE_STAT(TEXT("Bdozawa Proximity Update"), STAT_BdozawaProximityUpdate, STATGROUP_Game);
+
+static int32 GBdozawaProximitySIMD = 1;
+static FAutoConsoleVariableRef CVarBdozawaProximitySIMD(
+	TEXT("Bdozawa.Proximity.SIMD"),
+	GBdozawaProximitySIMD,
+	TEXT("If 0, agent distances to the players are computed one agent at a time instead of four at a time."),
+	ECVF_Default);
+
+static float GBdozawaProximityNearRadius = 500.0f;
+static FAutoConsoleVariableRef CVarBdozawaProximityNearRadius(
+	TEXT("Bdozawa.Proximity.NearRadius"),
+	GBdozawaProximityNearRadius,
+	TEXT("Agents closer than this distance in cm to a player are in the near band."),
+	ECVF_Default);
+
+static float GBdozawaProximityMidRadius = 1500.0f;
+static FAutoConsoleVariableRef CVarBdozawaProximityMidRadius(
+	TEXT("Bdozawa.Proximity.MidRadius"),
+	GBdozawaProximityMidRadius,
+	TEXT("Agents closer than this distance in cm to a player are in the mid band."),
+	ECVF_Default);
+
+static float GBdozawaProximityFarRadius = 4000.0f;
+static FAutoConsoleVariableRef CVarBdozawaProximityFarRadius(
+	TEXT("Bdozawa.Proximity.FarRadius"),
+	GBdozawaProximityFarRadius,
+	TEXT("Agents closer than this distance in cm to a player are in the far band. Agents further away are outside all bands."),
+	ECVF_Default);
+
+void UBdozawaProximitySubsystem::EnsureUpdated()
+{
+	// the distances haven't been refreshed yet this frame
+	if (LastUpdateFrame != GFrameCounter)
+	{
+		UpdateProximity();
+	}
+}
+
+int32 UBdozawaProximitySubsystem::RegisterAgent(AActor* Agent)
+{
+	// ensure the agent is valid
+	if (!IsValid(Agent))
+	{
+		return INDEX_NONE;
+	}
+
+	// reuse a free handle if we have one
+	int32 Handle = INDEX_NONE;
+
+	if (FreeHandles.Num() > 0)
+	{
+		Handle = FreeHandles.Pop(EAllowShrinking::No);
+
+	} else {
+
+		Handle = HandleIndices.Add(INDEX_NONE);
+	}
+
+	// add the agent to the end of the arrays
+	HandleIndices[Handle] = Proximity.AddAgent(Agent->GetActorLocation());
+	Agents.Add(Agent);
+	AgentHandles.Add(Handle);
+	ActorHandles.Add(Agent, Handle);
+
+	return Handle;
+}
+
+void UBdozawaProximitySubsystem::UnregisterAgent(int32& Handle)
+{
+	// ignore invalid handles
+	if (!HandleIndices.IsValidIndex(Handle) || HandleIndices[Handle] == INDEX_NONE)
+	{
+		Handle = INDEX_NONE;
+		return;
+	}
+
+	const int32 Index = HandleIndices[Handle];
+	const int32 LastIndex = Agents.Num() - 1;
+
+	ActorHandles.Remove(Agents[Index]);
+
+	// the last agent moves into the removed agent's place
+	HandleIndices[AgentHandles[LastIndex]] = Index;
+
+	Proximity.RemoveAgentAtSwap(Index);
+	Agents.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	AgentHandles.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+
+	// release the handle
+	HandleIndices[Handle] = INDEX_NONE;
+	FreeHandles.Add(Handle);
+
+	Handle = INDEX_NONE;
+}
+
+int32 UBdozawaProximitySubsystem::FindAgent(const AActor* Agent) const
+{
+	const int32* Handle = ActorHandles.Find(TWeakObjectPtr<const AActor>(Agent));
+	return Handle ? *Handle : INDEX_NONE;
+}
+
+float UBdozawaProximitySubsystem::GetDistanceSquaredToPlayer(int32 Handle) const
+{
+	if (!HandleIndices.IsValidIndex(Handle) || HandleIndices[Handle] == INDEX_NONE)
+	{
+		return MAX_flt;
+	}
+
+	return Proximity.GetDistanceSquared(HandleIndices[Handle]);
+}
+
+EBdozawaProximityBand UBdozawaProximitySubsystem::GetRangeBand(int32 Handle) const
+{
+	if (!HandleIndices.IsValidIndex(Handle) || HandleIndices[Handle] == INDEX_NONE)
+	{
+		return EBdozawaProximityBand::Outside;
+	}
+
+	return static_cast<EBdozawaProximityBand>(Proximity.GetBand(HandleIndices[Handle]));
+}
+
+int32 UBdozawaProximitySubsystem::GetNumAgentsInBand(EBdozawaProximityBand Band) const
+{
+	return Proximity.GetBandCount(static_cast<int32>(Band));
+}
+
+bool UBdozawaProximitySubsystem::IsSIMDEnabled()
+{
+	return GBdozawaProximitySIMD != 0;
+}
+
+void UBdozawaProximitySubsystem::UpdateProximity()
+{
+	SCOPE_CYCLE_COUNTER(STAT_BdozawaProximityUpdate);
+
+	LastUpdateFrame = GFrameCounter;
+
+	// gather the player locations from this frame's snapshot
+	PlayerLocations.Reset();
+
+	if (UBdozawaPlayerSnapshotSubsystem* PlayerSnapshot = GetWorld()->GetSubsystem<UBdozawaPlayerSnapshotSubsystem>())
+	{
+		for (const FBdozawaPlayerSnapshotEntry& Player : PlayerSnapshot->GetSnapshot().Players)
+		{
+			PlayerLocations.Add(Player.Location);
+		}
+	}
+
+	Proximity.SetPlayers(PlayerLocations);
+	Proximity.SetBandRadii(GBdozawaProximityNearRadius, GBdozawaProximityMidRadius, GBdozawaProximityFarRadius);
+
+	// gather the agent locations. Destroyed agents keep their last location until they unregister
+	for (int32 i = 0; i < Agents.Num(); ++i)
+	{
+		if (const AActor* Agent = Agents[i].Get())
+		{
+			Proximity.SetAgentLocation(i, Agent->GetActorLocation());
+		}
+	}
+
+	if (IsSIMDEnabled())
+	{
+		Proximity.ComputeSIMD();
+
+	} else {
+
+		Proximity.ComputeScalar();
+	}
+}
+
+void UBdozawaProximitySubsystem::OnWorldPreActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds)
+{
+	// the delegate is global, so ignore other worlds
+	if (InWorld == GetWorld())
+	{
+		EnsureUpdated();
+	}
+}
+
+void UBdozawaProximitySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// make sure the player snapshot exists so we can read it every frame
+	Collection.InitializeDependency<UBdozawaPlayerSnapshotSubsystem>();
+
+	// refresh the distances once per frame, before any agents tick, unless a LOD pass already asked for them
+	PreActorTickHandle = FWorldDelegates::OnWorldPreActorTick.AddUObject(this, &UBdozawaProximitySubsystem::OnWorldPreActorTick);
+}
+
+void UBdozawaProximitySubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPreActorTick.Remove(PreActorTickHandle);
+
+	Proximity.Reset();
+	Agents.Empty();
+	AgentHandles.Empty();
+	HandleIndices.Empty();
+	FreeHandles.Empty();
+	ActorHandles.Empty();
+	LastUpdateFrame = MAX_uint64;
+
+	Super::Deinitialize();
+}
+
+bool UBdozawaProximitySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+////////////////////////////////////////////////////////////////////
+
+/** Compares the scalar and vectorized proximity kernels at 1k and 10k agents */
+static void RunBdozawaProximityBenchmark(const TArray<FString>& Args)
+{
+	const int32 NumIterations = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 1000;
+	const int32 NumPlayers = Args.Num() > 1 ? FMath::Clamp(FCString::Atoi(*Args[1]), 1, 8) : 1;
+
+	// benchmark parameters, roughly matching a large combat arena
+	const int32 AgentCounts[] = { 1000, 10000 };
+	const float ArenaSize = 10000.0f;
+
+	for (const int32 AgentCount : AgentCounts)
+	{
+		FRandomStream Stream(AgentCount);
+
+		// scatter the players and agents around the arena
+		TArray<FVector> Players;
+
+		for (int32 i = 0; i < NumPlayers; ++i)
+		{
+			Players.Add(FVector(Stream.FRandRange(-0.5f, 0.5f) * ArenaSize, Stream.FRandRange(-0.5f, 0.5f) * ArenaSize, 0.0f));
+		}
+
+		FBdozawaProximity ScalarProximity;
+		FBdozawaProximity SIMDProximity;
+
+		for (FBdozawaProximity* Proximity : { &ScalarProximity, &SIMDProximity })
+		{
+			Proximity->SetPlayers(Players);
+			Proximity->SetBandRadii(GBdozawaProximityNearRadius, GBdozawaProximityMidRadius, GBdozawaProximityFarRadius);
+		}
+
+		for (int32 i = 0; i < AgentCount; ++i)
+		{
+			const FVector Location(Stream.FRandRange(-0.5f, 0.5f) * ArenaSize, Stream.FRandRange(-0.5f, 0.5f) * ArenaSize, Stream.FRandRange(0.0f, 500.0f));
+
+			ScalarProximity.AddAgent(Location);
+			SIMDProximity.AddAgent(Location);
+		}
+
+		// time the scalar kernel
+		const double ScalarStartTime = FPlatformTime::Seconds();
+
+		for (int32 i = 0; i < NumIterations; ++i)
+		{
+			ScalarProximity.ComputeScalar();
+		}
+
+		const double ScalarTime = FPlatformTime::Seconds() - ScalarStartTime;
+
+		// time the vectorized kernel
+		const double SIMDStartTime = FPlatformTime::Seconds();
+
+		for (int32 i = 0; i < NumIterations; ++i)
+		{
+			SIMDProximity.ComputeSIMD();
+		}
+
+		const double SIMDTime = FPlatformTime::Seconds() - SIMDStartTime;
+
+		// the kernels may round differently right at a band radius, so count instead of asserting
+		int32 NumMismatches = 0;
+
+		for (int32 i = 0; i < AgentCount; ++i)
+		{
+			NumMismatches += ScalarProximity.GetBand(i) != SIMDProximity.GetBand(i) ? 1 : 0;
+		}
+
+		UE_LOG(LogBdozawa, Log, TEXT("Proximity benchmark: %d agents, %d players, %d iterations. Scalar: %.4f ms per update. SIMD: %.4f ms per update (%.2fx). Near/Mid/Far/Outside: %d/%d/%d/%d. Band mismatches: %d."),
+			AgentCount, NumPlayers, NumIterations,
+			(ScalarTime * 1000.0) / NumIterations, (SIMDTime * 1000.0) / NumIterations, SIMDTime > 0.0 ? ScalarTime / SIMDTime : 0.0,
+			SIMDProximity.GetBandCount(0), SIMDProximity.GetBandCount(1), SIMDProximity.GetBandCount(2), SIMDProximity.GetBandCount(3),
+			NumMismatches);
+	}
+}
+
+static FAutoConsoleCommand BdozawaProximityBenchmarkCommand(
+	TEXT("Bdozawa.Proximity.Benchmark"),
+	TEXT("Compares the scalar and SIMD proximity kernels at 1000 and 10000 agents. Optional arguments: number of iterations, number of players (1-8)."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&RunBdozawaProximityBenchmark));
@@ -0,0 +1,104 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "BdozawaProximity.h"
+#include "BdozawaProximitySubsystem.generated.h"
+
+/**
+ *  Distance from an agent to the nearest player, bucketed by the Bdozawa.Proximity radii
+ */
+UENUM(BlueprintType)
+enum class EBdozawaProximityBand : uint8
+{
+	Near,
+	Mid,
+	Far,
+	Outside
+};
+
+/**
+ *  Tracks the locations of registered AI agents in a struct of arrays and refreshes their distance to the nearest player once per frame,
+ *  before any actors tick, or earlier if another pre actor tick pass asks for them first. StateTree tasks and spawners read their distance and range band from here
+ *  instead of fetching the player and computing distances one agent at a time.
+ */
+UCLASS()
+class UBdozawaProximitySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Agent locations and distances */
+	FBdozawaProximity Proximity;
+
+	/** Registered agents, in the same order as the proximity arrays */
+	TArray<TWeakObjectPtr<AActor>> Agents;
+
+	/** Handle of each registered agent, in the same order as the proximity arrays */
+	TArray<int32> AgentHandles;
+
+	/** Maps each handle to its agent's index in the proximity arrays. INDEX_NONE for free handles */
+	TArray<int32> HandleIndices;
+
+	/** Handles released by unregistered agents */
+	TArray<int32> FreeHandles;
+
+	/** Maps each registered actor to its handle */
+	TMap<TWeakObjectPtr<const AActor>, int32> ActorHandles;
+
+	/** Player locations gathered from the player snapshot */
+	TArray<FVector> PlayerLocations;
+
+	/** Frame the distances were last refreshed on */
+	uint64 LastUpdateFrame = MAX_uint64;
+
+	/** Pre actor tick delegate handle */
+	FDelegateHandle PreActorTickHandle;
+
+public:
+
+	/** Refreshes the distances unless they were already refreshed this frame.
+	 *  Pre actor tick delegates run in reverse order of registration, so other subsystems reading the distances from their own pre actor tick call this first */
+	void EnsureUpdated();
+
+	/** Starts tracking an agent. Returns the handle used to query it */
+	int32 RegisterAgent(AActor* Agent);
+
+	/** Stops tracking an agent and resets the handle */
+	void UnregisterAgent(int32& Handle);
+
+	/** Returns the handle an actor was registered with, or INDEX_NONE if it isn't registered */
+	int32 FindAgent(const AActor* Agent) const;
+
+	/** Returns the agent's squared distance to the nearest player, or MAX_flt if there are no players or the handle is invalid */
+	float GetDistanceSquaredToPlayer(int32 Handle) const;
+
+	/** Returns the agent's range band. Invalid handles are outside of all bands */
+	EBdozawaProximityBand GetRangeBand(int32 Handle) const;
+
+	/** Returns the number of agents in a range band */
+	int32 GetNumAgentsInBand(EBdozawaProximityBand Band) const;
+
+	/** Returns true if the vectorized kernel should be used */
+	static bool IsSIMDEnabled();
+
+protected:
+
+	/** Gathers agent and player locations and recomputes all distances */
+	void UpdateProximity();
+
+	/** Refreshes the distances before any actors tick */
+	void OnWorldPreActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds);
+
+public:
+
+	// ~begin USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	// ~end USubsystem interface
+
+	// ~begin UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	// ~end UWorldSubsystem interface
+};
@@ -0,0 +1,32 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "BdozawaSignificanceSubsystem.h"
+#include "BdozawaSignificanceAgent.generated.h"
+
+/**
+ *  Significance Agent Interface
+ *  Lets the significance subsystem know when an agent is engaged with the players,
+ *  and lets agents apply the parts of a significance LOD bundle that depend on their own components.
+ */
+UINTERFACE(MinimalAPI, NotBlueprintable)
+class UBdozawaSignificanceAgent : public UInterface
+{
+	GENERATED_BODY()
+};
+
+class IBdozawaSignificanceAgent
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Returns true while the agent is fighting or interacting with a player */
+	virtual bool IsEngaged() const = 0;
+
+	/** Applies the life bar and collision settings of a significance LOD bundle */
+	virtual void ApplySignificanceLOD(const FBdozawaSignificanceLOD& LOD) = 0;
+};
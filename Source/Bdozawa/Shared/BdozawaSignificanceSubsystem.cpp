@@ -0,0 +1,442 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "BdozawaSignificanceSubsystem.h"
+#include "BdozawaSignificanceAgent.h"
+#include "BdozawaProximitySubsystem.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Bdozawa Significance Update"), STAT_BdozawaSignificanceUpdate, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Significance High Agents"), STAT_BdozawaSignificanceHigh, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Significance Medium Agents"), STAT_BdozawaSignificanceMedium, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Significance Low Agents"), STAT_BdozawaSignificanceLow, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Significance Tier Changes"), STAT_BdozawaSignificanceChanges, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Significance Deferred Changes"), STAT_BdozawaSignificanceDeferred, STATGROUP_Game);
+
+static int32 GBdozawaSignificanceEnabled = 1;
+static FAutoConsoleVariableRef CVarBdozawaSignificanceEnabled(
+	TEXT("Bdozawa.Significance.Enabled"),
+	GBdozawaSignificanceEnabled,
+	TEXT("If 0, all agents are returned to high significance."),
+	ECVF_Default);
+
+static int32 GBdozawaSignificanceMaxChangesPerFrame = 8;
+static FAutoConsoleVariableRef CVarBdozawaSignificanceMaxChangesPerFrame(
+	TEXT("Bdozawa.Significance.MaxChangesPerFrame"),
+	GBdozawaSignificanceMaxChangesPerFrame,
+	TEXT("Maximum number of agents that can change significance tier in a single frame. Promotions are applied before demotions."),
+	ECVF_Default);
+
+static float GBdozawaSignificanceHighThreshold = 0.6f;
+static FAutoConsoleVariableRef CVarBdozawaSignificanceHighThreshold(
+	TEXT("Bdozawa.Significance.HighThreshold"),
+	GBdozawaSignificanceHighThreshold,
+	TEXT("Agents scoring at least this much are at high significance."),
+	ECVF_Default);
+
+static float GBdozawaSignificanceMediumThreshold = 0.3f;
+static FAutoConsoleVariableRef CVarBdozawaSignificanceMediumThreshold(
+	TEXT("Bdozawa.Significance.MediumThreshold"),
+	GBdozawaSignificanceMediumThreshold,
+	TEXT("Agents scoring at least this much are at medium significance. Agents below it are at low significance."),
+	ECVF_Default);
+
+namespace BdozawaSignificance
+{
+	/** Score weight of the distance to the nearest player */
+	constexpr float DistanceWeight = 0.4f;
+
+	/** Score weight of being inside a player's view cone */
+	constexpr float ViewWeight = 0.2f;
+
+	/** Score weight of having been rendered recently */
+	constexpr float RenderedWeight = 0.15f;
+
+	/** Score weight of being engaged with a player. Enough to reach high significance on its own */
+	constexpr float EngagedWeight = 1.0f;
+
+	/** Time after which an agent that hasn't been rendered gets no rendered score */
+	constexpr float RenderedTime = 2.0f;
+
+	/** Extra angle added to the camera's field of view, so agents at the edge of the screen still count as in view */
+	constexpr float ViewAngleMargin = 10.0f;
+
+	/** Distance the score must move past a threshold before the tier changes, to avoid flickering */
+	constexpr float Hysteresis = 0.05f;
+
+	/** Ranks the anim tick options from the cheapest to the most expensive. The enum isn't declared in cost order */
+	int32 GetAnimTickCost(EVisibilityBasedAnimTickOption Option)
+	{
+		switch (Option)
+		{
+		case EVisibilityBasedAnimTickOption::OnlyTickPoseWhenRendered:
+			return 0;
+
+		case EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered:
+			return 1;
+
+		case EVisibilityBasedAnimTickOption::OnlyTickMontagesAndRefreshBonesWhenPlayingMontages:
+			return 2;
+
+		case EVisibilityBasedAnimTickOption::AlwaysTickPose:
+			return 3;
+
+		default:
+			return 4;
+		}
+	}
+}
+
+FBdozawaSignificanceSettings::FBdozawaSignificanceSettings()
+{
+	// background agents only animate their montages while off screen
+	Medium.AnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered;
+
+	// far away agents also move and think less often, and drop their life bar and mesh collision
+	Low.AnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered;
+	Low.MovementTickInterval = 0.1f;
+	Low.StateTreeLOD = EBdozawaTickLOD::Reduced;
+	Low.bShowLifeBar = false;
+	Low.bDetailedCollision = false;
+}
+
+const FBdozawaSignificanceLOD& FBdozawaSignificanceSettings::GetLOD(EBdozawaSignificanceTier Tier) const
+{
+	switch (Tier)
+	{
+	case EBdozawaSignificanceTier::Medium:
+		return Medium;
+
+	case EBdozawaSignificanceTier::Low:
+		return Low;
+
+	default:
+		return High;
+	}
+}
+
+void UBdozawaSignificanceSubsystem::RegisterAgent(ACharacter* Character, const FBdozawaSignificanceSettings& Settings)
+{
+	// ensure the character is valid
+	if (!IsValid(Character))
+	{
+		return;
+	}
+
+	// replace any previous registration for this character
+	UnregisterAgent(Character);
+
+	FSignificanceAgent& NewAgent = Agents.AddDefaulted_GetRef();
+	NewAgent.Character = Character;
+	NewAgent.Settings = Settings;
+
+	// remember the designer's settings, so the tiers only ever make them cheaper
+	if (const USkeletalMeshComponent* Mesh = Character->GetMesh())
+	{
+		NewAgent.OriginalAnimTickOption = Mesh->VisibilityBasedAnimTickOption;
+	}
+
+	if (const UCharacterMovementComponent* Movement = Character->GetCharacterMovement())
+	{
+		NewAgent.OriginalMovementTickInterval = Movement->GetComponentTickInterval();
+	}
+}
+
+void UBdozawaSignificanceSubsystem::UnregisterAgent(ACharacter* Character)
+{
+	for (int32 i = Agents.Num() - 1; i >= 0; --i)
+	{
+		if (Agents[i].Character.Get() == Character)
+		{
+			// put back the settings the agent registered with. Agents reset their own life bar and collision when they leave play
+			if (Character)
+			{
+				if (USkeletalMeshComponent* Mesh = Character->GetMesh())
+				{
+					Mesh->VisibilityBasedAnimTickOption = Agents[i].OriginalAnimTickOption;
+				}
+
+				if (UCharacterMovementComponent* Movement = Character->GetCharacterMovement())
+				{
+					Movement->SetComponentTickInterval(Agents[i].OriginalMovementTickInterval);
+				}
+
+				if (UBdozawaTickLODSubsystem* TickLOD = GetWorld()->GetSubsystem<UBdozawaTickLODSubsystem>())
+				{
+					TickLOD->SetMinimumLOD(Character->GetController(), EBdozawaTickLOD::Full);
+				}
+			}
+
+			Agents.RemoveAtSwap(i, 1, EAllowShrinking::No);
+		}
+	}
+}
+
+EBdozawaSignificanceTier UBdozawaSignificanceSubsystem::GetTier(const ACharacter* Character) const
+{
+	for (const FSignificanceAgent& Agent : Agents)
+	{
+		if (Agent.Character.Get() == Character)
+		{
+			return Agent.Tier;
+		}
+	}
+
+	return EBdozawaSignificanceTier::High;
+}
+
+void UBdozawaSignificanceSubsystem::UpdateSignificance()
+{
+	SCOPE_CYCLE_COUNTER(STAT_BdozawaSignificanceUpdate);
+
+	GatherViews();
+
+	// our pre actor tick may run before the proximity subsystem's, so make sure this frame's bands are in
+	UBdozawaProximitySubsystem* Proximity = GetWorld()->GetSubsystem<UBdozawaProximitySubsystem>();
+
+	if (Proximity)
+	{
+		Proximity->EnsureUpdated();
+	}
+
+	const double WorldTime = GetWorld()->GetTimeSeconds();
+
+	PendingChanges.Reset();
+	DesiredTiers.Reset();
+
+	// drop agents destroyed without unregistering
+	for (int32 i = Agents.Num() - 1; i >= 0; --i)
+	{
+		if (!Agents[i].Character.IsValid())
+		{
+			Agents.RemoveAtSwap(i, 1, EAllowShrinking::No);
+		}
+	}
+
+	// score every agent and collect the ones that want to change tier
+	DesiredTiers.SetNumUninitialized(Agents.Num());
+
+	for (int32 i = 0; i < Agents.Num(); ++i)
+	{
+		FSignificanceAgent& Agent = Agents[i];
+
+		Agent.Score = ScoreAgent(Agent, Proximity, WorldTime);
+		DesiredTiers[i] = ChooseTier(Agent.Tier, Agent.Score);
+
+		if (DesiredTiers[i] != Agent.Tier)
+		{
+			// promotions go first, most significant agents first. Demotions follow, least significant agents first
+			const bool bPromotion = DesiredTiers[i] < Agent.Tier;
+			const float Priority = bPromotion ? 2.0f + Agent.Score : 1.0f - Agent.Score;
+
+			PendingChanges.Emplace(Priority, i);
+		}
+	}
+
+	// apply as many changes as the budget allows. The rest wait for the next frame
+	const int32 NumChanges = FMath::Min(PendingChanges.Num(), FMath::Max(GBdozawaSignificanceMaxChangesPerFrame, 1));
+
+	if (NumChanges < PendingChanges.Num())
+	{
+		PendingChanges.Sort([](const TPair<float, int32>& A, const TPair<float, int32>& B) { return A.Key > B.Key; });
+	}
+
+	for (int32 i = 0; i < NumChanges; ++i)
+	{
+		const int32 AgentIndex = PendingChanges[i].Value;
+		ApplyTier(Agents[AgentIndex], DesiredTiers[AgentIndex], true);
+	}
+
+	// update the stats
+	int32 TierCounts[3] = { 0, 0, 0 };
+
+	for (const FSignificanceAgent& Agent : Agents)
+	{
+		++TierCounts[static_cast<int32>(Agent.Tier)];
+	}
+
+	SET_DWORD_STAT(STAT_BdozawaSignificanceHigh, TierCounts[0]);
+	SET_DWORD_STAT(STAT_BdozawaSignificanceMedium, TierCounts[1]);
+	SET_DWORD_STAT(STAT_BdozawaSignificanceLow, TierCounts[2]);
+	SET_DWORD_STAT(STAT_BdozawaSignificanceChanges, NumChanges);
+	SET_DWORD_STAT(STAT_BdozawaSignificanceDeferred, PendingChanges.Num() - NumChanges);
+}
+
+void UBdozawaSignificanceSubsystem::GatherViews()
+{
+	Views.Reset();
+
+	for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		const APlayerController* PlayerController = Iterator->Get();
+		const APlayerCameraManager* CameraManager = PlayerController && PlayerController->IsLocalController() ? PlayerController->PlayerCameraManager.Get() : nullptr;
+
+		if (!CameraManager)
+		{
+			continue;
+		}
+
+		// approximate the view frustum with a cone around the horizontal field of view
+		FSignificanceView& View = Views.AddDefaulted_GetRef();
+		View.Location = CameraManager->GetCameraLocation();
+		View.Direction = CameraManager->GetCameraRotation().Vector();
+		View.CosHalfAngle = FMath::Cos(FMath::DegreesToRadians(FMath::Min((CameraManager->GetFOVAngle() * 0.5f) + BdozawaSignificance::ViewAngleMargin, 89.0f)));
+	}
+}
+
+float UBdozawaSignificanceSubsystem::ScoreAgent(const FSignificanceAgent& Agent, const UBdozawaProximitySubsystem* Proximity, double WorldTime) const
+{
+	const ACharacter* Character = Agent.Character.Get();
+
+	// disabled agents always stay at high significance
+	if (!GBdozawaSignificanceEnabled || !Agent.Settings.bEnabled)
+	{
+		return 1.0f;
+	}
+
+	float Score = 0.0f;
+
+	// distance, from the proximity bands computed this frame
+	if (Proximity)
+	{
+		const int32 Band = static_cast<int32>(Proximity->GetRangeBand(Proximity->FindAgent(Character)));
+		Score += BdozawaSignificance::DistanceWeight * (static_cast<float>(EBdozawaProximityBand::Outside) - Band) / static_cast<float>(EBdozawaProximityBand::Outside);
+	}
+
+	// view cone
+	const FVector Location = Character->GetActorLocation();
+
+	for (const FSignificanceView& View : Views)
+	{
+		if (FVector::DotProduct((Location - View.Location).GetSafeNormal(), View.Direction) >= View.CosHalfAngle)
+		{
+			Score += BdozawaSignificance::ViewWeight;
+			break;
+		}
+	}
+
+	// last rendered time, fading out over a couple of seconds
+	const float TimeSinceRendered = static_cast<float>(WorldTime) - Character->GetLastRenderTime();
+	Score += BdozawaSignificance::RenderedWeight * (1.0f - FMath::Clamp(TimeSinceRendered / BdozawaSignificance::RenderedTime, 0.0f, 1.0f));
+
+	// combat engagement
+	const IBdozawaSignificanceAgent* SignificanceAgent = Cast<IBdozawaSignificanceAgent>(Character);
+
+	if (SignificanceAgent && SignificanceAgent->IsEngaged())
+	{
+		Score += BdozawaSignificance::EngagedWeight;
+	}
+
+	return FMath::Min(Score, 1.0f);
+}
+
+EBdozawaSignificanceTier UBdozawaSignificanceSubsystem::ChooseTier(EBdozawaSignificanceTier CurrentTier, float Score)
+{
+	auto TierFromScore = [](float InScore)
+	{
+		if (InScore >= GBdozawaSignificanceHighThreshold)
+		{
+			return EBdozawaSignificanceTier::High;
+		}
+
+		return InScore >= GBdozawaSignificanceMediumThreshold ? EBdozawaSignificanceTier::Medium : EBdozawaSignificanceTier::Low;
+	};
+
+	// promote once the score is clearly above a threshold
+	const EBdozawaSignificanceTier PromotedTier = TierFromScore(Score - BdozawaSignificance::Hysteresis);
+
+	if (PromotedTier < CurrentTier)
+	{
+		return PromotedTier;
+	}
+
+	// demote once the score is clearly below a threshold
+	const EBdozawaSignificanceTier DemotedTier = TierFromScore(Score + BdozawaSignificance::Hysteresis);
+
+	return DemotedTier > CurrentTier ? DemotedTier : CurrentTier;
+}
+
+void UBdozawaSignificanceSubsystem::ApplyTier(FSignificanceAgent& Agent, EBdozawaSignificanceTier Tier, bool bNotifyAgent)
+{
+	Agent.Tier = Tier;
+
+	ACharacter* Character = Agent.Character.Get();
+
+	if (!Character)
+	{
+		return;
+	}
+
+	const FBdozawaSignificanceLOD& LOD = Agent.Settings.GetLOD(Tier);
+
+	// animation, keeping the original option if it's already cheaper
+	if (USkeletalMeshComponent* Mesh = Character->GetMesh())
+	{
+		const bool bOriginalIsCheaper = BdozawaSignificance::GetAnimTickCost(Agent.OriginalAnimTickOption) < BdozawaSignificance::GetAnimTickCost(LOD.AnimTickOption);
+		Mesh->VisibilityBasedAnimTickOption = bOriginalIsCheaper ? Agent.OriginalAnimTickOption : LOD.AnimTickOption;
+	}
+
+	// movement, keeping the original interval if it's already longer
+	if (UCharacterMovementComponent* Movement = Character->GetCharacterMovement())
+	{
+		Movement->SetComponentTickInterval(FMath::Max(LOD.MovementTickInterval, Agent.OriginalMovementTickInterval));
+	}
+
+	// StateTree
+	if (UBdozawaTickLODSubsystem* TickLOD = GetWorld()->GetSubsystem<UBdozawaTickLODSubsystem>())
+	{
+		TickLOD->SetMinimumLOD(Character->GetController(), LOD.StateTreeLOD);
+	}
+
+	// life bar and collision are up to the agent
+	if (bNotifyAgent)
+	{
+		if (IBdozawaSignificanceAgent* SignificanceAgent = Cast<IBdozawaSignificanceAgent>(Character))
+		{
+			SignificanceAgent->ApplySignificanceLOD(LOD);
+		}
+	}
+}
+
+void UBdozawaSignificanceSubsystem::OnWorldPreActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds)
+{
+	// the delegate is global, so ignore other worlds
+	if (InWorld == GetWorld())
+	{
+		UpdateSignificance();
+	}
+}
+
+void UBdozawaSignificanceSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// make sure the subsystems we read and drive exist. Proximity distances are refreshed on demand when we update
+	Collection.InitializeDependency<UBdozawaProximitySubsystem>();
+	Collection.InitializeDependency<UBdozawaTickLODSubsystem>();
+
+	PreActorTickHandle = FWorldDelegates::OnWorldPreActorTick.AddUObject(this, &UBdozawaSignificanceSubsystem::OnWorldPreActorTick);
+}
+
+void UBdozawaSignificanceSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPreActorTick.Remove(PreActorTickHandle);
+
+	Agents.Empty();
+	Views.Empty();
+	PendingChanges.Empty();
+	DesiredTiers.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UBdozawaSignificanceSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
@@ -0,0 +1,187 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Components/SkinnedMeshComponent.h"
+#include "BdozawaTickLODSubsystem.h"
+#include "BdozawaSignificanceSubsystem.generated.h"
+
+class ACharacter;
+class UBdozawaProximitySubsystem;
+
+/**
+ *  How important an agent currently is to the players
+ */
+UENUM(BlueprintType)
+enum class EBdozawaSignificanceTier : uint8
+{
+	High,
+	Medium,
+	Low
+};
+
+/**
+ *  Costs an agent is allowed to spend at a significance tier
+ */
+USTRUCT(BlueprintType)
+struct FBdozawaSignificanceLOD
+{
+	GENERATED_BODY()
+
+	/** When the skeletal mesh ticks its pose and refreshes its bones */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Significance")
+	EVisibilityBasedAnimTickOption AnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+
+	/** Tick interval of the character movement component. Zero ticks every frame */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Significance", meta = (ClampMin = 0, ClampMax = 1, Units="s"))
+	float MovementTickInterval = 0.0f;
+
+	/** Highest StateTree tick rate. The tick LOD policy may still lower it further */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Significance")
+	EBdozawaTickLOD StateTreeLOD = EBdozawaTickLOD::Full;
+
+	/** If false, the life bar is hidden */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Significance")
+	bool bShowLifeBar = true;
+
+	/** If false, the skeletal mesh collision is disabled and the agent only collides with its capsule */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Significance")
+	bool bDetailedCollision = true;
+};
+
+/**
+ *  LOD bundle applied to an agent at each significance tier
+ */
+USTRUCT(BlueprintType)
+struct FBdozawaSignificanceSettings
+{
+	GENERATED_BODY()
+
+	/** If false, the agent always uses the high significance bundle */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Significance")
+	bool bEnabled = true;
+
+	/** Bundle for agents close to, visible to, or fighting the players */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Significance")
+	FBdozawaSignificanceLOD High;
+
+	/** Bundle for agents in the background */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Significance")
+	FBdozawaSignificanceLOD Medium;
+
+	/** Bundle for agents far away and out of view */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Significance")
+	FBdozawaSignificanceLOD Low;
+
+	/** Constructor. Sets up the default bundles */
+	FBdozawaSignificanceSettings();
+
+	/** Returns the bundle for a tier */
+	const FBdozawaSignificanceLOD& GetLOD(EBdozawaSignificanceTier Tier) const;
+};
+
+/**
+ *  Ranks AI agents by their distance to the players, whether they're in a player's view, when they were last rendered
+ *  and whether they're engaged in combat, and maps the score to a significance tier once per frame.
+ *  Each tier applies a coordinated LOD bundle to the agent's mesh, movement, StateTree, life bar and collision.
+ *  Tier changes are budgeted per frame so a camera cut or a crowd entering view doesn't spike a single frame.
+ */
+UCLASS()
+class UBdozawaSignificanceSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** A registered agent */
+	struct FSignificanceAgent
+	{
+		/** Agent character */
+		TWeakObjectPtr<ACharacter> Character;
+
+		/** LOD bundles */
+		FBdozawaSignificanceSettings Settings;
+
+		/** Current tier */
+		EBdozawaSignificanceTier Tier = EBdozawaSignificanceTier::High;
+
+		/** Score from the last update */
+		float Score = 1.0f;
+
+		/** Mesh anim tick option the agent had when it registered. Tiers never tick more often than this */
+		EVisibilityBasedAnimTickOption OriginalAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+
+		/** Movement tick interval the agent had when it registered. Tiers never tick more often than this */
+		float OriginalMovementTickInterval = 0.0f;
+	};
+
+	/** A player view used to test agents against */
+	struct FSignificanceView
+	{
+		/** Camera location */
+		FVector Location = FVector::ZeroVector;
+
+		/** Camera forward vector */
+		FVector Direction = FVector::ForwardVector;
+
+		/** Cosine of the view cone's half angle */
+		float CosHalfAngle = 0.0f;
+	};
+
+	/** All registered agents */
+	TArray<FSignificanceAgent> Agents;
+
+	/** Player views gathered this frame */
+	TArray<FSignificanceView> Views;
+
+	/** Agents waiting for a tier change this frame, as pairs of priority and agent index */
+	TArray<TPair<float, int32>> PendingChanges;
+
+	/** Desired tier of each agent this frame */
+	TArray<EBdozawaSignificanceTier> DesiredTiers;
+
+	/** Pre actor tick delegate handle */
+	FDelegateHandle PreActorTickHandle;
+
+public:
+
+	/** Starts ranking an agent. It's assumed to be at high significance, and its current mesh and movement settings are kept as its baseline */
+	void RegisterAgent(ACharacter* Character, const FBdozawaSignificanceSettings& Settings);
+
+	/** Stops ranking an agent, restores its original mesh and movement settings and lifts its StateTree limit */
+	void UnregisterAgent(ACharacter* Character);
+
+	/** Returns an agent's current tier. Unregistered agents are at high significance */
+	EBdozawaSignificanceTier GetTier(const ACharacter* Character) const;
+
+protected:
+
+	/** Scores all agents and applies the budgeted tier changes */
+	void UpdateSignificance();
+
+	/** Gathers the local players' camera views */
+	void GatherViews();
+
+	/** Returns a score between 0 and 1 for an agent */
+	float ScoreAgent(const FSignificanceAgent& Agent, const UBdozawaProximitySubsystem* Proximity, double WorldTime) const;
+
+	/** Returns the tier an agent should move to, with hysteresis around the thresholds */
+	static EBdozawaSignificanceTier ChooseTier(EBdozawaSignificanceTier CurrentTier, float Score);
+
+	/** Sets an agent's tier and applies its LOD bundle, without ticking more often than the agent's baseline */
+	void ApplyTier(FSignificanceAgent& Agent, EBdozawaSignificanceTier Tier, bool bNotifyAgent);
+
+	/** Updates significance before any actors tick */
+	void OnWorldPreActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds);
+
+public:
+
+	// ~begin USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	// ~end USubsystem interface
+
+	// ~begin UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	// ~end UWorldSubsystem interface
+};
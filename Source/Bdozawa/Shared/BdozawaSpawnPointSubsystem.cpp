@@ -0,0 +1,147 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "BdozawaSpawnPointSubsystem.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/PlayerStart.h"
+#include "HAL/IConsoleManager.h"
+
+static int32 GBdozawaRespawnInPlace = 1;
+static FAutoConsoleVariableRef CVarBdozawaRespawnInPlace(
+	TEXT("Bdozawa.Respawn.InPlace"),
+	GBdozawaRespawnInPlace,
+	TEXT("0: player characters are destroyed and re-created by their controller on respawn.\n")
+	TEXT("1: player characters are reset and teleported to their respawn point."),
+	ECVF_Default);
+
+bool UBdozawaSpawnPointSubsystem::IsInPlaceRespawnEnabled()
+{
+	return GBdozawaRespawnInPlace != 0;
+}
+
+void UBdozawaSpawnPointSubsystem::SetCheckpoint(const AController* Controller, const FTransform& Transform)
+{
+	if (Controller)
+	{
+		Checkpoints.Add(Controller, Transform);
+	}
+}
+
+void UBdozawaSpawnPointSubsystem::ClearCheckpoint(const AController* Controller)
+{
+	Checkpoints.Remove(Controller);
+}
+
+bool UBdozawaSpawnPointSubsystem::GetRespawnTransform(const AController* Controller, FTransform& OutTransform) const
+{
+	// prefer the controller's last checkpoint
+	if (const FTransform* Checkpoint = Checkpoints.Find(Controller))
+	{
+		OutTransform = *Checkpoint;
+		return true;
+	}
+
+	// fall back to the player start
+	if (const APlayerStart* PlayerStart = GetFirstPlayerStart())
+	{
+		OutTransform = PlayerStart->GetActorTransform();
+		return true;
+	}
+
+	return false;
+}
+
+APlayerStart* UBdozawaSpawnPointSubsystem::GetFirstPlayerStart() const
+{
+	for (const TWeakObjectPtr<APlayerStart>& PlayerStart : PlayerStarts)
+	{
+		if (APlayerStart* ValidStart = PlayerStart.Get())
+		{
+			return ValidStart;
+		}
+	}
+
+	return nullptr;
+}
+
+void UBdozawaSpawnPointSubsystem::AddPlayerStart(APlayerStart* PlayerStart)
+{
+	if (IsValid(PlayerStart))
+	{
+		PlayerStarts.AddUnique(PlayerStart);
+	}
+}
+
+void UBdozawaSpawnPointSubsystem::AddLevelPlayerStarts(const ULevel* Level)
+{
+	for (AActor* Actor : Level->Actors)
+	{
+		AddPlayerStart(Cast<APlayerStart>(Actor));
+	}
+}
+
+void UBdozawaSpawnPointSubsystem::OnLevelAdded(ULevel* Level, UWorld* InWorld)
+{
+	if (InWorld == GetWorld() && Level)
+	{
+		AddLevelPlayerStarts(Level);
+	}
+}
+
+void UBdozawaSpawnPointSubsystem::OnLevelRemoved(ULevel* Level, UWorld* InWorld)
+{
+	if (InWorld != GetWorld())
+	{
+		return;
+	}
+
+	// a null level means all levels are being removed
+	PlayerStarts.RemoveAll([Level](const TWeakObjectPtr<APlayerStart>& PlayerStart)
+	{
+		return !PlayerStart.IsValid() || !Level || PlayerStart->GetLevel() == Level;
+	});
+}
+
+void UBdozawaSpawnPointSubsystem::OnActorSpawned(AActor* Actor)
+{
+	AddPlayerStart(Cast<APlayerStart>(Actor));
+}
+
+void UBdozawaSpawnPointSubsystem::Deinitialize()
+{
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+	FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+
+	GetWorld()->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+
+	PlayerStarts.Empty();
+	Checkpoints.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UBdozawaSpawnPointSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UBdozawaSpawnPointSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// register the player starts of the levels that are already loaded
+	for (const ULevel* Level : InWorld.GetLevels())
+	{
+		if (Level && Level->bIsVisible)
+		{
+			AddLevelPlayerStarts(Level);
+		}
+	}
+
+	// keep track of player starts coming and going from now on
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &UBdozawaSpawnPointSubsystem::OnLevelAdded);
+	LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddUObject(this, &UBdozawaSpawnPointSubsystem::OnLevelRemoved);
+	ActorSpawnedHandle = InWorld.AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &UBdozawaSpawnPointSubsystem::OnActorSpawned));
+}
@@ -0,0 +1,82 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "BdozawaSpawnPointSubsystem.generated.h"
+
+class AController;
+class APlayerStart;
+class ULevel;
+
+/**
+ *  Registry of player spawn points and checkpoints, shared by all game variants.
+ *  Player starts are tracked incrementally as levels are added, removed or as starts are spawned,
+ *  so finding a respawn transform never iterates the world. Checkpoints are kept per controller.
+ *  Also gates in-place respawns, where player characters are reset and teleported instead of re-created.
+ */
+UCLASS()
+class UBdozawaSpawnPointSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Registered player starts, in registration order */
+	TArray<TWeakObjectPtr<APlayerStart>> PlayerStarts;
+
+	/** Last checkpoint reached by each controller */
+	TMap<TObjectKey<AController>, FTransform> Checkpoints;
+
+	/** Level streaming delegate handles */
+	FDelegateHandle LevelAddedHandle;
+	FDelegateHandle LevelRemovedHandle;
+
+	/** Actor spawned delegate handle */
+	FDelegateHandle ActorSpawnedHandle;
+
+public:
+
+	/** Returns true if player characters should be reset and teleported on respawn instead of destroyed and re-created */
+	static bool IsInPlaceRespawnEnabled();
+
+	/** Saves the checkpoint the controller's pawn will respawn at */
+	void SetCheckpoint(const AController* Controller, const FTransform& Transform);
+
+	/** Forgets the controller's checkpoint, so it respawns at a player start */
+	void ClearCheckpoint(const AController* Controller);
+
+	/** Finds the transform to respawn the controller's pawn at: its checkpoint, or the first player start. Returns false if there are neither */
+	bool GetRespawnTransform(const AController* Controller, FTransform& OutTransform) const;
+
+	/** Returns the first valid player start, or null if none are registered */
+	APlayerStart* GetFirstPlayerStart() const;
+
+protected:
+
+	/** Registers a player start */
+	void AddPlayerStart(APlayerStart* PlayerStart);
+
+	/** Registers the player starts placed in a level */
+	void AddLevelPlayerStarts(const ULevel* Level);
+
+	/** Called when a streamed level is made visible */
+	void OnLevelAdded(ULevel* Level, UWorld* InWorld);
+
+	/** Called when a streamed level is hidden */
+	void OnLevelRemoved(ULevel* Level, UWorld* InWorld);
+
+	/** Called when an actor is spawned at runtime */
+	void OnActorSpawned(AActor* Actor);
+
+public:
+
+	// ~begin USubsystem interface
+	virtual void Deinitialize() override;
+	// ~end USubsystem interface
+
+	// ~begin UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	// ~end UWorldSubsystem interface
+};
@@ -0,0 +1,59 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "BdozawaStateTreeUtility.h"
+#include "StateTreeExecutionContext.h"
+#include "StateTreeExecutionTypes.h"
+#include "BdozawaPlayerSnapshotSubsystem.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+
+void FStateTreePlayerSnapshotEvaluator::TreeStart(FStateTreeExecutionContext& Context) const
+{
+	ReadSnapshot(Context);
+}
+
+void FStateTreePlayerSnapshotEvaluator::Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const
+{
+	ReadSnapshot(Context);
+}
+
+void FStateTreePlayerSnapshotEvaluator::ReadSnapshot(FStateTreeExecutionContext& Context) const
+{
+	// get the instance data
+	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+
+	UBdozawaPlayerSnapshotSubsystem* PlayerSnapshot = Context.GetWorld() ? Context.GetWorld()->GetSubsystem<UBdozawaPlayerSnapshotSubsystem>() : nullptr;
+	const FBdozawaPlayerSnapshotEntry* Player = PlayerSnapshot ? PlayerSnapshot->GetSnapshot().GetFirstPlayer() : nullptr;
+
+	InstanceData.bHasPlayer = Player != nullptr;
+
+	if (Player)
+	{
+		InstanceData.PlayerPawn = Player->Pawn;
+		InstanceData.PlayerCharacter = Player->Character;
+		InstanceData.PlayerLocation = Player->Location;
+		InstanceData.PlayerVelocity = Player->Velocity;
+		InstanceData.bPlayerGrounded = Player->bGrounded;
+
+	} else {
+
+		// keep the last known location
+		InstanceData.PlayerPawn = nullptr;
+		InstanceData.PlayerCharacter = nullptr;
+		InstanceData.PlayerVelocity = FVector::ZeroVector;
+		InstanceData.bPlayerGrounded = false;
+	}
+
+	if (InstanceData.Actor)
+	{
+		InstanceData.DistanceToPlayer = FVector::Distance(InstanceData.PlayerLocation, InstanceData.Actor->GetActorLocation());
+	}
+}
+
+#if WITH_EDITOR
+FText FStateTreePlayerSnapshotEvaluator::GetDescription(const FGuid& ID, FStateTreeDataView InstanceDataView, const IStateTreeBindingLookup& BindingLookup, EStateTreeNodeFormatting Formatting /*= EStateTreeNodeFormatting::Text*/) const
+{
+	return FText::FromString("<b>Player Snapshot</b>");
+}
+#endif // WITH_EDITOR
@@ -0,0 +1,80 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "StateTreeEvaluatorBase.h"
+
+#include "BdozawaStateTreeUtility.generated.h"
+
+class APawn;
+class ACharacter;
+
+/**
+ *  Instance data for the FStateTreePlayerSnapshotEvaluator evaluator
+ */
+USTRUCT()
+struct FStateTreePlayerSnapshotEvaluatorInstanceData
+{
+	GENERATED_BODY()
+
+	/** Actor owning the StateTree. Used to measure the distance to the player */
+	UPROPERTY(EditAnywhere, Category="Context")
+	TObjectPtr<AActor> Actor;
+
+	/** True if the first player has a pawn */
+	UPROPERTY(VisibleAnywhere, Category="Output")
+	bool bHasPlayer = false;
+
+	/** Pawn possessed by the first player */
+	UPROPERTY(VisibleAnywhere, Category="Output")
+	TObjectPtr<APawn> PlayerPawn;
+
+	/** Pawn possessed by the first player, if it's a character */
+	UPROPERTY(VisibleAnywhere, Category="Output")
+	TObjectPtr<ACharacter> PlayerCharacter;
+
+	/** Last known player location. Kept if the player loses its pawn */
+	UPROPERTY(VisibleAnywhere, Category="Output")
+	FVector PlayerLocation = FVector::ZeroVector;
+
+	/** Player velocity */
+	UPROPERTY(VisibleAnywhere, Category="Output")
+	FVector PlayerVelocity = FVector::ZeroVector;
+
+	/** True if the player character is walking on the ground */
+	UPROPERTY(VisibleAnywhere, Category="Output")
+	bool bPlayerGrounded = false;
+
+	/** Distance from the owning actor to the last known player location */
+	UPROPERTY(VisibleAnywhere, Category="Output")
+	float DistanceToPlayer = 0.0f;
+};
+
+/**
+ *  StateTree evaluator that exposes the first player from the per-frame player snapshot
+ */
+USTRUCT(meta=(DisplayName="Player Snapshot", Category="Bdozawa"))
+struct FStateTreePlayerSnapshotEvaluator : public FStateTreeEvaluatorCommonBase
+{
+	GENERATED_BODY()
+
+	/* Ensure we're using the correct instance data struct */
+	using FInstanceDataType = FStateTreePlayerSnapshotEvaluatorInstanceData;
+	virtual const UStruct* GetInstanceDataType() const override { return FInstanceDataType::StaticStruct(); }
+
+	/** Reads the snapshot when the tree starts, so the outputs are valid for the first state */
+	virtual void TreeStart(FStateTreeExecutionContext& Context) const override;
+
+	/** Reads the snapshot every tick */
+	virtual void Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const override;
+
+#if WITH_EDITOR
+	virtual FText GetDescription(const FGuid& ID, FStateTreeDataView InstanceDataView, const IStateTreeBindingLookup& BindingLookup, EStateTreeNodeFormatting Formatting = EStateTreeNodeFormatting::Text) const override;
+#endif // WITH_EDITOR
+
+protected:
+
+	/** Copies the first player's snapshot entry to the outputs */
+	void ReadSnapshot(FStateTreeExecutionContext& Context) const;
+};
@@ -0,0 +1,242 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "BdozawaTickLODSubsystem.h"
+#include "BdozawaProximitySubsystem.h"
+#include "Components/ActorComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/Pawn.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Bdozawa Tick LOD Update"), STAT_BdozawaTickLODUpdate, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Tick LOD Full Rate Agents"), STAT_BdozawaTickLODFull, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Tick LOD Reduced Rate Agents"), STAT_BdozawaTickLODReduced, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Tick LOD Minimal Rate Agents"), STAT_BdozawaTickLODMinimal, STATGROUP_Game);
+
+static int32 GBdozawaTickLODEnabled = 1;
+static FAutoConsoleVariableRef CVarBdozawaTickLODEnabled(
+	TEXT("Bdozawa.TickLOD.Enabled"),
+	GBdozawaTickLODEnabled,
+	TEXT("If 0, AI StateTrees always tick every frame regardless of their tick LOD policy."),
+	ECVF_Default);
+
+float FBdozawaTickLODPolicy::GetTickInterval(EBdozawaTickLOD LOD) const
+{
+	switch (LOD)
+	{
+	case EBdozawaTickLOD::Reduced:
+		return 1.0f / FMath::Max(ReducedTickRate, 0.1f);
+
+	case EBdozawaTickLOD::Minimal:
+		return 1.0f / FMath::Max(MinimalTickRate, 0.1f);
+
+	default:
+		return 0.0f;
+	}
+}
+
+void UBdozawaTickLODSubsystem::RegisterAgent(AController* Controller, UActorComponent* StateTree, const FBdozawaTickLODPolicy& Policy)
+{
+	// ensure the controller and component are valid
+	if (!IsValid(Controller) || !IsValid(StateTree))
+	{
+		return;
+	}
+
+	// replace any previous registration for this controller
+	UnregisterAgent(Controller);
+
+	FTickLODAgent& NewAgent = Agents.AddDefaulted_GetRef();
+	NewAgent.Controller = Controller;
+	NewAgent.StateTree = StateTree;
+	NewAgent.Policy = Policy;
+}
+
+void UBdozawaTickLODSubsystem::UnregisterAgent(AController* Controller)
+{
+	for (int32 i = Agents.Num() - 1; i >= 0; --i)
+	{
+		if (Agents[i].Controller.Get() == Controller)
+		{
+			// leave the StateTree ticking at full rate
+			ApplyLOD(Agents[i], EBdozawaTickLOD::Full);
+
+			Agents.RemoveAtSwap(i, 1, EAllowShrinking::No);
+		}
+	}
+}
+
+void UBdozawaTickLODSubsystem::SetMinimumLOD(const AController* Controller, EBdozawaTickLOD MinimumLOD)
+{
+	for (FTickLODAgent& Agent : Agents)
+	{
+		if (Agent.Controller.Get() == Controller)
+		{
+			// the new LOD is applied on the next update
+			Agent.MinimumLOD = MinimumLOD;
+		}
+	}
+}
+
+void UBdozawaTickLODSubsystem::BoostAgent(const APawn* Pawn)
+{
+	const AController* Controller = Pawn ? Pawn->GetController() : nullptr;
+
+	if (!Controller)
+	{
+		return;
+	}
+
+	for (FTickLODAgent& Agent : Agents)
+	{
+		if (Agent.Controller.Get() == Controller)
+		{
+			Agent.BoostEndTime = GetWorld()->GetTimeSeconds() + Agent.Policy.BoostTime;
+
+			// don't wait for the next frame, the StateTree should react to this one
+			ApplyLOD(Agent, EBdozawaTickLOD::Full);
+		}
+	}
+}
+
+bool UBdozawaTickLODSubsystem::IsTickLODEnabled()
+{
+	return GBdozawaTickLODEnabled != 0;
+}
+
+void UBdozawaTickLODSubsystem::UpdateLODs()
+{
+	SCOPE_CYCLE_COUNTER(STAT_BdozawaTickLODUpdate);
+
+	// our pre actor tick may run before the proximity subsystem's, so make sure this frame's bands are in
+	UBdozawaProximitySubsystem* Proximity = GetWorld()->GetSubsystem<UBdozawaProximitySubsystem>();
+
+	if (Proximity)
+	{
+		Proximity->EnsureUpdated();
+	}
+
+	const double WorldTime = GetWorld()->GetTimeSeconds();
+
+	int32 LODCounts[3] = { 0, 0, 0 };
+
+	for (int32 i = Agents.Num() - 1; i >= 0; --i)
+	{
+		FTickLODAgent& Agent = Agents[i];
+
+		// drop agents whose controller or component was destroyed without unregistering
+		if (!Agent.Controller.IsValid() || !Agent.StateTree.IsValid())
+		{
+			Agents.RemoveAtSwap(i, 1, EAllowShrinking::No);
+			continue;
+		}
+
+		const EBdozawaTickLOD NewLOD = ChooseLOD(Agent, Proximity, WorldTime);
+
+		if (NewLOD != Agent.LOD)
+		{
+			ApplyLOD(Agent, NewLOD);
+		}
+
+		++LODCounts[static_cast<int32>(Agent.LOD)];
+	}
+
+	SET_DWORD_STAT(STAT_BdozawaTickLODFull, LODCounts[0]);
+	SET_DWORD_STAT(STAT_BdozawaTickLODReduced, LODCounts[1]);
+	SET_DWORD_STAT(STAT_BdozawaTickLODMinimal, LODCounts[2]);
+}
+
+EBdozawaTickLOD UBdozawaTickLODSubsystem::ChooseLOD(const FTickLODAgent& Agent, const UBdozawaProximitySubsystem* Proximity, double WorldTime) const
+{
+	// recently damaged or disabled agents tick at full rate
+	if (!IsTickLODEnabled() || !Agent.Policy.bEnabled || !Proximity || WorldTime < Agent.BoostEndTime)
+	{
+		return EBdozawaTickLOD::Full;
+	}
+
+	const APawn* Pawn = Agent.Controller->GetPawn();
+
+	if (!Pawn)
+	{
+		return EBdozawaTickLOD::Full;
+	}
+
+	// pick the LOD for the pawn's range band
+	EBdozawaTickLOD LOD = EBdozawaTickLOD::Full;
+
+	switch (Proximity->GetRangeBand(Proximity->FindAgent(Pawn)))
+	{
+	case EBdozawaProximityBand::Near:
+
+		// near agents are always in play, even when the camera doesn't see them
+		return FMath::Max(Agent.Policy.NearLOD, Agent.MinimumLOD);
+
+	case EBdozawaProximityBand::Mid:
+
+		LOD = Agent.Policy.MidLOD;
+		break;
+
+	case EBdozawaProximityBand::Far:
+
+		LOD = Agent.Policy.FarLOD;
+		break;
+
+	default:
+
+		LOD = Agent.Policy.OutsideLOD;
+		break;
+	}
+
+	// lower the LOD for agents the players can't see
+	if (!Pawn->WasRecentlyRendered(Agent.Policy.OffScreenTime))
+	{
+		LOD = FMath::Max(LOD, Agent.Policy.OffScreenLOD);
+	}
+
+	return FMath::Max(LOD, Agent.MinimumLOD);
+}
+
+void UBdozawaTickLODSubsystem::ApplyLOD(FTickLODAgent& Agent, EBdozawaTickLOD LOD)
+{
+	Agent.LOD = LOD;
+
+	// reset the cooldown too, so agents returning to full rate tick on this frame instead of at the end of their old interval
+	if (UActorComponent* StateTree = Agent.StateTree.Get())
+	{
+		StateTree->SetComponentTickIntervalAndCooldown(Agent.Policy.GetTickInterval(LOD));
+	}
+}
+
+void UBdozawaTickLODSubsystem::OnWorldPreActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds)
+{
+	// the delegate is global, so ignore other worlds
+	if (InWorld == GetWorld())
+	{
+		UpdateLODs();
+	}
+}
+
+void UBdozawaTickLODSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// make sure the proximity subsystem exists. Its distances are refreshed on demand when we update
+	Collection.InitializeDependency<UBdozawaProximitySubsystem>();
+
+	PreActorTickHandle = FWorldDelegates::OnWorldPreActorTick.AddUObject(this, &UBdozawaTickLODSubsystem::OnWorldPreActorTick);
+}
+
+void UBdozawaTickLODSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPreActorTick.Remove(PreActorTickHandle);
+
+	Agents.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UBdozawaTickLODSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
@@ -0,0 +1,156 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "BdozawaTickLODSubsystem.generated.h"
+
+class AController;
+class APawn;
+class UActorComponent;
+class UBdozawaProximitySubsystem;
+
+/**
+ *  Rate an AI agent's StateTree ticks at
+ */
+UENUM(BlueprintType)
+enum class EBdozawaTickLOD : uint8
+{
+	Full,
+	Reduced,
+	Minimal
+};
+
+/**
+ *  Picks an AI agent's StateTree tick rate from its distance to the nearest player and whether it's been rendered recently
+ */
+USTRUCT(BlueprintType)
+struct FBdozawaTickLODPolicy
+{
+	GENERATED_BODY()
+
+	/** If false, the StateTree always ticks every frame */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Tick LOD")
+	bool bEnabled = true;
+
+	/** Tick LOD for agents in the near proximity band. Near agents ignore the off screen LOD */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Tick LOD")
+	EBdozawaTickLOD NearLOD = EBdozawaTickLOD::Full;
+
+	/** Tick LOD for agents in the mid proximity band */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Tick LOD")
+	EBdozawaTickLOD MidLOD = EBdozawaTickLOD::Full;
+
+	/** Tick LOD for agents in the far proximity band */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Tick LOD")
+	EBdozawaTickLOD FarLOD = EBdozawaTickLOD::Reduced;
+
+	/** Tick LOD for agents outside of all proximity bands */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Tick LOD")
+	EBdozawaTickLOD OutsideLOD = EBdozawaTickLOD::Minimal;
+
+	/** Agents that haven't been rendered recently tick at this LOD or lower */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Tick LOD")
+	EBdozawaTickLOD OffScreenLOD = EBdozawaTickLOD::Reduced;
+
+	/** Tick rate of the reduced LOD */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Tick LOD", meta = (ClampMin = 0.1, ClampMax = 60, Units="Hz"))
+	float ReducedTickRate = 10.0f;
+
+	/** Tick rate of the minimal LOD */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Tick LOD", meta = (ClampMin = 0.1, ClampMax = 60, Units="Hz"))
+	float MinimalTickRate = 2.0f;
+
+	/** Agents not rendered for this long are considered off screen */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Tick LOD", meta = (ClampMin = 0, ClampMax = 10, Units="s"))
+	float OffScreenTime = 0.5f;
+
+	/** Time an agent keeps ticking at full rate after it's damaged or interacted with */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Tick LOD", meta = (ClampMin = 0, ClampMax = 30, Units="s"))
+	float BoostTime = 3.0f;
+
+	/** Returns the tick interval for a LOD */
+	float GetTickInterval(EBdozawaTickLOD LOD) const;
+};
+
+/**
+ *  Lowers the StateTree tick rate of AI agents far away from or out of view of the players.
+ *  LODs are picked once per frame from the proximity subsystem's range bands, before any actors tick.
+ *  Components with a tick interval receive the time accumulated since their last tick, so tasks still see the correct DeltaTime.
+ */
+UCLASS()
+class UBdozawaTickLODSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** A registered AI agent */
+	struct FTickLODAgent
+	{
+		/** Controller running the StateTree */
+		TWeakObjectPtr<AController> Controller;
+
+		/** Component ticking the StateTree */
+		TWeakObjectPtr<UActorComponent> StateTree;
+
+		/** LOD policy */
+		FBdozawaTickLODPolicy Policy;
+
+		/** Current LOD */
+		EBdozawaTickLOD LOD = EBdozawaTickLOD::Full;
+
+		/** Highest LOD allowed by the agent's significance */
+		EBdozawaTickLOD MinimumLOD = EBdozawaTickLOD::Full;
+
+		/** World time until which the agent ticks at full rate */
+		double BoostEndTime = 0.0;
+	};
+
+	/** All registered agents */
+	TArray<FTickLODAgent> Agents;
+
+	/** Pre actor tick delegate handle */
+	FDelegateHandle PreActorTickHandle;
+
+public:
+
+	/** Starts applying the LOD policy to a controller's StateTree component */
+	void RegisterAgent(AController* Controller, UActorComponent* StateTree, const FBdozawaTickLODPolicy& Policy);
+
+	/** Stops applying the LOD policy to a controller and restores its full tick rate */
+	void UnregisterAgent(AController* Controller);
+
+	/** Caps the tick rate of a controller's StateTree at the given LOD, regardless of its distance to the players */
+	void SetMinimumLOD(const AController* Controller, EBdozawaTickLOD MinimumLOD);
+
+	/** Makes the agent controlling the pawn tick at full rate right away, and keeps it there for the policy's boost time */
+	void BoostAgent(const APawn* Pawn);
+
+	/** Returns true if tick LODs are enabled */
+	static bool IsTickLODEnabled();
+
+protected:
+
+	/** Picks the LOD of every agent and updates their tick intervals */
+	void UpdateLODs();
+
+	/** Picks an agent's LOD */
+	EBdozawaTickLOD ChooseLOD(const FTickLODAgent& Agent, const UBdozawaProximitySubsystem* Proximity, double WorldTime) const;
+
+	/** Sets an agent's LOD and updates its tick interval */
+	static void ApplyLOD(FTickLODAgent& Agent, EBdozawaTickLOD LOD);
+
+	/** Picks the LODs before any actors tick */
+	void OnWorldPreActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds);
+
+public:
+
+	// ~begin USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	// ~end USubsystem interface
+
+	// ~begin UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	// ~end UWorldSubsystem interface
+};
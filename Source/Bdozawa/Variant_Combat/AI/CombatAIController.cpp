@@ -3,6 +3,7 @@
 
 #include "CombatAIController.h"
 #include "Components/StateTreeAIComponent.h"
+#include "Engine/World.h"
 
 ACombatAIController::ACombatAIController()
 {
@@ -17,3 +18,49 @@ ACombatAIController::ACombatAIController()
 	// this is necessary for EnvQueries to work correctly
 	bAttachToPawn = true;
 }
+
+void ACombatAIController::OnPossess(APawn* InPawn)
+{
+	Super::OnPossess(InPawn);
+
+	// tick the StateTree less often while the pawn is far away from the player
+	if (UBdozawaTickLODSubsystem* TickLOD = GetWorld()->GetSubsystem<UBdozawaTickLODSubsystem>())
+	{
+		TickLOD->RegisterAgent(this, StateTreeAI, TickLODPolicy);
+	}
+
+	// check the pawn's line of sight to the player and send the changes to the StateTree
+	SetPerceptionEnabled(true);
+}
+
+void ACombatAIController::OnUnPossess()
+{
+	// restore the full StateTree tick rate
+	if (UBdozawaTickLODSubsystem* TickLOD = GetWorld()->GetSubsystem<UBdozawaTickLODSubsystem>())
+	{
+		TickLOD->UnregisterAgent(this);
+	}
+
+	// stop checking the pawn's line of sight
+	SetPerceptionEnabled(false);
+
+	Super::OnUnPossess();
+}
+
+void ACombatAIController::SetPerceptionEnabled(bool bEnabled)
+{
+	UBdozawaPerceptionSubsystem* Perception = GetWorld()->GetSubsystem<UBdozawaPerceptionSubsystem>();
+
+	if (!Perception)
+	{
+		return;
+	}
+
+	// drop the old observer along with its cached result
+	Perception->UnregisterObserver(PerceptionHandle);
+
+	if (bEnabled && SightSettings.bEnabled && GetPawn())
+	{
+		PerceptionHandle = Perception->RegisterObserver(GetPawn(), StateTreeAI, SightSettings);
+	}
+}
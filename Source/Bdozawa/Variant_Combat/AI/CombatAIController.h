@@ -4,6 +4,8 @@
 
 #include "CoreMinimal.h"
 #include "AIController.h"
+#include "BdozawaTickLODSubsystem.h"
+#include "BdozawaPerceptionSubsystem.h"
 #include "CombatAIController.generated.h"
 
 class UStateTreeAIComponent;
@@ -20,8 +22,35 @@ class ACombatAIController : public AAIController
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components", meta = (AllowPrivateAccess = "true"))
 	UStateTreeAIComponent* StateTreeAI;
 
+protected:
+
+	/** Lowers the StateTree tick rate while the possessed pawn is far away from or out of view of the player */
+	UPROPERTY(EditAnywhere, Category="Tick LOD")
+	FBdozawaTickLODPolicy TickLODPolicy;
+
+	/** Line of sight settings used to perceive the player. Changes in sight are sent to the StateTree as events */
+	UPROPERTY(EditAnywhere, Category="Perception")
+	FBdozawaSightSettings SightSettings;
+
+	/** Handle to the possessed pawn's perception observer */
+	int32 PerceptionHandle = INDEX_NONE;
+
 public:
 
 	/** Constructor */
 	ACombatAIController();
+
+	/** Returns the handle to the possessed pawn's perception observer, or INDEX_NONE if it's not perceiving */
+	int32 GetPerceptionHandle() const { return PerceptionHandle; }
+
+	/** Starts or stops checking the possessed pawn's line of sight. Starting again resets the cached result, so the StateTree receives a fresh seen or lost event */
+	void SetPerceptionEnabled(bool bEnabled);
+
+protected:
+
+	/** Starts applying the tick LOD policy to the StateTree and starts perceiving the player */
+	virtual void OnPossess(APawn* InPawn) override;
+
+	/** Stops applying the tick LOD policy to the StateTree and stops perceiving the player */
+	virtual void OnUnPossess() override;
 };
@@ -8,9 +8,27 @@
 #include "Components/WidgetComponent.h"
 #include "Engine/DamageEvents.h"
 #include "CombatLifeBar.h"
+#include "CombatLifeBarSubsystem.h"
+#include "CombatLifeBarPool.h"
+#include "CombatEnemyPool.h"
+#include "BrainComponent.h"
 #include "TimerManager.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "Animation/AnimInstance.h"
+#include "CombatBroadphaseSubsystem.h"
+#include "CombatSimulationSubsystem.h"
+#include "BdozawaProximitySubsystem.h"
+#include "BdozawaTickLODSubsystem.h"
+#include "BdozawaSignificanceSubsystem.h"
+#include "CombatFactionComponent.h"
+#include "CombatHurtboxComponent.h"
+#include "CombatAttackTimelineComponent.h"
+#include "CombatMeleeComponent.h"
+#include "CombatStats.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Enemy BeginPlay"), STAT_CombatEnemyBeginPlay, STATGROUP_Combat);
 
 ACombatEnemy::ACombatEnemy()
 {
@@ -32,6 +50,23 @@ ACombatEnemy::ACombatEnemy()
 	LifeBar = CreateDefaultSubobject<UWidgetComponent>(TEXT("LifeBar"));
 	LifeBar->SetupAttachment(RootComponent);
 
+	// create the faction component. Enemies only damage players by default
+	Faction = CreateDefaultSubobject<UCombatFactionComponent>(TEXT("Faction"));
+	Faction->SetFaction(ECombatFaction::Enemy, ECombatFaction::Player);
+
+	// create the hurtbox component
+	Hurtbox = CreateDefaultSubobject<UCombatHurtboxComponent>(TEXT("Hurtbox"));
+
+	// create the attack timeline component
+	AttackTimeline = CreateDefaultSubobject<UCombatAttackTimelineComponent>(TEXT("AttackTimeline"));
+
+	// create the melee component
+	Melee = CreateDefaultSubobject<UCombatMeleeComponent>(TEXT("Melee"));
+	Melee->SetPolicy(ECombatMeleePolicy::Enemy);
+	Melee->MeleeTraceRadius = 50.0f;
+	Melee->MeleeKnockbackImpulse = 150.0f;
+	Melee->MeleeLaunchImpulse = 350.0f;
+
 	// set the collision capsule size
 	GetCapsuleComponent()->SetCapsuleSize(35.0f, 90.0f);
 
@@ -44,147 +79,231 @@ ACombatEnemy::ACombatEnemy()
 
 void ACombatEnemy::DoAIComboAttack()
 {
+	FCombatSimulation& Simulation = GetCombatSimulation();
+
 	// ignore if we're already playing an attack animation
-	if (bIsAttacking)
+	if (Simulation.IsAttacking(CombatantIndex))
 	{
 		return;
 	}
 
-	// raise the attacking flag
-	bIsAttacking = true;
+	// the attack assets are streamed in asynchronously, so skip the attack if they haven't arrived yet
+	UAnimMontage* Montage = ComboAttackMontage.Get();
+	UCombatAttackTimeline* Timeline = ComboAttackTimeline.Get();
 
-	// choose how many times we're going to attack
-	TargetComboCount = FMath::RandRange(1, ComboSectionNames.Num() - 1);
+	if (!Montage)
+	{
+		OnAttackCompleted.ExecuteIfBound();
+		return;
+	}
 
-	// reset the attack counter
-	CurrentComboAttack = 0;
+	// raise the attacking flag, reset the attack counter and choose how many times we're going to attack
+	Simulation.StartComboAttack(CombatantIndex, FMath::RandRange(1, ComboSectionNames.Num() - 1));
 
 	// play the attack montage
 	if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
 	{
-		const float MontageLength = AnimInstance->Montage_Play(ComboAttackMontage, 1.0f, EMontagePlayReturnType::MontageLength, 0.0f, true);
+		const float MontageLength = AnimInstance->Montage_Play(Montage, 1.0f, EMontagePlayReturnType::MontageLength, 0.0f, true);
 
-		// subscribe to montage completed and interrupted events
-		if (MontageLength > 0.0f)
+		// subscribe to montage completed and interrupted events, unless the attack timeline is driving the attack
+		if (MontageLength > 0.0f && !Timeline)
 		{
 			// set the end delegate for the montage
-			AnimInstance->Montage_SetEndDelegate(OnAttackMontageEnded, ComboAttackMontage);
+			AnimInstance->Montage_SetEndDelegate(OnAttackMontageEnded, Montage);
 		}
 	}
+
+	// run the attack timing from the timeline if we have one
+	if (Timeline)
+	{
+		AttackTimeline->Play(Timeline);
+	}
 }
 
 void ACombatEnemy::DoAIChargedAttack()
 {
+	FCombatSimulation& Simulation = GetCombatSimulation();
+
 	// ignore if we're already playing an attack animation
-	if (bIsAttacking)
+	if (Simulation.IsAttacking(CombatantIndex))
 	{
 		return;
 	}
 
-	// raise the attacking flag
-	bIsAttacking = true;
+	// the attack assets are streamed in asynchronously, so skip the attack if they haven't arrived yet
+	UAnimMontage* Montage = ChargedAttackMontage.Get();
+	UCombatAttackTimeline* Timeline = ChargedAttackTimeline.Get();
 
-	// choose how many loops are we going to charge for
-	TargetChargeLoops = FMath::RandRange(MinChargeLoops, MaxChargeLoops);
+	if (!Montage)
+	{
+		OnAttackCompleted.ExecuteIfBound();
+		return;
+	}
 
-	// reset the charge loop counter
-	CurrentChargeLoop = 0;
+	// raise the attacking flag, reset the charge loop counter and choose how many loops are we going to charge for
+	Simulation.StartChargedAttack(CombatantIndex, FMath::RandRange(MinChargeLoops, MaxChargeLoops));
 
 	// play the attack montage
 	if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
 	{
-		const float MontageLength = AnimInstance->Montage_Play(ChargedAttackMontage, 1.0f, EMontagePlayReturnType::MontageLength, 0.0f, true);
+		const float MontageLength = AnimInstance->Montage_Play(Montage, 1.0f, EMontagePlayReturnType::MontageLength, 0.0f, true);
 
-		// subscribe to montage completed and interrupted events
-		if (MontageLength > 0.0f)
+		// subscribe to montage completed and interrupted events, unless the attack timeline is driving the attack
+		if (MontageLength > 0.0f && !Timeline)
 		{
 			// set the end delegate for the montage
-			AnimInstance->Montage_SetEndDelegate(OnAttackMontageEnded, ChargedAttackMontage);
+			AnimInstance->Montage_SetEndDelegate(OnAttackMontageEnded, Montage);
 		}
 	}
+
+	// run the attack timing from the timeline if we have one
+	if (Timeline)
+	{
+		AttackTimeline->Play(Timeline);
+	}
 }
 
 void ACombatEnemy::AttackMontageEnded(UAnimMontage* Montage, bool bInterrupted)
 {
 	// reset the attacking flag
-	bIsAttacking = false;
+	GetCombatSimulation().EndAttack(CombatantIndex);
 
 	// call the attack completed delegate so the StateTree can continue execution
 	OnAttackCompleted.ExecuteIfBound();
 }
 
-void ACombatEnemy::DoAttackTrace(FName DamageSourceBone)
+void ACombatEnemy::AttackTimelineEnded(bool bInterrupted)
+{
+	// the timeline owns the attack timing, so treat its end like the end of the attack montage
+	AttackMontageEnded(nullptr, bInterrupted);
+}
+
+void ACombatEnemy::JumpToAttackSection(UAnimMontage* Montage, FName SectionName)
 {
-	// sweep for objects in front of the character to be hit by the attack
-	TArray<FHitResult> OutHits;
+	// jump the montage to the section so the animation stays in sync
+	if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
+	{
+		AnimInstance->Montage_JumpToSection(SectionName, Montage);
+	}
+
+	// jump the timeline too if it's driving the attack
+	if (AttackTimeline->IsPlaying())
+	{
+		AttackTimeline->JumpToSection(SectionName);
+	}
+}
+
+void ACombatEnemy::SetLifeBarPercentage(float Percent)
+{
+	if (LifeBarWidget)
+	{
+		LifeBarWidget->SetLifePercentage(Percent);
+
+	} else if (UCombatLifeBarSubsystem* LifeBars = GetWorld()->GetSubsystem<UCombatLifeBarSubsystem>()) {
+
+		LifeBars->SetLifePercentage(LifeBarHandle, Percent);
+	}
+}
 
-	// start at the provided socket location, sweep forward
-	const FVector TraceStart = GetMesh()->GetSocketLocation(DamageSourceBone);
-	const FVector TraceEnd = TraceStart + (GetActorForwardVector() * MeleeTraceDistance);
+void ACombatEnemy::HideLifeBar()
+{
+	LifeBar->SetHiddenInGame(true);
 
-	// enemies only affect Pawn collision objects; they don't knock back boxes
-	FCollisionObjectQueryParams ObjectParams;
-	ObjectParams.AddObjectTypesToQuery(ECC_Pawn);
+	if (UCombatLifeBarSubsystem* LifeBars = GetWorld()->GetSubsystem<UCombatLifeBarSubsystem>())
+	{
+		LifeBars->SetLifeBarVisible(LifeBarHandle, false);
+	}
+}
 
-	// use a sphere shape for the sweep
-	FCollisionShape CollisionShape;
-	CollisionShape.SetSphere(MeleeTraceRadius);
+void ACombatEnemy::AcquirePooledLifeBar()
+{
+	if (!PooledLifeBarClass || LifeBarWidget)
+	{
+		return;
+	}
 
-	// ignore self
-	FCollisionQueryParams QueryParams;
-	QueryParams.AddIgnoredActor(this);
+	if (UCombatLifeBarPool* Pool = GetWorld()->GetSubsystem<UCombatLifeBarPool>())
+	{
+		LifeBarWidget = Pool->AcquireLifeBar(LifeBar, PooledLifeBarClass);
+	}
+}
 
-	if (GetWorld()->SweepMultiByObjectType(OutHits, TraceStart, TraceEnd, FQuat::Identity, ObjectParams, CollisionShape, QueryParams))
+void ACombatEnemy::ReleasePooledLifeBar()
+{
+	if (!PooledLifeBarClass)
 	{
-		// iterate over each object hit
-		for (const FHitResult& CurrentHit : OutHits)
-		{
-			/** does the actor have the player tag? */
-			if (CurrentHit.GetActor()->ActorHasTag(FName("Player")))
-			{
-				// check if the actor is damageable
-				ICombatDamageable* Damageable = Cast<ICombatDamageable>(CurrentHit.GetActor());
+		return;
+	}
 
-				if (Damageable)
-				{
-					// knock upwards and away from the impact normal
-					const FVector Impulse = (CurrentHit.ImpactNormal * -MeleeKnockbackImpulse) + (FVector::UpVector * MeleeLaunchImpulse);
+	// the widget may have been assigned by the pool on our first rendered frame, so always release through the component
+	if (UCombatLifeBarPool* Pool = GetWorld()->GetSubsystem<UCombatLifeBarPool>())
+	{
+		Pool->ReleaseLifeBar(LifeBar);
+	}
 
-					// pass the damage event to the actor
-					Damageable->ApplyDamage(MeleeDamage, this, CurrentHit.ImpactPoint, Impulse);
+	LifeBarWidget = nullptr;
+}
 
-				}
-			}
+void ACombatEnemy::GetAttackAssetPaths(TArray<FSoftObjectPath>& OutPaths) const
+{
+	for (const FSoftObjectPath& Path : { ComboAttackMontage.ToSoftObjectPath(), ComboAttackTimeline.ToSoftObjectPath(), ChargedAttackMontage.ToSoftObjectPath(), ChargedAttackTimeline.ToSoftObjectPath() })
+	{
+		if (Path.IsValid())
+		{
+			OutPaths.Add(Path);
 		}
 	}
 }
 
+bool ACombatEnemy::IsAttackTimelineActive() const
+{
+	return AttackTimeline->IsPlaying();
+}
+
+void ACombatEnemy::DoAttackTrace(FName DamageSourceBone)
+{
+	// ignore notifies queued before we left combat, e.g. when parked in the enemy pool on the same frame
+	if (CombatantIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	// pass the attack to the melee component
+	Melee->DoAttackTrace(DamageSourceBone);
+}
+
 void ACombatEnemy::CheckCombo()
 {
+	// ignore notifies queued before we left combat, e.g. when parked in the enemy pool on the same frame
+	if (CombatantIndex == INDEX_NONE)
+	{
+		return;
+	}
+
 	// increase the combo counter
-	++CurrentComboAttack;
+	const int32 NextComboSection = GetCombatSimulation().CheckCombo(CombatantIndex);
 
 	// do we still have attacks to play in this string?
-	if (CurrentComboAttack < TargetComboCount)
+	if (ComboSectionNames.IsValidIndex(NextComboSection))
 	{
 		// jump to the next attack section
-		if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
-		{
-			AnimInstance->Montage_JumpToSection(ComboSectionNames[CurrentComboAttack], ComboAttackMontage);
-		}
+		JumpToAttackSection(ComboAttackMontage.Get(), ComboSectionNames[NextComboSection]);
 	}
 }
 
 void ACombatEnemy::CheckChargedAttack()
 {
-	// increase the charge loop counter
-	++CurrentChargeLoop;
-
-	// jump to either the loop or attack section of the montage depending on whether we hit the loop target
-	if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
+	// ignore notifies queued before we left combat, e.g. when parked in the enemy pool on the same frame
+	if (CombatantIndex == INDEX_NONE)
 	{
-		AnimInstance->Montage_JumpToSection(CurrentChargeLoop >= TargetChargeLoops ? ChargeAttackSection : ChargeLoopSection, ChargedAttackMontage);
+		return;
 	}
+
+	// increase the charge loop counter and check if we hit the loop target
+	const bool bKeepCharging = GetCombatSimulation().CheckChargedAttack(CombatantIndex);
+
+	// jump to either the loop or attack section of the montage
+	JumpToAttackSection(ChargedAttackMontage.Get(), bKeepCharging ? ChargeLoopSection : ChargeAttackSection);
 }
 
 void ACombatEnemy::ApplyDamage(float Damage, AActor* DamageCauser, const FVector& DamageLocation, const FVector& DamageImpulse)
@@ -210,8 +329,17 @@ void ACombatEnemy::ApplyDamage(float Damage, AActor* DamageCauser, const FVector
 		// stop the attack montages to interrupt the attack
 		if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
 		{
-			AnimInstance->Montage_Stop(0.1f, ComboAttackMontage);
-			AnimInstance->Montage_Stop(0.1f, ChargedAttackMontage);
+			AnimInstance->Montage_Stop(0.1f, ComboAttackMontage.Get());
+			AnimInstance->Montage_Stop(0.1f, ChargedAttackMontage.Get());
+		}
+
+		// stop the attack timeline too, since it may be the one driving the attack
+		AttackTimeline->Stop();
+
+		// make the StateTree react at full rate even if we were hit from far away or off screen
+		if (UBdozawaTickLODSubsystem* TickLOD = GetWorld()->GetSubsystem<UBdozawaTickLODSubsystem>())
+		{
+			TickLOD->BoostAgent(this);
 		}
 
 		// pass control to BP to play effects, etc.
@@ -221,15 +349,23 @@ void ACombatEnemy::ApplyDamage(float Damage, AActor* DamageCauser, const FVector
 
 void ACombatEnemy::HandleDeath()
 {
-	// hide the life bar
-	LifeBar->SetHiddenInGame(true);
+	// hide the life bar and return its widget to the pool
+	HideLifeBar();
+	ReleasePooledLifeBar();
 
-	// disable the collision capsule to avoid being hit again while dead
+	// disable the collision capsule and hurtboxes to avoid being hit again while dead
 	GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Hurtbox->SetHurtboxesEnabled(false);
 
 	// disable character movement
 	GetCharacterMovement()->DisableMovement();
 
+	// dead enemies don't need to look for the player
+	if (ACombatAIController* AIController = Cast<ACombatAIController>(GetController()))
+	{
+		AIController->SetPerceptionEnabled(false);
+	}
+
 	// enable full ragdoll physics
 	GetMesh()->SetSimulatePhysics(true);
 
@@ -247,31 +383,308 @@ void ACombatEnemy::ApplyHealing(float Healing, AActor* Healer)
 
 void ACombatEnemy::RemoveFromLevel()
 {
+	// park this actor so it can be reused by a spawner
+	if (UCombatEnemyPool::IsPoolingEnabled())
+	{
+		if (UCombatEnemyPool* EnemyPool = GetWorld()->GetSubsystem<UCombatEnemyPool>())
+		{
+			EnemyPool->ReleaseEnemy(this);
+			return;
+		}
+	}
+
+	// return the life bar widget to the pool
+	ReleasePooledLifeBar();
+
 	// destroy this actor
 	Destroy();
 }
 
+void ACombatEnemy::RestoreHP(float HP)
+{
+	FCombatSimulation& Simulation = GetCombatSimulation();
+
+	Simulation.SetHP(CombatantIndex, HP);
+	CurrentHP = Simulation.GetHP(CombatantIndex);
+
+	SetLifeBarPercentage(Simulation.GetHPPercentage(CombatantIndex));
+}
+
+FCombatSimulation& ACombatEnemy::GetCombatSimulation() const
+{
+	return GetWorld()->GetSubsystem<UCombatSimulationSubsystem>()->GetSimulation();
+}
+
+void ACombatEnemy::AddToCombat()
+{
+	// add the enemy to the combat simulation at full HP
+	FCombatSimulation& Simulation = GetCombatSimulation();
+	CombatantIndex = Simulation.AddCombatant(MaxHP, ComboSectionNames.Num(), true);
+
+	// reset HP to maximum
+	CurrentHP = Simulation.GetHP(CombatantIndex);
+
+	// add the enemy to the combat broadphase
+	if (UCombatBroadphaseSubsystem* Broadphase = GetWorld()->GetSubsystem<UCombatBroadphaseSubsystem>())
+	{
+		Broadphase->RegisterDamageable(this, GetCapsuleComponent());
+	}
+
+	// add the hurtbox shapes back if we're being reused from the enemy pool. On BeginPlay the hurtbox registers them itself once they're created
+	Hurtbox->RegisterWithBroadphase();
+
+	// start tracking the distance to the player
+	if (UBdozawaProximitySubsystem* ProximitySubsystem = GetWorld()->GetSubsystem<UBdozawaProximitySubsystem>())
+	{
+		ProximityHandle = ProximitySubsystem->RegisterAgent(this);
+	}
+
+	// start ranking our significance
+	if (UBdozawaSignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UBdozawaSignificanceSubsystem>())
+	{
+		Significance->RegisterAgent(this, SignificanceSettings);
+	}
+}
+
+void ACombatEnemy::RemoveFromCombat()
+{
+	// remove the enemy from the combat simulation
+	if (UCombatSimulationSubsystem* SimulationSubsystem = GetWorld()->GetSubsystem<UCombatSimulationSubsystem>())
+	{
+		SimulationSubsystem->GetSimulation().RemoveCombatant(CombatantIndex);
+		CombatantIndex = INDEX_NONE;
+	}
+
+	// remove the enemy and its hurtbox shapes from the combat broadphase
+	Hurtbox->UnregisterFromBroadphase();
+
+	if (UCombatBroadphaseSubsystem* Broadphase = GetWorld()->GetSubsystem<UCombatBroadphaseSubsystem>())
+	{
+		Broadphase->UnregisterDamageable(this);
+	}
+
+	// stop tracking the distance to the player
+	if (UBdozawaProximitySubsystem* ProximitySubsystem = GetWorld()->GetSubsystem<UBdozawaProximitySubsystem>())
+	{
+		ProximitySubsystem->UnregisterAgent(ProximityHandle);
+	}
+
+	// stop ranking our significance. We come back at high significance, so drop the low significance state
+	if (UBdozawaSignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UBdozawaSignificanceSubsystem>())
+	{
+		Significance->UnregisterAgent(this);
+	}
+
+	bLifeBarCulled = false;
+	LastDamageTime = -1.0;
+	SetMeshCollisionSimplified(false);
+}
+
+void ACombatEnemy::SetMeshCollisionSimplified(bool bSimplified)
+{
+	if (bMeshCollisionSimplified == bSimplified)
+	{
+		return;
+	}
+
+	bMeshCollisionSimplified = bSimplified;
+
+	GetMesh()->SetCollisionEnabled(bSimplified ? ECollisionEnabled::NoCollision : MeshCollisionEnabled.GetValue());
+}
+
+bool ACombatEnemy::IsEngaged() const
+{
+	if (CombatantIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	// attacking, or hit recently
+	return GetCombatSimulation().IsAttacking(CombatantIndex) || (LastDamageTime >= 0.0 && GetWorld()->GetTimeSeconds() - LastDamageTime < EngagedTime);
+}
+
+void ACombatEnemy::ApplySignificanceLOD(const FBdozawaSignificanceLOD& LOD)
+{
+	// leave dead enemies alone, their life bar is gone and their ragdoll needs collision
+	if (CombatantIndex == INDEX_NONE || !GetCombatSimulation().IsAlive(CombatantIndex))
+	{
+		return;
+	}
+
+	// show or hide the life bar
+	if (bLifeBarCulled == LOD.bShowLifeBar)
+	{
+		bLifeBarCulled = !LOD.bShowLifeBar;
+
+		if (LifeBarHandle != INDEX_NONE)
+		{
+			if (UCombatLifeBarSubsystem* LifeBars = GetWorld()->GetSubsystem<UCombatLifeBarSubsystem>())
+			{
+				LifeBars->SetLifeBarVisible(LifeBarHandle, LOD.bShowLifeBar);
+			}
+
+		} else {
+
+			LifeBar->SetHiddenInGame(!LOD.bShowLifeBar);
+		}
+	}
+
+	SetMeshCollisionSimplified(!LOD.bDetailedCollision);
+}
+
+void ACombatEnemy::ParkInPool()
+{
+	bParked = true;
+
+	// clear the death timer
+	GetWorld()->GetTimerManager().ClearTimer(DeathTimer);
+
+	// stop running the StateTree
+	if (AAIController* AIController = Cast<AAIController>(GetController()))
+	{
+		if (UBrainComponent* Brain = AIController->GetBrainComponent())
+		{
+			Brain->StopLogic(TEXT("Parked in the enemy pool"));
+		}
+	}
+
+	// stop looking for the player. Reuse starts with a fresh sight result
+	if (ACombatAIController* AIController = Cast<ACombatAIController>(GetController()))
+	{
+		AIController->SetPerceptionEnabled(false);
+	}
+
+	// stop any attack in progress
+	AttackTimeline->Stop();
+
+	if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
+	{
+		AnimInstance->StopAllMontages(0.0f);
+	}
+
+	// drop subscribers from our previous life. Spawners and StateTree tasks bind again on reuse
+	OnEnemyDied.Clear();
+	OnAttackCompleted.Unbind();
+	OnEnemyLanded.Unbind();
+
+	// leave the combat systems. Enemies parked while alive, e.g. by a checkpoint restore, still show their life bar
+	RemoveFromCombat();
+	HideLifeBar();
+	ReleasePooledLifeBar();
+
+	// put the mesh back on the capsule with ragdoll physics off
+	GetMesh()->SetSimulatePhysics(false);
+	GetMesh()->SetPhysicsBlendWeight(0.0f);
+	GetMesh()->AttachToComponent(GetCapsuleComponent(), FAttachmentTransformRules::SnapToTargetNotIncludingScale);
+	GetMesh()->SetRelativeLocationAndRotation(GetBaseTranslationOffset(), GetBaseRotationOffset());
+
+	// stop moving
+	GetCharacterMovement()->StopMovementImmediately();
+	GetCharacterMovement()->DisableMovement();
+
+	// hide the actor and stop it from ticking or colliding while parked
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	SetActorTickEnabled(false);
+	GetMesh()->SetComponentTickEnabled(false);
+	GetCharacterMovement()->SetComponentTickEnabled(false);
+}
+
+void ACombatEnemy::ActivateFromPool(const FTransform& SpawnTransform)
+{
+	bParked = false;
+
+	// move to the spawn point
+	SetActorLocationAndRotation(SpawnTransform.GetLocation(), SpawnTransform.GetRotation(), false, nullptr, ETeleportType::ResetPhysics);
+
+	// show the actor and restore its collision, ticking and movement
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+	SetActorTickEnabled(true);
+	GetMesh()->SetComponentTickEnabled(true);
+	GetCharacterMovement()->SetComponentTickEnabled(true);
+
+	GetCapsuleComponent()->SetCollisionEnabled(CapsuleCollisionEnabled);
+	Hurtbox->SetHurtboxesEnabled(true);
+	GetCharacterMovement()->SetDefaultMovementMode();
+
+	// rejoin the combat systems at full HP
+	AddToCombat();
+
+	// show and fill the life bar again
+	if (LifeBarHandle != INDEX_NONE)
+	{
+		if (UCombatLifeBarSubsystem* LifeBars = GetWorld()->GetSubsystem<UCombatLifeBarSubsystem>())
+		{
+			LifeBars->SetLifeBarVisible(LifeBarHandle, true);
+		}
+
+	} else {
+
+		LifeBar->SetHiddenInGame(false);
+
+		if (PooledLifeBarClass)
+		{
+			if (UCombatLifeBarPool* Pool = GetWorld()->GetSubsystem<UCombatLifeBarPool>())
+			{
+				Pool->AddPendingLifeBar(LifeBar, PooledLifeBarClass);
+			}
+		}
+	}
+
+	SetLifeBarPercentage(1.0f);
+
+	// restart the StateTree now that HP is topped up
+	if (AAIController* AIController = Cast<AAIController>(GetController()))
+	{
+		if (UBrainComponent* Brain = AIController->GetBrainComponent())
+		{
+			Brain->RestartLogic();
+		}
+	}
+
+	// look for the player again. The fresh observer sends the new StateTree a seen event as soon as the player is in sight
+	if (ACombatAIController* AIController = Cast<ACombatAIController>(GetController()))
+	{
+		AIController->SetPerceptionEnabled(true);
+	}
+}
+
 float ACombatEnemy::TakeDamage(float Damage, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
 {
+	// ignore damage that arrives after we've left combat, e.g. while parked in the enemy pool
+	if (CombatantIndex == INDEX_NONE)
+	{
+		return 0.0f;
+	}
+
+	FCombatSimulation& Simulation = GetCombatSimulation();
+
 	// only process damage if the character is still alive
-	if (CurrentHP <= 0.0f)
+	if (!Simulation.IsAlive(CombatantIndex))
 	{
 		return 0.0f;
 	}
 
 	// reduce the current HP
-	CurrentHP -= Damage;
+	const FCombatDamageResult Result = Simulation.ApplyDamage(CombatantIndex, Damage);
+	CurrentHP = Simulation.GetHP(CombatantIndex);
+
+	// we're engaged with the player for a while. The ragdoll below also needs the mesh collision
+	LastDamageTime = GetWorld()->GetTimeSeconds();
+	SetMeshCollisionSimplified(false);
 
 	// have we run out of HP?
-	if (CurrentHP <= 0.0f)
+	if (Result.bKilled)
 	{
 		// die
 		HandleDeath();
 	}
 	else
 	{
-		// update the life bar
-		LifeBarWidget->SetLifePercentage(CurrentHP / MaxHP);
+		// update the life bar, creating its widget if this is our first damage
+		AcquirePooledLifeBar();
+		SetLifeBarPercentage(Simulation.GetHPPercentage(CombatantIndex));
 
 		// enable partial ragdoll physics, but keep the pelvis vertical
 		GetMesh()->SetPhysicsBlendWeight(0.5f);
@@ -279,7 +692,7 @@ float ACombatEnemy::TakeDamage(float Damage, struct FDamageEvent const& DamageEv
 	}
 
 	// return the received damage amount
-	return Damage;
+	return Result.ActualDamage;
 }
 
 void ACombatEnemy::Landed(const FHitResult& Hit)
@@ -297,26 +710,135 @@ void ACombatEnemy::Landed(const FHitResult& Hit)
 	OnEnemyLanded.ExecuteIfBound();
 }
 
+void ACombatEnemy::PostLoad()
+{
+	Super::PostLoad();
+
+#if WITH_EDITORONLY_DATA
+	// copy the melee tuning saved before it moved to the Melee component.
+	// Deprecated values still at their old defaults weren't overridden, so they leave the component alone
+	const ACombatEnemy* Defaults = GetDefault<ACombatEnemy>();
+
+	if (Melee && Defaults != this)
+	{
+		auto Migrate = [](auto DeprecatedValue, auto DefaultValue, auto& ComponentValue)
+		{
+			if (DeprecatedValue != DefaultValue)
+			{
+				ComponentValue = DeprecatedValue;
+			}
+		};
+
+		Migrate(MeleeTraceDistance_DEPRECATED, Defaults->MeleeTraceDistance_DEPRECATED, Melee->MeleeTraceDistance);
+		Migrate(MeleeTraceRadius_DEPRECATED, Defaults->MeleeTraceRadius_DEPRECATED, Melee->MeleeTraceRadius);
+		Migrate(bUseCombatBroadphase_DEPRECATED, Defaults->bUseCombatBroadphase_DEPRECATED, Melee->bUseCombatBroadphase);
+		Migrate(bTraceHurtboxes_DEPRECATED, Defaults->bTraceHurtboxes_DEPRECATED, Melee->bTraceHurtboxes);
+		Migrate(MeleeDamage_DEPRECATED, Defaults->MeleeDamage_DEPRECATED, Melee->MeleeDamage);
+		Migrate(MeleeKnockbackImpulse_DEPRECATED, Defaults->MeleeKnockbackImpulse_DEPRECATED, Melee->MeleeKnockbackImpulse);
+		Migrate(MeleeLaunchImpulse_DEPRECATED, Defaults->MeleeLaunchImpulse_DEPRECATED, Melee->MeleeLaunchImpulse);
+	}
+#endif // WITH_EDITORONLY_DATA
+}
+
 void ACombatEnemy::BeginPlay()
 {
-	// reset HP to maximum
-	CurrentHP = MaxHP;
+	SCOPE_CYCLE_COUNTER(STAT_CombatEnemyBeginPlay);
+
+	// if all attack timing comes from timelines, the animation is purely cosmetic,
+	// so the pose doesn't need to tick at full rate, or at all while off screen.
+	// This is set before joining combat so significance keeps it as our baseline
+	if (!ComboAttackTimeline.IsNull() && !ChargedAttackTimeline.IsNull())
+	{
+		GetMesh()->bEnableUpdateRateOptimizations = true;
+		GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickPoseWhenRendered;
+	}
+
+	// add the enemy to the combat simulation at full HP
+	AddToCombat();
+
+	// remember the capsule collision, so it can be restored if we're reused from the enemy pool
+	CapsuleCollisionEnabled = GetCapsuleComponent()->GetCollisionEnabled();
+
+	// remember the mesh collision, so it can be restored when we become significant again
+	MeshCollisionEnabled = GetMesh()->GetCollisionEnabled();
+
+	// draw the life bar with the batched life bar overlay. The widget component is only kept as the bar's anchor
+	if (UCombatLifeBarSubsystem::IsBatchingEnabled())
+	{
+		if (UCombatLifeBarSubsystem* LifeBars = GetWorld()->GetSubsystem<UCombatLifeBarSubsystem>())
+		{
+			LifeBarHandle = LifeBars->RegisterLifeBar(LifeBar, LifeBarColor);
+
+			LifeBar->SetWidgetClass(nullptr);
+			LifeBar->SetTickMode(ETickMode::Disabled);
+			LifeBar->SetHiddenInGame(true);
+		}
+
+	} else if (UCombatLifeBarPool::IsPoolingEnabled()) {
+
+		// create the life bar widget lazily from the pool, on our first rendered frame or first damage
+		if (UCombatLifeBarPool* Pool = GetWorld()->GetSubsystem<UCombatLifeBarPool>())
+		{
+			PooledLifeBarClass = LifeBar->GetWidgetClass().Get();
+
+			if (PooledLifeBarClass)
+			{
+				LifeBar->SetWidgetClass(nullptr);
+				Pool->AddPendingLifeBar(LifeBar, PooledLifeBarClass);
+			}
+		}
+	}
 
 	// we top the HP before BeginPlay so StateTree picks it up at the right value
 	Super::BeginPlay();
 
-	// get the life bar widget from the widget comp
-	LifeBarWidget = Cast<UCombatLifeBar>(LifeBar->GetUserWidgetObject());
-	check(LifeBarWidget);
+	// get the life bar widget from the widget comp, unless it's batched or pooled
+	if (LifeBarHandle == INDEX_NONE && !PooledLifeBarClass)
+	{
+		LifeBarWidget = Cast<UCombatLifeBar>(LifeBar->GetUserWidgetObject());
+		check(LifeBarWidget);
+	}
 
 	// fill the life bar
-	LifeBarWidget->SetLifePercentage(1.0f);
+	SetLifeBarPercentage(1.0f);
+
+	// subscribe to the attack timeline end
+	AttackTimeline->OnTimelineEnded.BindUObject(this, &ACombatEnemy::AttackTimelineEnded);
+
+	// keep our attack assets loaded. They're normally preloaded by the spawner, so this completes right away,
+	// but enemies placed in the level stream them in here
+	TArray<FSoftObjectPath> AttackAssetPaths;
+	GetAttackAssetPaths(AttackAssetPaths);
+
+	if (!AttackAssetPaths.IsEmpty())
+	{
+		AttackAssetsHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(MoveTemp(AttackAssetPaths));
+	}
 }
 
 void ACombatEnemy::EndPlay(EEndPlayReason::Type EndPlayReason)
 {
+	// return the life bar widget to the pool before the widget component releases it
+	ReleasePooledLifeBar();
+
 	Super::EndPlay(EndPlayReason);
 
 	// clear the death timer
 	GetWorld()->GetTimerManager().ClearTimer(DeathTimer);
+
+	// leave the combat simulation and broadphase
+	RemoveFromCombat();
+
+	// let go of the attack assets
+	if (AttackAssetsHandle.IsValid())
+	{
+		AttackAssetsHandle->ReleaseHandle();
+		AttackAssetsHandle.Reset();
+	}
+
+	// remove the bar from the batched life bar overlay
+	if (UCombatLifeBarSubsystem* LifeBars = GetWorld()->GetSubsystem<UCombatLifeBarSubsystem>())
+	{
+		LifeBars->UnregisterLifeBar(LifeBarHandle);
+	}
 }
@@ -6,13 +6,22 @@
 #include "GameFramework/Character.h"
 #include "CombatAttacker.h"
 #include "CombatDamageable.h"
+#include "BdozawaSignificanceAgent.h"
 #include "Animation/AnimMontage.h"
 #include "Engine/TimerHandle.h"
+#include "UObject/SoftObjectPtr.h"
 #include "CombatEnemy.generated.h"
 
 class UWidgetComponent;
 class UCombatLifeBar;
+class UCombatFactionComponent;
+class UCombatHurtboxComponent;
+class UCombatAttackTimelineComponent;
+class UCombatAttackTimeline;
+class UCombatMeleeComponent;
 class UAnimMontage;
+class FCombatSimulation;
+struct FStreamableHandle;
 
 /** Completed attack animation delegate for StateTree */
 DECLARE_DELEGATE(FOnEnemyAttackCompleted);
@@ -28,7 +37,7 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnEnemyDied);
  *  Its bundled AI Controller runs logic through StateTree
  */
 UCLASS(abstract)
-class ACombatEnemy : public ACharacter, public ICombatAttacker, public ICombatDamageable
+class ACombatEnemy : public ACharacter, public ICombatAttacker, public ICombatDamageable, public IBdozawaSignificanceAgent
 {
 	GENERATED_BODY()
 
@@ -36,11 +45,54 @@ class ACombatEnemy : public ACharacter, public ICombatAttacker, public ICombatDa
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components", meta = (AllowPrivateAccess = "true"))
 	UWidgetComponent* LifeBar;
 
+	/** Combat faction component */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components", meta = (AllowPrivateAccess = "true"))
+	UCombatFactionComponent* Faction;
+
+	/** Combat hurtbox component */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components", meta = (AllowPrivateAccess = "true"))
+	UCombatHurtboxComponent* Hurtbox;
+
+	/** Attack timeline playback component */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components", meta = (AllowPrivateAccess = "true"))
+	UCombatAttackTimelineComponent* AttackTimeline;
+
+	/** Melee attack component. Owns the melee trace and damage tuning */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components", meta = (AllowPrivateAccess = "true"))
+	UCombatMeleeComponent* Melee;
+
+#if WITH_EDITORONLY_DATA
+	/** Deprecated melee tuning, migrated to the Melee component on load */
+	UPROPERTY()
+	float MeleeTraceDistance_DEPRECATED = 75.0f;
+
+	UPROPERTY()
+	float MeleeTraceRadius_DEPRECATED = 50.0f;
+
+	UPROPERTY()
+	bool bUseCombatBroadphase_DEPRECATED = false;
+
+	UPROPERTY()
+	bool bTraceHurtboxes_DEPRECATED = true;
+
+	UPROPERTY()
+	float MeleeDamage_DEPRECATED = 1.0f;
+
+	UPROPERTY()
+	float MeleeKnockbackImpulse_DEPRECATED = 150.0f;
+
+	UPROPERTY()
+	float MeleeLaunchImpulse_DEPRECATED = 350.0f;
+#endif // WITH_EDITORONLY_DATA
+
 public:
 	
 	/** Constructor */
 	ACombatEnemy();
 
+	/** Migrates deprecated melee tuning to the Melee component */
+	virtual void PostLoad() override;
+
 protected:
 
 	/** Max amount of HP the character will have on respawn */
@@ -59,50 +111,42 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Damage")
 	FName PelvisBoneName;
 
-	/** Pointer to the life bar widget */
+	/** Pointer to the life bar widget. Null if the life bar is drawn by the batched life bar overlay */
 	UPROPERTY(EditAnywhere, Category="Damage")
 	UCombatLifeBar* LifeBarWidget;
 
-	/** If true, the character is currently playing an attack animation */
-	bool bIsAttacking = false;
-
-	/** Distance ahead of the character that melee attack sphere collision traces will extend */
-	UPROPERTY(EditAnywhere, Category="Melee Attack|Trace", meta = (ClampMin = 0, ClampMax = 500, Units = "cm"))
-	float MeleeTraceDistance = 75.0f;
+	/** Life bar fill color, used when the life bar is drawn by the batched life bar overlay */
+	UPROPERTY(EditAnywhere, Category="Damage")
+	FLinearColor LifeBarColor = FLinearColor::Red;
 
-	/** Radius of the sphere trace for melee attacks */
-	UPROPERTY(EditAnywhere, Category="Melee Attack|Trace", meta = (ClampMin = 0, ClampMax = 500, Units = "cm"))
-	float MeleeTraceRadius = 50.0f;
+	/** Handle to this character's bar in the batched life bar overlay */
+	int32 LifeBarHandle = INDEX_NONE;
 
-	/** Amount of damage a melee attack will deal */
-	UPROPERTY(EditAnywhere, Category="Melee Attack|Damage", meta = (ClampMin = 0, ClampMax = 100))
-	float MeleeDamage = 1.0f;
+	/** Widget class of the life bar, if it's created lazily from the life bar pool */
+	UPROPERTY(Transient)
+	TSubclassOf<UCombatLifeBar> PooledLifeBarClass;
 
-	/** Amount of knockback impulse a melee attack will apply */
-	UPROPERTY(EditAnywhere, Category="Melee Attack|Damage", meta = (ClampMin = 0, ClampMax = 1000, Units = "cm/s"))
-	float MeleeKnockbackImpulse = 150.0f;
+	/** Index of this character's HP and attack state in the combat simulation */
+	int32 CombatantIndex = INDEX_NONE;
 
-	/** Amount of upwards impulse a melee attack will apply */
-	UPROPERTY(EditAnywhere, Category="Melee Attack|Damage", meta = (ClampMin = 0, ClampMax = 1000, Units = "cm/s"))
-	float MeleeLaunchImpulse = 350.0f;
+	/** Handle of this character in the proximity subsystem */
+	int32 ProximityHandle = INDEX_NONE;
 
-	/** AnimMontage that will play for combo attacks */
+	/** AnimMontage that will play for combo attacks. Streamed in by the enemy spawner's preload */
 	UPROPERTY(EditAnywhere, Category="Melee Attack|Combo")
-	UAnimMontage* ComboAttackMontage;
+	TSoftObjectPtr<UAnimMontage> ComboAttackMontage;
 
 	/** Names of the AnimMontage sections that correspond to each stage of the combo attack */
 	UPROPERTY(EditAnywhere, Category="Melee Attack|Combo")
 	TArray<FName> ComboSectionNames;
 
-	/** Target number of attacks in the combo attack string we're playing */
-	int32 TargetComboCount = 0;
-
-	/** Index of the current stage of the melee attack combo */
-	int32 CurrentComboAttack = 0;
+	/** Optional timeline extracted from the combo attack montage. If set, combo attack timing runs from it instead of the montage's notifies */
+	UPROPERTY(EditAnywhere, Category="Melee Attack|Combo")
+	TSoftObjectPtr<UCombatAttackTimeline> ComboAttackTimeline;
 
-	/** AnimMontage that will play for charged attacks */
+	/** AnimMontage that will play for charged attacks. Streamed in by the enemy spawner's preload */
 	UPROPERTY(EditAnywhere, Category="Melee Attack|Charged")
-	UAnimMontage* ChargedAttackMontage;
+	TSoftObjectPtr<UAnimMontage> ChargedAttackMontage;
 
 	/** Name of the AnimMontage section that corresponds to the charge loop */
 	UPROPERTY(EditAnywhere, Category="Melee Attack|Charged")
@@ -112,6 +156,10 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Melee Attack|Charged")
 	FName ChargeAttackSection;
 
+	/** Optional timeline extracted from the charged attack montage. If set, charged attack timing runs from it instead of the montage's notifies */
+	UPROPERTY(EditAnywhere, Category="Melee Attack|Charged")
+	TSoftObjectPtr<UCombatAttackTimeline> ChargedAttackTimeline;
+
 	/** Minimum number of charge animation loops that will be played by the AI */
 	UPROPERTY(EditAnywhere, Category="Melee Attack|Charged", meta = (ClampMin = 1, ClampMax = 20))
 	int32 MinChargeLoops = 2;
@@ -120,12 +168,6 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Melee Attack|Charged", meta = (ClampMin = 1, ClampMax = 20))
 	int32 MaxChargeLoops = 5;
 
-	/** Target number of charge animation loops to play in this charged attack */
-	int32 TargetChargeLoops = 0;
-
-	/** Number of charge animation loop currently playing */
-	int32 CurrentChargeLoop = 0;
-
 	/** Time to wait before removing this character from the level after it dies */
 	UPROPERTY(EditAnywhere, Category="Death")
 	float DeathRemovalTime = 5.0f;
@@ -133,6 +175,35 @@ protected:
 	/** Enemy death timer */
 	FTimerHandle DeathTimer;
 
+	/** Keeps the attack montages and timelines loaded while this enemy is alive */
+	TSharedPtr<FStreamableHandle> AttackAssetsHandle;
+
+	/** Collision setting of the capsule on spawn, restored when the enemy is reused from the pool */
+	TEnumAsByte<ECollisionEnabled::Type> CapsuleCollisionEnabled = ECollisionEnabled::QueryAndPhysics;
+
+	/** True while the enemy is parked in the enemy pool */
+	bool bParked = false;
+
+	/** LOD bundles applied as the enemy's significance changes */
+	UPROPERTY(EditAnywhere, Category="Significance")
+	FBdozawaSignificanceSettings SignificanceSettings;
+
+	/** Time the enemy counts as engaged with the player after taking damage */
+	UPROPERTY(EditAnywhere, Category="Significance", meta = (ClampMin = 0, ClampMax = 30, Units="s"))
+	float EngagedTime = 5.0f;
+
+	/** World time of the last damage taken */
+	double LastDamageTime = -1.0;
+
+	/** Collision setting of the skeletal mesh on spawn, restored when the enemy becomes significant again */
+	TEnumAsByte<ECollisionEnabled::Type> MeshCollisionEnabled = ECollisionEnabled::QueryAndPhysics;
+
+	/** True while the life bar is hidden because of low significance */
+	bool bLifeBarCulled = false;
+
+	/** True while the skeletal mesh collision is disabled because of low significance */
+	bool bMeshCollisionSimplified = false;
+
 	/** Attack montage ended delegate */
 	FOnMontageEnded OnAttackMontageEnded;
 
@@ -158,6 +229,27 @@ public:
 	/** Called from a delegate when the attack montage ends */
 	void AttackMontageEnded(UAnimMontage* Montage, bool bInterrupted);
 
+	/** Called from a delegate when the attack timeline ends */
+	void AttackTimelineEnded(bool bInterrupted);
+
+	/** Jumps to a section in both the attack montage and the attack timeline */
+	void JumpToAttackSection(UAnimMontage* Montage, FName SectionName);
+
+	/** Adds the soft referenced attack montages and timelines to the list, so they can be streamed in ahead of time */
+	void GetAttackAssetPaths(TArray<FSoftObjectPath>& OutPaths) const;
+
+	/** Updates the life bar fill, on either the widget or the batched life bar overlay */
+	void SetLifeBarPercentage(float Percent);
+
+	/** Hides the life bar */
+	void HideLifeBar();
+
+	/** Gets a life bar widget from the pool, if the life bar is pooled and doesn't have one yet */
+	void AcquirePooledLifeBar();
+
+	/** Returns the life bar widget to the pool, if the life bar is pooled */
+	void ReleasePooledLifeBar();
+
 public:
 
 	// ~begin ICombatAttacker interface
@@ -173,6 +265,9 @@ public:
 	UFUNCTION(BlueprintCallable, Category="Attacker")
 	virtual void CheckChargedAttack() override;
 
+	/** Returns true while attack timing is being driven by an attack timeline */
+	virtual bool IsAttackTimelineActive() const override;
+
 	// ~end ICombatAttacker interface
 
 	// ~begin ICombatDamageable interface
@@ -188,11 +283,54 @@ public:
 
 	// ~end ICombatDamageable interface
 
-protected:
+public:
 
-	/** Removes this character from the level after it dies */
+	/** Removes this character from the level after it dies, or when a checkpoint is restored. Parks it in the enemy pool if pooling is enabled */
 	void RemoveFromLevel();
 
+	/** Sets the current HP and updates the life bar, e.g. when restoring a checkpoint */
+	void RestoreHP(float HP);
+
+protected:
+
+	/** Returns the combat simulation holding this character's HP and attack state */
+	FCombatSimulation& GetCombatSimulation() const;
+
+	/** Adds this character to the combat simulation at full HP, the combat broadphase, the proximity subsystem and the significance subsystem */
+	void AddToCombat();
+
+	/** Removes this character from the combat simulation, the combat broadphase, the proximity subsystem and the significance subsystem */
+	void RemoveFromCombat();
+
+	/** Disables the skeletal mesh collision, or restores it to its spawn setting */
+	void SetMeshCollisionSimplified(bool bSimplified);
+
+public:
+
+	// ~begin IBdozawaSignificanceAgent interface
+
+	/** Returns true while the enemy is attacking or was recently damaged */
+	virtual bool IsEngaged() const override;
+
+	/** Shows or hides the life bar and the skeletal mesh collision */
+	virtual void ApplySignificanceLOD(const FBdozawaSignificanceLOD& LOD) override;
+
+	// ~end IBdozawaSignificanceAgent interface
+
+public:
+
+	/** Removes the enemy from play without destroying it, so the enemy pool can reuse it */
+	void ParkInPool();
+
+	/** Puts a parked enemy back into play at the given transform with its combat state reset */
+	void ActivateFromPool(const FTransform& SpawnTransform);
+
+	/** Returns true while the enemy is parked in the enemy pool */
+	bool IsParked() const { return bParked; }
+
+	/** Returns this character's handle in the proximity subsystem */
+	int32 GetProximityHandle() const { return ProximityHandle; }
+
 public:
 
 	/** Overrides the default TakeDamage functionality */
@@ -7,6 +7,22 @@
 #include "Components/ArrowComponent.h"
 #include "TimerManager.h"
 #include "CombatEnemy.h"
+#include "CombatEnemyPool.h"
+#include "CombatSpawnSubsystem.h"
+#include "CombatWaveDirector.h"
+#include "CombatCheckpointSubsystem.h"
+#include "BdozawaProximitySubsystem.h"
+#include "Engine/AssetManager.h"
+#include "Engine/World.h"
+#include "Engine/StreamableManager.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "ProfilingDebugging/MiscTrace.h"
+#include "CombatStats.h"
+#include "Bdozawa.h"
+
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Spawner Preload Time (ms)"), STAT_CombatSpawnerPreloadTime, STATGROUP_Combat);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Spawner Preloads Pending"), STAT_CombatSpawnerPreloadsPending, STATGROUP_Combat);
 
 ACombatEnemySpawner::ACombatEnemySpawner()
 {
@@ -30,9 +46,44 @@ ACombatEnemySpawner::ACombatEnemySpawner()
 void ACombatEnemySpawner::BeginPlay()
 {
 	Super::BeginPlay();
-	
-	// should we spawn an enemy right away?
-	if (bShouldSpawnEnemiesImmediately)
+
+	// stream in the enemy assets when the player reaches the trigger, gets close enough, or right away
+	if (PreloadTrigger)
+	{
+		PreloadTrigger->OnActorBeginOverlap.AddDynamic(this, &ACombatEnemySpawner::OnPreloadTriggerOverlap);
+
+	} else if (PreloadRadius > 0.0f) {
+
+		// let the proximity subsystem track our distance to the players until we preload
+		if (UBdozawaProximitySubsystem* Proximity = GetWorld()->GetSubsystem<UBdozawaProximitySubsystem>())
+		{
+			ProximityHandle = Proximity->RegisterAgent(this);
+		}
+
+		GetWorld()->GetTimerManager().SetTimer(PreloadCheckTimer, this, &ACombatEnemySpawner::CheckPreloadRadius, PreloadCheckInterval, true);
+
+	} else {
+
+		StartPreload();
+	}
+
+	// all baked spawn slots start free
+	ResetSpawnSlots();
+
+	// save our state in checkpoint snapshots
+	if (UCombatCheckpointSubsystem* Checkpoints = GetWorld()->GetSubsystem<UCombatCheckpointSubsystem>())
+	{
+		Checkpoints->RegisterCheckpointable(this);
+	}
+
+	// let the wave director budget our spawns, and start us if we're part of a wave
+	if (UCombatWaveDirector* WaveDirector = GetWorld()->GetSubsystem<UCombatWaveDirector>())
+	{
+		WaveDirector->RegisterSpawner(this, Wave);
+	}
+
+	// should we spawn an enemy right away? Wave spawners wait for the director instead
+	if (bShouldSpawnEnemiesImmediately && Wave == INDEX_NONE)
 	{
 		// schedule the first enemy spawn
 		GetWorld()->GetTimerManager().SetTimer(SpawnTimer, this, &ACombatEnemySpawner::SpawnEnemy, InitialSpawnDelay);
@@ -44,38 +95,364 @@ void ACombatEnemySpawner::EndPlay(EEndPlayReason::Type EndPlayReason)
 {
 	Super::EndPlay(EndPlayReason);
 
-	// clear the spawn timer
+	// leave the wave director
+	if (UCombatWaveDirector* WaveDirector = GetWorld()->GetSubsystem<UCombatWaveDirector>())
+	{
+		WaveDirector->UnregisterSpawner(this);
+	}
+
+	// leave the checkpoint snapshots
+	if (UCombatCheckpointSubsystem* Checkpoints = GetWorld()->GetSubsystem<UCombatCheckpointSubsystem>())
+	{
+		Checkpoints->UnregisterCheckpointable(this);
+	}
+
+	// clear the timers
 	GetWorld()->GetTimerManager().ClearTimer(SpawnTimer);
+	GetWorld()->GetTimerManager().ClearTimer(PreloadCheckTimer);
+
+	// stop tracking the player distance
+	if (UBdozawaProximitySubsystem* Proximity = GetWorld()->GetSubsystem<UBdozawaProximitySubsystem>())
+	{
+		Proximity->UnregisterAgent(ProximityHandle);
+	}
+
+	// stop listening to the preload trigger
+	if (PreloadTrigger)
+	{
+		PreloadTrigger->OnActorBeginOverlap.RemoveDynamic(this, &ACombatEnemySpawner::OnPreloadTriggerOverlap);
+	}
+
+	// cancel or release the preload
+	if (PreloadHandle.IsValid())
+	{
+		if (!bPreloaded)
+		{
+			DEC_DWORD_STAT(STAT_CombatSpawnerPreloadsPending);
+		}
+
+		PreloadHandle->CancelHandle();
+		PreloadHandle.Reset();
+	}
 }
 
 void ACombatEnemySpawner::SpawnEnemy()
+{
+	// hold the spawn until the enemy assets are loaded
+	if (!bPreloaded)
+	{
+		bSpawnWhenPreloaded = true;
+		StartPreload();
+		return;
+	}
+
+	// wait for a slot in the alive enemy budget. The director spawns for us once one frees up
+	if (UCombatWaveDirector* WaveDirector = GetWorld()->GetSubsystem<UCombatWaveDirector>())
+	{
+		if (!WaveDirector->RequestSpawnSlot(this))
+		{
+			return;
+		}
+	}
+
+	SpawnGrantedEnemy();
+}
+
+void ACombatEnemySpawner::SpawnGrantedEnemy()
 {
 	// ensure the enemy class is valid
-	if (IsValid(EnemyClass))
+	if (UClass* LoadedEnemyClass = EnemyClass.Get())
 	{
-		// spawn the enemy at the reference capsule's transform
+		// spawn at a free baked slot, which is known to be clear, so no collision fix-up is needed.
+		// Fall back to the reference capsule's transform if we don't have one
+		const int32 SpawnSlot = ClaimSpawnSlot();
+
+		const FTransform SpawnTransform = SpawnSlot != INDEX_NONE ? SpawnSlots[SpawnSlot] * GetActorTransform() : SpawnCapsule->GetComponentTransform();
+		const ESpawnActorCollisionHandlingMethod CollisionHandling = SpawnSlot != INDEX_NONE ? ESpawnActorCollisionHandlingMethod::AlwaysSpawn : ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+		// queue the spawn, so it's time sliced with other spawners
+		if (UCombatSpawnSubsystem* SpawnSubsystem = GetWorld()->GetSubsystem<UCombatSpawnSubsystem>())
+		{
+			SpawnSubsystem->SubmitSpawn(LoadedEnemyClass, SpawnTransform, SpawnPriority, CollisionHandling, FOnCombatEnemySpawned::CreateUObject(this, &ACombatEnemySpawner::OnEnemySpawned, SpawnSlot, SpawnSerial));
+			return;
+		}
+
 		FActorSpawnParameters SpawnParams;
-		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+		SpawnParams.SpawnCollisionHandlingOverride = CollisionHandling;
 
-		ACombatEnemy* SpawnedEnemy = GetWorld()->SpawnActor<ACombatEnemy>(EnemyClass, SpawnCapsule->GetComponentTransform(), SpawnParams);
+		OnEnemySpawned(GetWorld()->SpawnActor<ACombatEnemy>(LoadedEnemyClass, SpawnTransform, SpawnParams), SpawnSlot, SpawnSerial);
+		return;
+	}
 
-		// was the enemy successfully created?
+	// we can't spawn without an enemy class, so give back the budget slot we were granted
+	if (UCombatWaveDirector* WaveDirector = GetWorld()->GetSubsystem<UCombatWaveDirector>())
+	{
+		WaveDirector->ReleaseSpawnSlot(this);
+	}
+}
+
+void ACombatEnemySpawner::OnEnemySpawned(ACombatEnemy* SpawnedEnemy, int32 SpawnSlot, int32 RequestSerial)
+{
+	// a checkpoint was restored while this spawn was queued. The restore already reset our slots and enemies
+	if (RequestSerial != SpawnSerial)
+	{
 		if (SpawnedEnemy)
 		{
-			// subscribe to the death delegate
-			SpawnedEnemy->OnEnemyDied.AddDynamic(this, &ACombatEnemySpawner::OnEnemyDied);
+			SpawnedEnemy->RemoveFromLevel();
+		}
+
+		if (UCombatWaveDirector* WaveDirector = GetWorld()->GetSubsystem<UCombatWaveDirector>())
+		{
+			WaveDirector->ReleaseSpawnSlot(this);
+		}
+
+		return;
+	}
+
+	// was the enemy successfully created?
+	if (SpawnedEnemy)
+	{
+		// subscribe to the death delegate
+		SpawnedEnemy->OnEnemyDied.AddDynamic(this, &ACombatEnemySpawner::OnEnemyDied);
+
+		// keep track of it so checkpoints can save and remove it. Forget enemies that have already been removed
+		SpawnedEnemies.RemoveAllSwap([](const TWeakObjectPtr<ACombatEnemy>& Enemy) { return !Enemy.IsValid() || Enemy->IsParked(); }, EAllowShrinking::No);
+		SpawnedEnemies.Add(SpawnedEnemy);
+
+		// hold on to the slot while the enemy is alive
+		if (SpawnSlot != INDEX_NONE)
+		{
+			ClaimedSpawnSlots.Emplace(SpawnedEnemy, SpawnSlot);
+		}
+
+		return;
+	}
+
+	// give back the slot we picked for it
+	if (SpawnSlot != INDEX_NONE)
+	{
+		FreeSpawnSlots.Add(SpawnSlot);
+	}
+
+	// give back the budget slot we reserved for it
+	if (UCombatWaveDirector* WaveDirector = GetWorld()->GetSubsystem<UCombatWaveDirector>())
+	{
+		WaveDirector->ReleaseSpawnSlot(this);
+	}
+}
+
+void ACombatEnemySpawner::RemoveSpawnedEnemies()
+{
+	UCombatWaveDirector* WaveDirector = GetWorld()->GetSubsystem<UCombatWaveDirector>();
+
+	for (const TWeakObjectPtr<ACombatEnemy>& EnemyPtr : SpawnedEnemies)
+	{
+		ACombatEnemy* Enemy = EnemyPtr.Get();
+
+		if (!IsValid(Enemy) || Enemy->IsParked())
+		{
+			continue;
+		}
+
+		Enemy->OnEnemyDied.RemoveDynamic(this, &ACombatEnemySpawner::OnEnemyDied);
+
+		// dead enemies already gave back their budget slot
+		if (WaveDirector && Enemy->CurrentHP > 0.0f)
+		{
+			WaveDirector->ReleaseSpawnSlot(this);
+		}
+
+		Enemy->RemoveFromLevel();
+	}
+
+	SpawnedEnemies.Reset();
+
+	// every spawn slot is free again
+	ResetSpawnSlots();
+}
+
+int32 ACombatEnemySpawner::ClaimSpawnSlot()
+{
+	// slots of enemies that died since the last spawn are free again
+	ReleaseDeadEnemySpawnSlots();
+
+	return FreeSpawnSlots.IsEmpty() ? INDEX_NONE : FreeSpawnSlots.Pop(EAllowShrinking::No);
+}
+
+void ACombatEnemySpawner::ReleaseDeadEnemySpawnSlots()
+{
+	// dead enemies disable their capsule collision, so their slot can be reused right away
+	for (int32 i = ClaimedSpawnSlots.Num() - 1; i >= 0; --i)
+	{
+		const ACombatEnemy* Enemy = ClaimedSpawnSlots[i].Key.Get();
+
+		if (!IsValid(Enemy) || Enemy->IsParked() || Enemy->CurrentHP <= 0.0f)
+		{
+			FreeSpawnSlots.Add(ClaimedSpawnSlots[i].Value);
+			ClaimedSpawnSlots.RemoveAtSwap(i, EAllowShrinking::No);
+		}
+	}
+}
+
+void ACombatEnemySpawner::ResetSpawnSlots()
+{
+	ClaimedSpawnSlots.Reset();
+	FreeSpawnSlots.Reset(SpawnSlots.Num());
+
+	// pop from the back so the first slot, closest to the capsule, is used first
+	for (int32 i = SpawnSlots.Num() - 1; i >= 0; --i)
+	{
+		FreeSpawnSlots.Add(i);
+	}
+}
+
+void ACombatEnemySpawner::StartWave()
+{
+	// ensure we're only started once
+	if (bHasBeenActivated)
+	{
+		return;
+	}
+
+	bHasBeenActivated = true;
+
+	// schedule the first enemy spawn
+	GetWorld()->GetTimerManager().SetTimer(SpawnTimer, this, &ACombatEnemySpawner::SpawnEnemy, FMath::Max(InitialSpawnDelay, UE_KINDA_SMALL_NUMBER));
+}
+
+void ACombatEnemySpawner::StartPreload()
+{
+	// only preload once
+	if (bPreloadStarted)
+	{
+		return;
+	}
+
+	bPreloadStarted = true;
+	GetWorld()->GetTimerManager().ClearTimer(PreloadCheckTimer);
+
+	// the player distance isn't needed anymore
+	if (UBdozawaProximitySubsystem* Proximity = GetWorld()->GetSubsystem<UBdozawaProximitySubsystem>())
+	{
+		Proximity->UnregisterAgent(ProximityHandle);
+	}
+
+	// nothing to load
+	if (EnemyClass.IsNull())
+	{
+		OnPreloadComplete();
+		return;
+	}
+
+	PreloadStartTime = FPlatformTime::Seconds();
+	INC_DWORD_STAT(STAT_CombatSpawnerPreloadsPending);
+
+	// the attack assets are only known once we have the enemy class, so stream the class in first.
+	// The class brings its hard references along, including the AI controller and its StateTree
+	PreloadHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(EnemyClass.ToSoftObjectPath(), FStreamableDelegate::CreateUObject(this, &ACombatEnemySpawner::OnEnemyClassLoaded));
+}
+
+void ACombatEnemySpawner::OnEnemyClassLoaded()
+{
+	TArray<FSoftObjectPath> AssetPaths;
+
+	// keep the class in the next request too, so the new handle keeps it loaded
+	AssetPaths.Add(EnemyClass.ToSoftObjectPath());
+
+	if (UClass* LoadedEnemyClass = EnemyClass.Get())
+	{
+		LoadedEnemyClass->GetDefaultObject<ACombatEnemy>()->GetAttackAssetPaths(AssetPaths);
+	}
+
+	PreloadHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(MoveTemp(AssetPaths), FStreamableDelegate::CreateUObject(this, &ACombatEnemySpawner::OnPreloadComplete));
+}
+
+void ACombatEnemySpawner::OnPreloadComplete()
+{
+	bPreloaded = true;
+
+	// report the load time
+	if (!EnemyClass.IsNull())
+	{
+		const double PreloadTime = FPlatformTime::Seconds() - PreloadStartTime;
+
+		DEC_DWORD_STAT(STAT_CombatSpawnerPreloadsPending);
+		INC_FLOAT_STAT_BY(STAT_CombatSpawnerPreloadTime, PreloadTime * 1000.0);
+		TRACE_BOOKMARK(TEXT("Enemy spawner preloaded: %s"), *GetName());
+
+		UE_LOG(LogBdozawa, Log, TEXT("%s preloaded %s in %.2f ms"), *GetName(), *EnemyClass.ToString(), PreloadTime * 1000.0);
+	}
+
+	// pre-warm the enemy pool over the next frames. A dead enemy is only parked after its removal delay,
+	// so the next enemy may need a second instance
+	if (UCombatEnemyPool* EnemyPool = GetWorld()->GetSubsystem<UCombatEnemyPool>())
+	{
+		EnemyPool->PrewarmEnemies(EnemyClass.Get(), SpawnCapsule->GetComponentTransform(), FMath::Min(PoolPrewarmCount, SpawnCount));
+	}
+
+	// run any spawn that was waiting on us
+	if (bSpawnWhenPreloaded)
+	{
+		bSpawnWhenPreloaded = false;
+		SpawnEnemy();
+	}
+}
+
+void ACombatEnemySpawner::CheckPreloadRadius()
+{
+	// read the distance to the nearest player computed for this frame
+	if (const UBdozawaProximitySubsystem* Proximity = GetWorld()->GetSubsystem<UBdozawaProximitySubsystem>())
+	{
+		if (ProximityHandle != INDEX_NONE && Proximity->GetDistanceSquaredToPlayer(ProximityHandle) <= FMath::Square(PreloadRadius))
+		{
+			StartPreload();
 		}
+
+		return;
+	}
+
+	const APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	const APawn* PlayerPawn = PlayerController ? PlayerController->GetPawn() : nullptr;
+
+	if (PlayerPawn && FVector::DistSquared(PlayerPawn->GetActorLocation(), GetActorLocation()) <= FMath::Square(PreloadRadius))
+	{
+		StartPreload();
+	}
+}
+
+void ACombatEnemySpawner::OnPreloadTriggerOverlap(AActor* OverlappedActor, AActor* OtherActor)
+{
+	// only preload for players
+	const APawn* Pawn = Cast<APawn>(OtherActor);
+
+	if (Pawn && Pawn->IsPlayerControlled())
+	{
+		StartPreload();
 	}
 }
 
 void ACombatEnemySpawner::OnEnemyDied()
 {
+	UCombatWaveDirector* WaveDirector = GetWorld()->GetSubsystem<UCombatWaveDirector>();
+
+	// free up the enemy's slot in the alive enemy budget
+	if (WaveDirector)
+	{
+		WaveDirector->ReleaseSpawnSlot(this);
+	}
+
 	// decrease the spawn counter
 	--SpawnCount;
 
 	// is this the last enemy we should spawn?
 	if (SpawnCount <= 0)
 	{
+		// let the director know our wave may be over
+		if (WaveDirector)
+		{
+			WaveDirector->NotifySpawnerDepleted(this);
+		}
+
 		// schedule the activation on depleted message
 		GetWorld()->GetTimerManager().SetTimer(SpawnTimer, this, &ACombatEnemySpawner::SpawnerDepleted, ActivationDelay);
 		return;
@@ -106,8 +483,8 @@ void ACombatEnemySpawner::ToggleInteraction(AActor* ActivationInstigator)
 
 void ACombatEnemySpawner::ActivateInteraction(AActor* ActivationInstigator)
 {
-	// ensure we're only activated once, and only if we've deferred enemy spawning
-	if (bHasBeenActivated || bShouldSpawnEnemiesImmediately)
+	// ensure we're only activated once, and only if we've deferred enemy spawning. Wave spawners are started by the wave director
+	if (bHasBeenActivated || bShouldSpawnEnemiesImmediately || Wave != INDEX_NONE)
 	{
 		return;
 	}
@@ -123,3 +500,193 @@ void ACombatEnemySpawner::DeactivateInteraction(AActor* ActivationInstigator)
 {
 	// stub
 }
+
+void ACombatEnemySpawner::SerializeCheckpoint(FArchive& Ar)
+{
+	FTimerManager& TimerManager = GetWorld()->GetTimerManager();
+
+	// a negative remaining time means no spawn or depletion was pending
+	float SpawnTimerRemaining = TimerManager.GetTimerRemaining(SpawnTimer);
+
+	Ar << SpawnCount;
+	Ar << bHasBeenActivated;
+	Ar << SpawnTimerRemaining;
+
+	if (Ar.IsSaving())
+	{
+		// count the enemies that are still alive
+		int32 NumEnemies = 0;
+
+		for (const TWeakObjectPtr<ACombatEnemy>& Enemy : SpawnedEnemies)
+		{
+			NumEnemies += (Enemy.IsValid() && !Enemy->IsParked() && Enemy->CurrentHP > 0.0f) ? 1 : 0;
+		}
+
+		Ar << NumEnemies;
+
+		for (const TWeakObjectPtr<ACombatEnemy>& Enemy : SpawnedEnemies)
+		{
+			if (Enemy.IsValid() && !Enemy->IsParked() && Enemy->CurrentHP > 0.0f)
+			{
+				FTransform EnemyTransform = Enemy->GetActorTransform();
+				float EnemyHP = Enemy->CurrentHP;
+
+				Ar << EnemyTransform;
+				Ar << EnemyHP;
+			}
+		}
+
+		return;
+	}
+
+	// drop everything that happened since the snapshot, including spawns still in the queue
+	// and slot requests still waiting on the wave director
+	RemoveSpawnedEnemies();
+	++SpawnSerial;
+
+	// a spawn held for the preload would double up with the restored spawn timer
+	bSpawnWhenPreloaded = false;
+
+	TimerManager.ClearTimer(SpawnTimer);
+
+	int32 NumEnemies = 0;
+	Ar << NumEnemies;
+
+	UClass* LoadedEnemyClass = EnemyClass.Get();
+	UCombatWaveDirector* WaveDirector = GetWorld()->GetSubsystem<UCombatWaveDirector>();
+	UCombatEnemyPool* EnemyPool = UCombatEnemyPool::IsPoolingEnabled() ? GetWorld()->GetSubsystem<UCombatEnemyPool>() : nullptr;
+
+	for (int32 i = 0; i < NumEnemies; ++i)
+	{
+		FTransform EnemyTransform;
+		float EnemyHP = 0.0f;
+
+		Ar << EnemyTransform;
+		Ar << EnemyHP;
+
+		// the enemy class is always loaded if we had enemies alive, unless the spawner was reset since
+		if (!LoadedEnemyClass)
+		{
+			continue;
+		}
+
+		// enemies over budget are spawned fresh by the director once a slot frees up
+		if (WaveDirector && !WaveDirector->RequestSpawnSlot(this))
+		{
+			continue;
+		}
+
+		// put the enemy back where it was. The location was clear when the snapshot was taken
+		ACombatEnemy* Enemy = nullptr;
+
+		if (EnemyPool)
+		{
+			Enemy = EnemyPool->AcquireEnemy(LoadedEnemyClass, EnemyTransform);
+
+		} else {
+
+			FActorSpawnParameters SpawnParams;
+			SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+			Enemy = GetWorld()->SpawnActor<ACombatEnemy>(LoadedEnemyClass, EnemyTransform, SpawnParams);
+		}
+
+		if (Enemy)
+		{
+			Enemy->RestoreHP(EnemyHP);
+		}
+
+		OnEnemySpawned(Enemy, INDEX_NONE, SpawnSerial);
+	}
+
+	// resume the pending spawn or depletion
+	if (SpawnTimerRemaining >= 0.0f)
+	{
+		if (SpawnCount > 0)
+		{
+			TimerManager.SetTimer(SpawnTimer, this, &ACombatEnemySpawner::SpawnEnemy, FMath::Max(SpawnTimerRemaining, UE_KINDA_SMALL_NUMBER));
+
+		} else {
+
+			TimerManager.SetTimer(SpawnTimer, this, &ACombatEnemySpawner::SpawnerDepleted, FMath::Max(SpawnTimerRemaining, UE_KINDA_SMALL_NUMBER));
+		}
+	}
+}
+
+#if WITH_EDITOR
+
+void ACombatEnemySpawner::BakeSpawnSlots()
+{
+	UWorld* World = GetWorld();
+
+	if (!World)
+	{
+		return;
+	}
+
+	Modify();
+	SpawnSlots.Reset();
+
+	const float Radius = SpawnCapsule->GetScaledCapsuleRadius();
+	const float HalfHeight = SpawnCapsule->GetScaledCapsuleHalfHeight();
+	const FCollisionShape CapsuleShape = FCollisionShape::MakeCapsule(Radius, HalfHeight);
+
+	// only static geometry is baked in. Dynamic objects can move before the slot is used
+	const FCollisionObjectQueryParams StaticObjects(FCollisionObjectQueryParams::AllStaticObjects);
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(CombatBakeSpawnSlots), false, this);
+
+	const FVector Center = SpawnCapsule->GetComponentLocation();
+	const FQuat Rotation = SpawnCapsule->GetComponentQuat();
+	const FVector Up = FVector::UpVector;
+
+	// keep slots far enough apart so enemies spawned at the same time don't overlap
+	const float Spacing = FMath::Max(SpawnSlotSpacing, Radius * 2.0f);
+
+	// candidates start at the capsule and grow outwards in rings
+	TArray<FVector> Candidates;
+	Candidates.Add(Center);
+
+	for (float RingRadius = Spacing; RingRadius <= SpawnSlotSearchRadius; RingRadius += Spacing)
+	{
+		const int32 RingCount = FMath::Max(FMath::FloorToInt32(UE_TWO_PI * RingRadius / Spacing), 1);
+
+		for (int32 i = 0; i < RingCount; ++i)
+		{
+			const float Angle = UE_TWO_PI * i / RingCount;
+			Candidates.Add(Center + Rotation.RotateVector(FVector(FMath::Cos(Angle), FMath::Sin(Angle), 0.0f) * RingRadius));
+		}
+	}
+
+	for (const FVector& Candidate : Candidates)
+	{
+		if (SpawnSlots.Num() >= SpawnSlotCount)
+		{
+			break;
+		}
+
+		// drop the capsule onto the floor. Skip candidates that start inside geometry or have no floor under them
+		FHitResult FloorHit;
+
+		if (!World->SweepSingleByObjectType(FloorHit, Candidate + Up * HalfHeight, Candidate - Up * HalfHeight * 2.0f, Rotation, StaticObjects, CapsuleShape, QueryParams)
+			|| FloorHit.bStartPenetrating || !FloorHit.IsValidBlockingHit())
+		{
+			continue;
+		}
+
+		// lift the capsule slightly off the floor so it isn't touching it
+		const FVector SlotLocation = FloorHit.Location + Up * 2.0f;
+
+		// reject slots that are still blocked by static geometry
+		if (World->OverlapAnyTestByObjectType(SlotLocation, Rotation, StaticObjects, CapsuleShape, QueryParams))
+		{
+			continue;
+		}
+
+		// store the slot relative to the spawner, so it follows the spawner if it's moved as a whole
+		SpawnSlots.Add(FTransform(Rotation, SlotLocation).GetRelativeTransform(GetActorTransform()));
+	}
+
+	UE_LOG(LogBdozawa, Log, TEXT("%s baked %d of %d spawn slots"), *GetName(), SpawnSlots.Num(), SpawnSlotCount);
+}
+
+#endif
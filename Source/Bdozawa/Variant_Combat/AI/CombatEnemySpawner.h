@@ -5,20 +5,27 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "CombatActivatable.h"
+#include "CombatCheckpointable.h"
+#include "UObject/SoftObjectPtr.h"
 #include "CombatEnemySpawner.generated.h"
 
 class UCapsuleComponent;
 class UArrowComponent;
 class ACombatEnemy;
+struct FStreamableHandle;
 
 /**
  *  A basic Actor in charge of spawning Enemy Characters and monitoring their deaths.
  *  Enemies will be spawned one by one, and the spawner will wait until the enemy dies before spawning a new one.
  *  The spawner can be remotely activated through the ICombatActivatable interface
  *  When the last spawned enemy dies, the spawner can also activate other ICombatActivatables
+ *  The enemy class and its attack assets are soft references, streamed in asynchronously when the player
+ *  gets close or enters a trigger. Spawns and activations wait until the preload is done.
+ *  Spawn slots can be baked in the editor, so enemies spawn at known clear locations without runtime collision fix-ups.
+ *  Spawner counters and the HP and transforms of its alive enemies are saved in checkpoint snapshots.
  */
 UCLASS(abstract)
-class ACombatEnemySpawner : public AActor, public ICombatActivatable
+class ACombatEnemySpawner : public AActor, public ICombatActivatable, public ICombatCheckpointable
 {
 	GENERATED_BODY()
 	
@@ -30,9 +37,9 @@ class ACombatEnemySpawner : public AActor, public ICombatActivatable
 
 protected:
 
-	/** Type of enemy to spawn */
+	/** Type of enemy to spawn. Streamed in by the preload */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Enemy Spawner")
-	TSubclassOf<ACombatEnemy> EnemyClass;
+	TSoftClassPtr<ACombatEnemy> EnemyClass;
 
 	/** If true, the first enemy will be spawned as soon as the game starts */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Enemy Spawner")
@@ -50,6 +57,58 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Enemy Spawner", meta = (ClampMin = 0, ClampMax = 10))
 	float RespawnDelay = 5.0f;
 
+	/** Wave this spawner belongs to. If set, the wave director starts the spawner when its wave begins, instead of it spawning on its own or through activation */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Enemy Spawner", meta = (ClampMin = -1))
+	int32 Wave = INDEX_NONE;
+
+	/** Spawns from spawners with higher priority are processed first when several spawns are queued in the same frame */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Enemy Spawner")
+	int32 SpawnPriority = 0;
+
+	/** Number of enemies to spawn into the enemy pool at level start, so spawning them later doesn't construct new actors */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Enemy Spawner", meta = (ClampMin = 0, ClampMax = 20))
+	int32 PoolPrewarmCount = 2;
+
+	/** If set, the enemy assets are preloaded when the player overlaps this actor */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Preload")
+	TObjectPtr<AActor> PreloadTrigger;
+
+	/** If there's no preload trigger, the enemy assets are preloaded when the player gets within this distance. Zero preloads as soon as the game starts */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Preload", meta = (ClampMin = 0, Units = "cm"))
+	float PreloadRadius = 3000.0f;
+
+	/** Time between player distance checks while waiting to preload */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Preload", meta = (ClampMin = 0.1, ClampMax = 5, Units = "s"))
+	float PreloadCheckInterval = 0.5f;
+
+	/** Number of spawn slots to look for when baking */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Spawn Slots", meta = (ClampMin = 1, ClampMax = 32))
+	int32 SpawnSlotCount = 4;
+
+	/** Minimum distance between baked spawn slots. Never less than the capsule's diameter */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Spawn Slots", meta = (ClampMin = 0, Units = "cm"))
+	float SpawnSlotSpacing = 100.0f;
+
+	/** Max distance from the spawn capsule to look for spawn slots when baking */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Spawn Slots", meta = (ClampMin = 0, Units = "cm"))
+	float SpawnSlotSearchRadius = 400.0f;
+
+	/** Capsule transforms, relative to the spawner, found clear of static geometry by the bake */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Spawn Slots")
+	TArray<FTransform> SpawnSlots;
+
+	/** Spawn slots not used by a live enemy */
+	TArray<int32> FreeSpawnSlots;
+
+	/** Spawn slots used by live enemies */
+	TArray<TPair<TWeakObjectPtr<ACombatEnemy>, int32>> ClaimedSpawnSlots;
+
+	/** Enemies spawned by this spawner that haven't been removed from the level yet */
+	TArray<TWeakObjectPtr<ACombatEnemy>> SpawnedEnemies;
+
+	/** Incremented when a checkpoint is restored, so spawns queued before the restore are discarded */
+	int32 SpawnSerial = 0;
+
 	/** Time to wait after this spawner is depleted before activating the actor list */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Activation", meta = (ClampMin = 0, ClampMax = 10))
 	float ActivationDelay = 1.0f;
@@ -64,6 +123,27 @@ protected:
 	/** Timer to spawn enemies after a delay */
 	FTimerHandle SpawnTimer;
 
+	/** Timer to check the player distance before preloading */
+	FTimerHandle PreloadCheckTimer;
+
+	/** Handle in the proximity subsystem, used to check the player distance before preloading */
+	int32 ProximityHandle = INDEX_NONE;
+
+	/** Keeps the enemy class and its attack assets loaded */
+	TSharedPtr<FStreamableHandle> PreloadHandle;
+
+	/** Time the preload was started */
+	double PreloadStartTime = 0.0;
+
+	/** True once the preload has been started */
+	bool bPreloadStarted = false;
+
+	/** True once the enemy class and its attack assets are loaded */
+	bool bPreloaded = false;
+
+	/** True if a spawn was requested before the preload finished */
+	bool bSpawnWhenPreloaded = false;
+
 public:	
 	
 	/** Constructor */
@@ -77,11 +157,51 @@ public:
 	/** Cleanup */
 	virtual void EndPlay(EEndPlayReason::Type EndPlayReason) override;
 
+	/** Spawns an enemy using a slot already reserved from the wave director's budget */
+	void SpawnGrantedEnemy();
+
+	/** Starts spawning enemies when the wave director begins this spawner's wave */
+	void StartWave();
+
+	/** Returns the serial bumped on every checkpoint restore */
+	int32 GetSpawnSerial() const { return SpawnSerial; }
+
 protected:
 
 	/** Spawn an enemy and subscribe to its death event */
 	void SpawnEnemy();
 
+	/** Called when the spawn subsystem has spawned our enemy */
+	void OnEnemySpawned(ACombatEnemy* SpawnedEnemy, int32 SpawnSlot, int32 RequestSerial);
+
+	/** Removes all enemies we spawned from the level and gives back their budget slots */
+	void RemoveSpawnedEnemies();
+
+	/** Takes a spawn slot from the free list. Returns INDEX_NONE if none are free */
+	int32 ClaimSpawnSlot();
+
+	/** Returns the spawn slots of dead enemies to the free list */
+	void ReleaseDeadEnemySpawnSlots();
+
+	/** Marks all baked spawn slots as free */
+	void ResetSpawnSlots();
+
+	/** Starts streaming in the enemy class */
+	void StartPreload();
+
+	/** Starts streaming in the enemy's attack assets once its class is loaded */
+	void OnEnemyClassLoaded();
+
+	/** Called once the enemy class and its attack assets are loaded */
+	void OnPreloadComplete();
+
+	/** Starts the preload if the player is within the preload radius */
+	void CheckPreloadRadius();
+
+	/** Starts the preload when the player overlaps the preload trigger */
+	UFUNCTION()
+	void OnPreloadTriggerOverlap(AActor* OverlappedActor, AActor* OtherActor);
+
 	/** Called when the spawned enemy has died */
 	UFUNCTION()
 	void OnEnemyDied();
@@ -106,4 +226,19 @@ public:
 	virtual void DeactivateInteraction(AActor* ActivationInstigator) override;
 
 	// ~end IActivatable interface
+
+	// ~begin ICombatCheckpointable interface
+
+	/** Saves or restores the spawner counters and its alive enemies */
+	virtual void SerializeCheckpoint(FArchive& Ar) override;
+
+	// ~end ICombatCheckpointable interface
+
+#if WITH_EDITOR
+
+	/** Finds clear spawn slots around the spawn capsule by testing the capsule against static geometry */
+	UFUNCTION(CallInEditor, Category="Spawn Slots")
+	void BakeSpawnSlots();
+
+#endif
 };
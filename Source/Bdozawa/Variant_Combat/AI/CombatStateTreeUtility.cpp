@@ -8,7 +8,10 @@
 #include "GameFramework/CharacterMovementComponent.h"
 #include "AIController.h"
 #include "CombatEnemy.h"
-#include "Kismet/GameplayStatics.h"
+#include "CombatAIController.h"
+#include "BdozawaPlayerSnapshotSubsystem.h"
+#include "BdozawaProximitySubsystem.h"
+#include "BdozawaPerceptionSubsystem.h"
 #include "StateTreeAsyncExecutionContext.h"
 
 bool FStateTreeCharacterGroundedCondition::TestCondition(FStateTreeExecutionContext& Context) const
@@ -266,18 +269,55 @@ EStateTreeRunStatus FStateTreeGetPlayerInfoTask::Tick(FStateTreeExecutionContext
 	// get the instance data
 	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
 
-	// get the character possessed by the first local player
-	InstanceData.TargetPlayerCharacter = Cast<ACharacter>(UGameplayStatics::GetPlayerPawn(InstanceData.Character, 0));
+	// read the cached sight result if the controller is perceiving the player
+	const ACombatAIController* Controller = Cast<ACombatAIController>(InstanceData.Character->GetController());
+	const UBdozawaPerceptionSubsystem* Perception = Context.GetWorld()->GetSubsystem<UBdozawaPerceptionSubsystem>();
+	const FBdozawaPerceptionResult* SightResult = Controller && Perception ? Perception->GetResult(Controller->GetPerceptionHandle()) : nullptr;
 
-	// do we have a valid target?
-	if (InstanceData.TargetPlayerCharacter)
+	// should we only target the player while it's in sight?
+	if (InstanceData.bRequireLineOfSight && SightResult)
 	{
-		// update the last known location
-		InstanceData.TargetPlayerLocation = InstanceData.TargetPlayerCharacter->GetActorLocation();
+		InstanceData.TargetPlayerCharacter = SightResult->bCanSeePlayer ? Cast<ACharacter>(SightResult->Player.Get()) : nullptr;
+
+		// keep the location where the player was last seen, so the character can search for it
+		if (SightResult->LastSeenTime >= 0.0)
+		{
+			InstanceData.TargetPlayerLocation = SightResult->LastKnownLocation;
+		}
+
+	} else {
+
+		// get the character possessed by the first player from this frame's player snapshot
+		UBdozawaPlayerSnapshotSubsystem* PlayerSnapshot = Context.GetWorld()->GetSubsystem<UBdozawaPlayerSnapshotSubsystem>();
+		const FBdozawaPlayerSnapshotEntry* Player = PlayerSnapshot ? PlayerSnapshot->GetSnapshot().GetFirstPlayer() : nullptr;
+
+		InstanceData.TargetPlayerCharacter = Player ? Player->Character : nullptr;
+
+		// do we have a valid target?
+		if (InstanceData.TargetPlayerCharacter)
+		{
+			// update the last known location
+			InstanceData.TargetPlayerLocation = Player->Location;
+		}
 	}
 
-	// update the distance
-	InstanceData.DistanceToTarget = FVector::Distance(InstanceData.TargetPlayerLocation, InstanceData.Character->GetActorLocation());
+	InstanceData.bCanSeeTarget = SightResult ? SightResult->bCanSeePlayer : InstanceData.TargetPlayerCharacter != nullptr;
+
+	// read the distance and range band computed for this frame if the character is tracked by the proximity subsystem
+	const ACombatEnemy* Enemy = Cast<ACombatEnemy>(InstanceData.Character);
+	const UBdozawaProximitySubsystem* Proximity = Context.GetWorld()->GetSubsystem<UBdozawaProximitySubsystem>();
+
+	if (InstanceData.TargetPlayerCharacter && Enemy && Proximity && Enemy->GetProximityHandle() != INDEX_NONE)
+	{
+		InstanceData.DistanceToTarget = FMath::Sqrt(Proximity->GetDistanceSquaredToPlayer(Enemy->GetProximityHandle()));
+		InstanceData.RangeBand = Proximity->GetRangeBand(Enemy->GetProximityHandle());
+
+	} else {
+
+		// fall back to the distance to the last known location
+		InstanceData.DistanceToTarget = FVector::Distance(InstanceData.TargetPlayerLocation, InstanceData.Character->GetActorLocation());
+		InstanceData.RangeBand = EBdozawaProximityBand::Outside;
+	}
 
 	return EStateTreeRunStatus::Running;
 }
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "StateTreeTaskBase.h"
 #include "StateTreeConditionBase.h"
+#include "BdozawaProximitySubsystem.h"
 
 #include "CombatStateTreeUtility.generated.h"
 
@@ -288,6 +289,18 @@ struct FStateTreeGetPlayerInfoInstanceData
 	/** Distance to the target */
 	UPROPERTY(VisibleAnywhere)
 	float DistanceToTarget = 0.0f;
+
+	/** Range band of the distance to the target */
+	UPROPERTY(VisibleAnywhere)
+	EBdozawaProximityBand RangeBand = EBdozawaProximityBand::Outside;
+
+	/** If true, the target is only set while the character's controller perceives the player, and the location is where it was last seen */
+	UPROPERTY(EditAnywhere, Category = Parameter)
+	bool bRequireLineOfSight = false;
+
+	/** True if the controller's last sight check saw the player */
+	UPROPERTY(VisibleAnywhere)
+	bool bCanSeeTarget = false;
 };
 
 /**
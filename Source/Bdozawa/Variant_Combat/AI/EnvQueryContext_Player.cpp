@@ -2,17 +2,19 @@
 
 
 #include "EnvQueryContext_Player.h"
-#include "Kismet/GameplayStatics.h"
+#include "BdozawaPlayerSnapshotSubsystem.h"
+#include "Engine/World.h"
 #include "EnvironmentQuery/EnvQueryTypes.h"
 #include "EnvironmentQuery/Items/EnvQueryItemType_Actor.h"
 #include "GameFramework/Pawn.h"
 
 void UEnvQueryContext_Player::ProvideContext(FEnvQueryInstance& QueryInstance, FEnvQueryContextData& ContextData) const
 {
-	// get the player pawn for the first local player
-	AActor* PlayerPawn = UGameplayStatics::GetPlayerPawn(QueryInstance.Owner.Get(), 0);
-	check(PlayerPawn);
+	// get the player pawn for the first player from this frame's player snapshot
+	UBdozawaPlayerSnapshotSubsystem* PlayerSnapshot = QueryInstance.World ? QueryInstance.World->GetSubsystem<UBdozawaPlayerSnapshotSubsystem>() : nullptr;
+	const FBdozawaPlayerSnapshotEntry* Player = PlayerSnapshot ? PlayerSnapshot->GetSnapshot().GetFirstPlayer() : nullptr;
+	check(Player);
 
 	// add the actor data to the context
-	UEnvQueryItemType_Actor::SetContextHelper(ContextData, PlayerPawn);
+	UEnvQueryItemType_Actor::SetContextHelper(ContextData, Player->Pawn);
 }
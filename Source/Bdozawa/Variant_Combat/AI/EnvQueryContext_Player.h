@@ -8,7 +8,7 @@
 
 /**
  *  UEnvQueryContext_Player
- *  Basic EnvQuery Context that returns the first local player
+ *  Basic EnvQuery Context that returns the first player, read from the per-frame player snapshot
  */
 UCLASS()
 class UEnvQueryContext_Player : public UEnvQueryContext
@@ -3,12 +3,22 @@
 
 #include "AnimNotify_DoAttackTrace.h"
 #include "CombatAttacker.h"
+#include "CombatTraceSubsystem.h"
 #include "Components/SkeletalMeshComponent.h"
 
 void UAnimNotify_DoAttackTrace::Notify(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference)
 {
+	// defer the notify to the combat notify queue if enabled. It will be dispatched on the game thread along with the rest of the frame's notifies
+	if (UCombatTraceSubsystem::IsNotifyQueueEnabled() && UCombatTraceSubsystem::EnqueueNotify(MeshComp, ECombatNotifyType::AttackTrace, AttackBoneName))
+	{
+		return;
+	}
+
 	// cast the owner to the attacker interface
-	if (ICombatAttacker* AttackerInterface = Cast<ICombatAttacker>(MeshComp->GetOwner()))
+	ICombatAttacker* AttackerInterface = Cast<ICombatAttacker>(MeshComp->GetOwner());
+
+	// skip the notify if the attack timing is being driven by an attack timeline
+	if (AttackerInterface && !AttackerInterface->IsAttackTimelineActive())
 	{
 		AttackerInterface->DoAttackTrace(AttackBoneName);
 	}
@@ -0,0 +1,118 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatAttackTimeline.h"
+#include "Animation/AnimMontage.h"
+#include "AnimNotify_DoAttackTrace.h"
+#include "AnimNotify_CheckCombo.h"
+#include "AnimNotify_CheckChargedAttack.h"
+#include "UObject/ObjectSaveContext.h"
+
+int32 UCombatAttackTimeline::FindSection(FName SectionName) const
+{
+	return Sections.IndexOfByPredicate([SectionName](const FCombatTimelineSection& Section) { return Section.SectionName == SectionName; });
+}
+
+#if WITH_EDITOR
+
+void UCombatAttackTimeline::ExtractFromMontage()
+{
+	if (SourceMontage)
+	{
+		Modify();
+		BuildFromMontage();
+	}
+}
+
+void UCombatAttackTimeline::BuildFromMontage()
+{
+	RateScale = SourceMontage->RateScale;
+
+	// copy the section layout
+	Sections.Reset();
+
+	for (int32 i = 0; i < SourceMontage->CompositeSections.Num(); ++i)
+	{
+		const FCompositeSection& MontageSection = SourceMontage->CompositeSections[i];
+
+		FCombatTimelineSection& NewSection = Sections.AddDefaulted_GetRef();
+		NewSection.SectionName = MontageSection.SectionName;
+		NewSection.NextSectionName = MontageSection.NextSectionName;
+		NewSection.Length = SourceMontage->GetSectionLength(i);
+	}
+
+	// gather the combat notifies, tagged with their section
+	TArray<TPair<int32, FCombatTimelineEvent>> SectionEvents;
+
+	for (const FAnimNotifyEvent& NotifyEvent : SourceMontage->Notifies)
+	{
+		FCombatTimelineEvent NewEvent;
+
+		if (const UAnimNotify_DoAttackTrace* AttackTraceNotify = Cast<UAnimNotify_DoAttackTrace>(NotifyEvent.Notify))
+		{
+			NewEvent.Type = ECombatTimelineEventType::AttackTrace;
+			NewEvent.AttackBoneName = AttackTraceNotify->GetAttackBoneName();
+
+		} else if (Cast<UAnimNotify_CheckCombo>(NotifyEvent.Notify)) {
+
+			NewEvent.Type = ECombatTimelineEventType::CheckCombo;
+
+		} else if (Cast<UAnimNotify_CheckChargedAttack>(NotifyEvent.Notify)) {
+
+			NewEvent.Type = ECombatTimelineEventType::CheckChargedAttack;
+
+		} else {
+
+			// not a combat notify
+			continue;
+		}
+
+		// find the section the notify belongs to
+		const float TriggerTime = NotifyEvent.GetTriggerTime();
+		const int32 SectionIndex = SourceMontage->GetSectionIndexFromPosition(TriggerTime);
+
+		if (!Sections.IsValidIndex(SectionIndex))
+		{
+			continue;
+		}
+
+		NewEvent.Time = TriggerTime - SourceMontage->CompositeSections[SectionIndex].GetTime();
+
+		SectionEvents.Emplace(SectionIndex, NewEvent);
+	}
+
+	// sort the events by section and time
+	SectionEvents.Sort([](const TPair<int32, FCombatTimelineEvent>& A, const TPair<int32, FCombatTimelineEvent>& B)
+	{
+		return A.Key != B.Key ? A.Key < B.Key : A.Value.Time < B.Value.Time;
+	});
+
+	// flatten the events and point each section at its range
+	Events.Reset();
+
+	for (const TPair<int32, FCombatTimelineEvent>& CurrentEvent : SectionEvents)
+	{
+		FCombatTimelineSection& Section = Sections[CurrentEvent.Key];
+
+		if (Section.NumEvents == 0)
+		{
+			Section.FirstEvent = Events.Num();
+		}
+
+		++Section.NumEvents;
+		Events.Add(CurrentEvent.Value);
+	}
+}
+
+void UCombatAttackTimeline::PreSave(FObjectPreSaveContext SaveContext)
+{
+	// refresh the timeline so it never drifts from the montage
+	if (SourceMontage)
+	{
+		BuildFromMontage();
+	}
+
+	Super::PreSave(SaveContext);
+}
+
+#endif
@@ -0,0 +1,134 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "CombatAttackTimeline.generated.h"
+
+class UAnimMontage;
+
+/**
+ *  Combat events that can be placed on an attack timeline. Mirrors the combat anim notifies
+ */
+UENUM(BlueprintType)
+enum class ECombatTimelineEventType : uint8
+{
+	AttackTrace,
+	CheckCombo,
+	CheckChargedAttack
+};
+
+/**
+ *  A single combat event on an attack timeline
+ */
+USTRUCT(BlueprintType)
+struct FCombatTimelineEvent
+{
+	GENERATED_BODY()
+
+	/** Time of the event, relative to the start of its section */
+	UPROPERTY(VisibleAnywhere, Category="Timeline")
+	float Time = 0.0f;
+
+	/** Combat event to trigger */
+	UPROPERTY(VisibleAnywhere, Category="Timeline")
+	ECombatTimelineEventType Type = ECombatTimelineEventType::AttackTrace;
+
+	/** Source bone for attack traces */
+	UPROPERTY(VisibleAnywhere, Category="Timeline")
+	FName AttackBoneName;
+};
+
+/**
+ *  A montage section on an attack timeline
+ */
+USTRUCT(BlueprintType)
+struct FCombatTimelineSection
+{
+	GENERATED_BODY()
+
+	/** Montage section name */
+	UPROPERTY(VisibleAnywhere, Category="Timeline")
+	FName SectionName;
+
+	/** Section to continue into once this one ends. None ends the timeline */
+	UPROPERTY(VisibleAnywhere, Category="Timeline")
+	FName NextSectionName;
+
+	/** Section length, in seconds */
+	UPROPERTY(VisibleAnywhere, Category="Timeline")
+	float Length = 0.0f;
+
+	/** Index of the section's first event */
+	UPROPERTY(VisibleAnywhere, Category="Timeline")
+	int32 FirstEvent = 0;
+
+	/** Number of events in the section */
+	UPROPERTY(VisibleAnywhere, Category="Timeline")
+	int32 NumEvents = 0;
+};
+
+/**
+ *  Compact copy of an attack montage's section layout and combat notify times.
+ *  Lets combat timing run on a game-time clock, so the montage itself becomes purely cosmetic
+ *  and skeletal animation can be throttled or skipped without affecting gameplay.
+ *  The data is extracted from the source montage in the editor and whenever the asset is saved or cooked.
+ */
+UCLASS(BlueprintType)
+class UCombatAttackTimeline : public UDataAsset
+{
+	GENERATED_BODY()
+
+protected:
+
+#if WITH_EDITORONLY_DATA
+
+	/** Montage to extract the timeline from */
+	UPROPERTY(EditAnywhere, Category="Timeline")
+	TObjectPtr<UAnimMontage> SourceMontage;
+
+#endif
+
+	/** Montage rate scale, applied to the timeline's playback */
+	UPROPERTY(VisibleAnywhere, Category="Timeline")
+	float RateScale = 1.0f;
+
+	/** Sections in montage order */
+	UPROPERTY(VisibleAnywhere, Category="Timeline")
+	TArray<FCombatTimelineSection> Sections;
+
+	/** Events sorted by section and time */
+	UPROPERTY(VisibleAnywhere, Category="Timeline")
+	TArray<FCombatTimelineEvent> Events;
+
+public:
+
+	/** Returns the montage rate scale */
+	float GetRateScale() const { return RateScale; }
+
+	/** Returns the sections */
+	const TArray<FCombatTimelineSection>& GetSections() const { return Sections; }
+
+	/** Returns the events */
+	const TArray<FCombatTimelineEvent>& GetEvents() const { return Events; }
+
+	/** Returns the index of the named section, or INDEX_NONE if it's not found */
+	int32 FindSection(FName SectionName) const;
+
+#if WITH_EDITOR
+
+	/** Rebuilds the timeline from the source montage's sections and combat notifies */
+	UFUNCTION(CallInEditor, Category="Timeline")
+	void ExtractFromMontage();
+
+	/** Keeps the timeline in sync with the montage when saving and cooking */
+	virtual void PreSave(FObjectPreSaveContext SaveContext) override;
+
+protected:
+
+	/** Copies the sections and combat notifies from the source montage */
+	void BuildFromMontage();
+
+#endif
+};
@@ -11,10 +11,19 @@
 #include "EnhancedInputSubsystems.h"
 #include "EnhancedInputComponent.h"
 #include "CombatLifeBar.h"
+#include "CombatLifeBarSubsystem.h"
 #include "Engine/DamageEvents.h"
 #include "TimerManager.h"
 #include "Engine/LocalPlayer.h"
 #include "CombatPlayerController.h"
+#include "CombatBroadphaseSubsystem.h"
+#include "CombatSimulationSubsystem.h"
+#include "CombatFactionComponent.h"
+#include "CombatHurtboxComponent.h"
+#include "CombatAttackTimelineComponent.h"
+#include "CombatMeleeComponent.h"
+#include "CombatCheckpointSubsystem.h"
+#include "BdozawaSpawnPointSubsystem.h"
 
 ACombatCharacter::ACombatCharacter()
 {
@@ -47,6 +56,20 @@ ACombatCharacter::ACombatCharacter()
 	LifeBar = CreateDefaultSubobject<UWidgetComponent>(TEXT("LifeBar"));
 	LifeBar->SetupAttachment(RootComponent);
 
+	// create the faction component. Players can damage enemies and neutral props
+	Faction = CreateDefaultSubobject<UCombatFactionComponent>(TEXT("Faction"));
+	Faction->SetFaction(ECombatFaction::Player, ECombatFaction::Enemy | ECombatFaction::Neutral);
+
+	// create the hurtbox component
+	Hurtbox = CreateDefaultSubobject<UCombatHurtboxComponent>(TEXT("Hurtbox"));
+
+	// create the attack timeline component
+	AttackTimeline = CreateDefaultSubobject<UCombatAttackTimelineComponent>(TEXT("AttackTimeline"));
+
+	// create the melee component
+	Melee = CreateDefaultSubobject<UCombatMeleeComponent>(TEXT("Melee"));
+	Melee->SetPolicy(ECombatMeleePolicy::Player);
+
 	// set the player tag
 	Tags.Add(FName("Player"));
 }
@@ -118,11 +141,13 @@ void ACombatCharacter::DoLook(float Yaw, float Pitch)
 
 void ACombatCharacter::DoComboAttackStart()
 {
+	FCombatSimulation& Simulation = GetCombatSimulation();
+
 	// are we already playing an attack animation?
-	if (bIsAttacking)
+	if (Simulation.IsAttacking(CombatantIndex))
 	{
 		// cache the input time so we can check it later
-		CachedAttackInputTime = GetWorld()->GetTimeSeconds();
+		Simulation.CacheAttackInput(CombatantIndex, GetWorld()->GetTimeSeconds());
 
 		return;
 	}
@@ -138,13 +163,15 @@ void ACombatCharacter::DoComboAttackEnd()
 
 void ACombatCharacter::DoChargedAttackStart()
 {
+	FCombatSimulation& Simulation = GetCombatSimulation();
+
 	// raise the charging attack flag
-	bIsChargingAttack = true;
+	Simulation.SetChargingAttack(CombatantIndex, true);
 
-	if (bIsAttacking)
+	if (Simulation.IsAttacking(CombatantIndex))
 	{
 		// cache the input time so we can check it later
-		CachedAttackInputTime = GetWorld()->GetTimeSeconds();
+		Simulation.CacheAttackInput(CombatantIndex, GetWorld()->GetTimeSeconds());
 
 		return;
 	}
@@ -154,176 +181,185 @@ void ACombatCharacter::DoChargedAttackStart()
 
 void ACombatCharacter::DoChargedAttackEnd()
 {
+	FCombatSimulation& Simulation = GetCombatSimulation();
+
 	// lower the charging attack flag
-	bIsChargingAttack = false;
+	Simulation.SetChargingAttack(CombatantIndex, false);
 
 	// if we've done the charge loop at least once, release the charged attack right away
-	if (bHasLoopedChargedAttack)
+	if (Simulation.HasLoopedChargedAttack(CombatantIndex))
 	{
 		CheckChargedAttack();
 	}
 }
 
+FCombatSimulation& ACombatCharacter::GetCombatSimulation() const
+{
+	return GetWorld()->GetSubsystem<UCombatSimulationSubsystem>()->GetSimulation();
+}
+
 void ACombatCharacter::ResetHP()
 {
+	FCombatSimulation& Simulation = GetCombatSimulation();
+
 	// reset the current HP total
-	CurrentHP = MaxHP;
+	Simulation.SetMaxHP(CombatantIndex, MaxHP);
+	Simulation.ResetHP(CombatantIndex);
+	CurrentHP = Simulation.GetHP(CombatantIndex);
 
 	// update the life bar
-	LifeBarWidget->SetLifePercentage(1.0f);
+	SetLifeBarPercentage(1.0f);
 }
 
 void ACombatCharacter::ComboAttack()
 {
-	// raise the attacking flag
-	bIsAttacking = true;
-
-	// reset the combo count
-	ComboCount = 0;
+	// raise the attacking flag and reset the combo count
+	GetCombatSimulation().StartComboAttack(CombatantIndex);
 
 	// play the attack montage
 	if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
 	{
 		const float MontageLength = AnimInstance->Montage_Play(ComboAttackMontage, 1.0f, EMontagePlayReturnType::MontageLength, 0.0f, true);
 
-		// subscribe to montage completed and interrupted events
-		if (MontageLength > 0.0f)
+		// subscribe to montage completed and interrupted events, unless the attack timeline is driving the attack
+		if (MontageLength > 0.0f && !ComboAttackTimeline)
 		{
 			// set the end delegate for the montage
 			AnimInstance->Montage_SetEndDelegate(OnAttackMontageEnded, ComboAttackMontage);
 		}
 	}
 
+	// run the attack timing from the timeline if we have one
+	if (ComboAttackTimeline)
+	{
+		AttackTimeline->Play(ComboAttackTimeline);
+	}
+
 }
 
 void ACombatCharacter::ChargedAttack()
 {
-	// raise the attacking flag
-	bIsAttacking = true;
-
-	// reset the charge loop flag
-	bHasLoopedChargedAttack = false;
+	// raise the attacking flag and reset the charge loop flag
+	GetCombatSimulation().StartChargedAttack(CombatantIndex);
 
 	// play the charged attack montage
 	if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
 	{
 		const float MontageLength = AnimInstance->Montage_Play(ChargedAttackMontage, 1.0f, EMontagePlayReturnType::MontageLength, 0.0f, true);
 
-		// subscribe to montage completed and interrupted events
-		if (MontageLength > 0.0f)
+		// subscribe to montage completed and interrupted events, unless the attack timeline is driving the attack
+		if (MontageLength > 0.0f && !ChargedAttackTimeline)
 		{
 			// set the end delegate for the montage
 			AnimInstance->Montage_SetEndDelegate(OnAttackMontageEnded, ChargedAttackMontage);
 		}
 	}
+
+	// run the attack timing from the timeline if we have one
+	if (ChargedAttackTimeline)
+	{
+		AttackTimeline->Play(ChargedAttackTimeline);
+	}
 }
 
 void ACombatCharacter::AttackMontageEnded(UAnimMontage* Montage, bool bInterrupted)
 {
-	// reset the attacking flag
-	bIsAttacking = false;
-
-	// check if we have a non-stale cached input
-	if (GetWorld()->GetTimeSeconds() - CachedAttackInputTime <= AttackInputCacheTimeTolerance)
+	// reset the attacking flag and check if we have a non-stale cached input
+	switch (GetCombatSimulation().EndAttack(CombatantIndex, GetWorld()->GetTimeSeconds(), AttackInputCacheTimeTolerance))
 	{
-		// are we holding the charged attack button?
-		if (bIsChargingAttack)
-		{
+		case ECombatFollowUpAttack::Charged:
+
 			// do a charged attack
 			ChargedAttack();
-		}
-		else
-		{
+			break;
+
+		case ECombatFollowUpAttack::Combo:
+
 			// do a regular attack
 			ComboAttack();
-		}
+			break;
+
+		default:
+			break;
 	}
 }
 
-void ACombatCharacter::DoAttackTrace(FName DamageSourceBone)
+void ACombatCharacter::AttackTimelineEnded(bool bInterrupted)
 {
-	// sweep for objects in front of the character to be hit by the attack
-	TArray<FHitResult> OutHits;
-
-	// start at the provided socket location, sweep forward
-	const FVector TraceStart = GetMesh()->GetSocketLocation(DamageSourceBone);
-	const FVector TraceEnd = TraceStart + (GetActorForwardVector() * MeleeTraceDistance);
-
-	// check for pawn and world dynamic collision object types
-	FCollisionObjectQueryParams ObjectParams;
-	ObjectParams.AddObjectTypesToQuery(ECC_Pawn);
-	ObjectParams.AddObjectTypesToQuery(ECC_WorldDynamic);
-
-	// use a sphere shape for the sweep
-	FCollisionShape CollisionShape;
-	CollisionShape.SetSphere(MeleeTraceRadius);
+	// the timeline owns the attack timing, so treat its end like the end of the attack montage
+	AttackMontageEnded(nullptr, bInterrupted);
+}
 
-	// ignore self
-	FCollisionQueryParams QueryParams;
-	QueryParams.AddIgnoredActor(this);
+void ACombatCharacter::JumpToAttackSection(UAnimMontage* Montage, FName SectionName)
+{
+	// jump the montage to the section so the animation stays in sync
+	if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
+	{
+		AnimInstance->Montage_JumpToSection(SectionName, Montage);
+	}
 
-	if (GetWorld()->SweepMultiByObjectType(OutHits, TraceStart, TraceEnd, FQuat::Identity, ObjectParams, CollisionShape, QueryParams))
+	// jump the timeline too if it's driving the attack
+	if (AttackTimeline->IsPlaying())
 	{
-		// iterate over each object hit
-		for (const FHitResult& CurrentHit : OutHits)
-		{
-			// check if we've hit a damageable actor
-			ICombatDamageable* Damageable = Cast<ICombatDamageable>(CurrentHit.GetActor());
+		AttackTimeline->JumpToSection(SectionName);
+	}
+}
 
-			if (Damageable)
-			{
-				// knock upwards and away from the impact normal
-				const FVector Impulse = (CurrentHit.ImpactNormal * -MeleeKnockbackImpulse) + (FVector::UpVector * MeleeLaunchImpulse);
+void ACombatCharacter::SetLifeBarPercentage(float Percent)
+{
+	if (LifeBarWidget)
+	{
+		LifeBarWidget->SetLifePercentage(Percent);
 
-				// pass the damage event to the actor
-				Damageable->ApplyDamage(MeleeDamage, this, CurrentHit.ImpactPoint, Impulse);
+	} else if (UCombatLifeBarSubsystem* LifeBars = GetWorld()->GetSubsystem<UCombatLifeBarSubsystem>()) {
 
-				// call the BP handler to play effects, etc.
-				DealtDamage(MeleeDamage, CurrentHit.ImpactPoint);
-			}
-		}
+		LifeBars->SetLifePercentage(LifeBarHandle, Percent);
 	}
 }
 
-void ACombatCharacter::CheckCombo()
+void ACombatCharacter::HideLifeBar()
 {
-	// are we playing a non-charge attack animation?
-	if (bIsAttacking && !bIsChargingAttack)
+	LifeBar->SetHiddenInGame(true);
+
+	if (UCombatLifeBarSubsystem* LifeBars = GetWorld()->GetSubsystem<UCombatLifeBarSubsystem>())
 	{
-		// is the last attack input not stale?
-		if (GetWorld()->GetTimeSeconds() - CachedAttackInputTime <= ComboInputCacheTimeTolerance)
-		{
-			// consume the attack input so we don't accidentally trigger it twice
-			CachedAttackInputTime = 0.0f;
+		LifeBars->SetLifeBarVisible(LifeBarHandle, false);
+	}
+}
 
-			// increase the combo counter
-			++ComboCount;
+bool ACombatCharacter::IsAttackTimelineActive() const
+{
+	return AttackTimeline->IsPlaying();
+}
 
-			// do we still have a combo section to play?
-			if (ComboCount < ComboSectionNames.Num())
-			{
-				// jump to the next combo section
-				if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
-				{
-					AnimInstance->Montage_JumpToSection(ComboSectionNames[ComboCount], ComboAttackMontage);
-				}
-			}
-		}
-	}
+void ACombatCharacter::DoAttackTrace(FName DamageSourceBone)
+{
+	// pass the attack to the melee component
+	Melee->DoAttackTrace(DamageSourceBone);
 }
 
-void ACombatCharacter::CheckChargedAttack()
+void ACombatCharacter::CheckCombo()
 {
-	// raise the looped charged attack flag
-	bHasLoopedChargedAttack = true;
+	// check for a non-stale attack input while playing a non-charge attack animation, and advance the combo
+	const int32 NextComboSection = GetCombatSimulation().CheckCombo(CombatantIndex, GetWorld()->GetTimeSeconds(), ComboInputCacheTimeTolerance);
 
-	// jump to either the loop or the attack section depending on whether we're still holding the charge button
-	if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
+	// do we still have a combo section to play?
+	if (ComboSectionNames.IsValidIndex(NextComboSection))
 	{
-		AnimInstance->Montage_JumpToSection(bIsChargingAttack ? ChargeLoopSection : ChargeAttackSection, ChargedAttackMontage);
+		// jump to the next combo section
+		JumpToAttackSection(ComboAttackMontage, ComboSectionNames[NextComboSection]);
 	}
 }
 
+void ACombatCharacter::CheckChargedAttack()
+{
+	// raise the looped charged attack flag and check if we're still holding the charge button
+	const bool bKeepCharging = GetCombatSimulation().CheckChargedAttack(CombatantIndex);
+
+	// jump to either the loop or the attack section
+	JumpToAttackSection(ChargedAttackMontage, bKeepCharging ? ChargeLoopSection : ChargeAttackSection);
+}
+
 void ACombatCharacter::ApplyDamage(float Damage, AActor* DamageCauser, const FVector& DamageLocation, const FVector& DamageImpulse)
 {
 	// pass the damage event to the actor
@@ -358,7 +394,7 @@ void ACombatCharacter::HandleDeath()
 	GetMesh()->SetSimulatePhysics(true);
 
 	// hide the life bar
-	LifeBar->SetHiddenInGame(true);
+	HideLifeBar();
 
 	// pull back the camera
 	GetCameraBoom()->TargetArmLength = DeathCameraDistance;
@@ -374,23 +410,100 @@ void ACombatCharacter::ApplyHealing(float Healing, AActor* Healer)
 
 void ACombatCharacter::RespawnCharacter()
 {
+	// reset the world to the state it was in at the last checkpoint
+	if (UCombatCheckpointSubsystem::IsRestoreOnRespawnEnabled())
+	{
+		if (UCombatCheckpointSubsystem* Checkpoints = GetWorld()->GetSubsystem<UCombatCheckpointSubsystem>())
+		{
+			Checkpoints->RestoreSnapshot();
+		}
+	}
+
+	// reuse this character if we know where to respawn it
+	if (UBdozawaSpawnPointSubsystem::IsInPlaceRespawnEnabled())
+	{
+		if (UBdozawaSpawnPointSubsystem* SpawnPoints = GetWorld()->GetSubsystem<UBdozawaSpawnPointSubsystem>())
+		{
+			FTransform RespawnTransform;
+
+			if (SpawnPoints->GetRespawnTransform(GetController(), RespawnTransform))
+			{
+				RespawnInPlace(RespawnTransform);
+				return;
+			}
+		}
+	}
+
 	// destroy the character and let it be respawned by the Player Controller
 	Destroy();
 }
 
+void ACombatCharacter::RespawnInPlace(const FTransform& RespawnTransform)
+{
+	GetWorld()->GetTimerManager().ClearTimer(RespawnTimer);
+
+	// cancel any attack in progress
+	AttackTimeline->Stop();
+
+	if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
+	{
+		AnimInstance->StopAllMontages(0.0f);
+	}
+
+	// turn off the ragdoll and put the mesh back where it started
+	GetMesh()->SetSimulatePhysics(false);
+	GetMesh()->SetPhysicsBlendWeight(0.0f);
+	GetMesh()->AttachToComponent(GetCapsuleComponent(), FAttachmentTransformRules::KeepRelativeTransform);
+	GetMesh()->SetRelativeTransform(MeshStartingTransform);
+
+	// move to the respawn point
+	SetActorLocationAndRotation(RespawnTransform.GetLocation(), RespawnTransform.GetRotation(), false, nullptr, ETeleportType::ResetPhysics);
+
+	if (Controller)
+	{
+		Controller->SetControlRotation(RespawnTransform.Rotator());
+	}
+
+	// restore movement
+	GetCharacterMovement()->StopMovementImmediately();
+	GetCharacterMovement()->SetDefaultMovementMode();
+
+	// bring the camera back in
+	GetCameraBoom()->TargetArmLength = DefaultCameraDistance;
+
+	// show the life bar again
+	if (LifeBarHandle != INDEX_NONE)
+	{
+		if (UCombatLifeBarSubsystem* LifeBars = GetWorld()->GetSubsystem<UCombatLifeBarSubsystem>())
+		{
+			LifeBars->SetLifeBarVisible(LifeBarHandle, true);
+		}
+
+	} else {
+
+		LifeBar->SetHiddenInGame(false);
+	}
+
+	// reset HP to maximum
+	ResetHP();
+}
+
 float ACombatCharacter::TakeDamage(float Damage, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
 {
+	FCombatSimulation& Simulation = GetCombatSimulation();
+
 	// only process damage if the character is still alive
-	if (CurrentHP <= 0.0f)
+	if (!Simulation.IsAlive(CombatantIndex))
 	{
 		return 0.0f;
 	}
 
 	// reduce the current HP
-	CurrentHP -= Damage;
+	const FCombatDamageResult Result = Simulation.ApplyDamage(CombatantIndex, Damage);
+	CurrentHP = Simulation.GetHP(CombatantIndex);
 
 	// have we run out of HP?
-	if (CurrentHP <= 0.0f)
+	if (Result.bKilled)
 	{
 		// die
 		HandleDeath();
@@ -398,7 +511,7 @@ float ACombatCharacter::TakeDamage(float Damage, struct FDamageEvent const& Dama
 	else
 	{
 		// update the life bar
-		LifeBarWidget->SetLifePercentage(CurrentHP / MaxHP);
+		SetLifeBarPercentage(Simulation.GetHPPercentage(CombatantIndex));
 
 		// enable partial ragdoll physics, but keep the pelvis vertical
 		GetMesh()->SetPhysicsBlendWeight(0.5f);
@@ -406,7 +519,7 @@ float ACombatCharacter::TakeDamage(float Damage, struct FDamageEvent const& Dama
 	}
 
 	// return the received damage amount
-	return Damage;
+	return Result.ActualDamage;
 }
 
 void ACombatCharacter::Landed(const FHitResult& Hit)
@@ -421,13 +534,62 @@ void ACombatCharacter::Landed(const FHitResult& Hit)
 	}
 }
 
+void ACombatCharacter::PostLoad()
+{
+	Super::PostLoad();
+
+#if WITH_EDITORONLY_DATA
+	// copy the melee tuning saved before it moved to the Melee component.
+	// Deprecated values still at their old defaults weren't overridden, so they leave the component alone
+	const ACombatCharacter* Defaults = GetDefault<ACombatCharacter>();
+
+	if (Melee && Defaults != this)
+	{
+		auto Migrate = [](auto DeprecatedValue, auto DefaultValue, auto& ComponentValue)
+		{
+			if (DeprecatedValue != DefaultValue)
+			{
+				ComponentValue = DeprecatedValue;
+			}
+		};
+
+		Migrate(MeleeTraceDistance_DEPRECATED, Defaults->MeleeTraceDistance_DEPRECATED, Melee->MeleeTraceDistance);
+		Migrate(MeleeTraceRadius_DEPRECATED, Defaults->MeleeTraceRadius_DEPRECATED, Melee->MeleeTraceRadius);
+		Migrate(bUseCombatBroadphase_DEPRECATED, Defaults->bUseCombatBroadphase_DEPRECATED, Melee->bUseCombatBroadphase);
+		Migrate(bTraceHurtboxes_DEPRECATED, Defaults->bTraceHurtboxes_DEPRECATED, Melee->bTraceHurtboxes);
+		Migrate(MeleeDamage_DEPRECATED, Defaults->MeleeDamage_DEPRECATED, Melee->MeleeDamage);
+		Migrate(MeleeKnockbackImpulse_DEPRECATED, Defaults->MeleeKnockbackImpulse_DEPRECATED, Melee->MeleeKnockbackImpulse);
+		Migrate(MeleeLaunchImpulse_DEPRECATED, Defaults->MeleeLaunchImpulse_DEPRECATED, Melee->MeleeLaunchImpulse);
+	}
+#endif // WITH_EDITORONLY_DATA
+}
+
 void ACombatCharacter::BeginPlay()
 {
+	// add the character to the combat simulation before BP BeginPlay runs
+	CombatantIndex = GetCombatSimulation().AddCombatant(MaxHP, ComboSectionNames.Num(), false);
+
+	// draw the life bar with the batched life bar overlay. The widget component is only kept as the bar's anchor
+	if (UCombatLifeBarSubsystem::IsBatchingEnabled())
+	{
+		if (UCombatLifeBarSubsystem* LifeBars = GetWorld()->GetSubsystem<UCombatLifeBarSubsystem>())
+		{
+			LifeBarHandle = LifeBars->RegisterLifeBar(LifeBar, LifeBarColor);
+
+			LifeBar->SetWidgetClass(nullptr);
+			LifeBar->SetTickMode(ETickMode::Disabled);
+			LifeBar->SetHiddenInGame(true);
+		}
+	}
+
 	Super::BeginPlay();
 
-	// get the life bar from the widget component
-	LifeBarWidget = Cast<UCombatLifeBar>(LifeBar->GetUserWidgetObject());
-	check(LifeBarWidget);
+	// get the life bar from the widget component, unless it's batched
+	if (LifeBarHandle == INDEX_NONE)
+	{
+		LifeBarWidget = Cast<UCombatLifeBar>(LifeBar->GetUserWidgetObject());
+		check(LifeBarWidget);
+	}
 
 	// initialize the camera
 	GetCameraBoom()->TargetArmLength = DefaultCameraDistance;
@@ -436,10 +598,25 @@ void ACombatCharacter::BeginPlay()
 	MeshStartingTransform = GetMesh()->GetRelativeTransform();
 
 	// set the life bar color
-	LifeBarWidget->SetBarColor(LifeBarColor);
+	if (LifeBarWidget)
+	{
+		LifeBarWidget->SetBarColor(LifeBarColor);
+	}
 
 	// reset HP to maximum
 	ResetHP();
+
+	// subscribe to the attack timeline end
+	AttackTimeline->OnTimelineEnded.BindUObject(this, &ACombatCharacter::AttackTimelineEnded);
+
+	// play damage dealt effects for melee hits
+	Melee->OnDamageDealt.BindUObject(this, &ACombatCharacter::DealtDamage);
+
+	// add the character to the combat broadphase
+	if (UCombatBroadphaseSubsystem* Broadphase = GetWorld()->GetSubsystem<UCombatBroadphaseSubsystem>())
+	{
+		Broadphase->RegisterDamageable(this, GetCapsuleComponent());
+	}
 }
 
 void ACombatCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
@@ -448,6 +625,25 @@ void ACombatCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
 
 	// clear the respawn timer
 	GetWorld()->GetTimerManager().ClearTimer(RespawnTimer);
+
+	// remove the character from the combat simulation
+	if (UCombatSimulationSubsystem* SimulationSubsystem = GetWorld()->GetSubsystem<UCombatSimulationSubsystem>())
+	{
+		SimulationSubsystem->GetSimulation().RemoveCombatant(CombatantIndex);
+		CombatantIndex = INDEX_NONE;
+	}
+
+	// remove the character from the combat broadphase
+	if (UCombatBroadphaseSubsystem* Broadphase = GetWorld()->GetSubsystem<UCombatBroadphaseSubsystem>())
+	{
+		Broadphase->UnregisterDamageable(this);
+	}
+
+	// remove the bar from the batched life bar overlay
+	if (UCombatLifeBarSubsystem* LifeBars = GetWorld()->GetSubsystem<UCombatLifeBarSubsystem>())
+	{
+		LifeBars->UnregisterLifeBar(LifeBarHandle);
+	}
 }
 
 void ACombatCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
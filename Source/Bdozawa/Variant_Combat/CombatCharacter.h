@@ -15,6 +15,12 @@ class UInputAction;
 struct FInputActionValue;
 class UCombatLifeBar;
 class UWidgetComponent;
+class UCombatFactionComponent;
+class UCombatHurtboxComponent;
+class UCombatAttackTimelineComponent;
+class UCombatAttackTimeline;
+class UCombatMeleeComponent;
+class FCombatSimulation;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogCombatCharacter, Log, All);
 
@@ -42,6 +48,46 @@ class ACombatCharacter : public ACharacter, public ICombatAttacker, public IComb
 	/** Life bar widget component */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components", meta = (AllowPrivateAccess = "true"))
 	UWidgetComponent* LifeBar;
+
+	/** Combat faction component */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components", meta = (AllowPrivateAccess = "true"))
+	UCombatFactionComponent* Faction;
+
+	/** Combat hurtbox component */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components", meta = (AllowPrivateAccess = "true"))
+	UCombatHurtboxComponent* Hurtbox;
+
+	/** Attack timeline playback component */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components", meta = (AllowPrivateAccess = "true"))
+	UCombatAttackTimelineComponent* AttackTimeline;
+
+	/** Melee attack component. Owns the melee trace and damage tuning */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components", meta = (AllowPrivateAccess = "true"))
+	UCombatMeleeComponent* Melee;
+
+#if WITH_EDITORONLY_DATA
+	/** Deprecated melee tuning, migrated to the Melee component on load */
+	UPROPERTY()
+	float MeleeTraceDistance_DEPRECATED = 75.0f;
+
+	UPROPERTY()
+	float MeleeTraceRadius_DEPRECATED = 75.0f;
+
+	UPROPERTY()
+	bool bUseCombatBroadphase_DEPRECATED = false;
+
+	UPROPERTY()
+	bool bTraceHurtboxes_DEPRECATED = true;
+
+	UPROPERTY()
+	float MeleeDamage_DEPRECATED = 1.0f;
+
+	UPROPERTY()
+	float MeleeKnockbackImpulse_DEPRECATED = 250.0f;
+
+	UPROPERTY()
+	float MeleeLaunchImpulse_DEPRECATED = 300.0f;
+#endif // WITH_EDITORONLY_DATA
 	
 protected:
 
@@ -85,39 +131,19 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Damage")
 	FName PelvisBoneName;
 
-	/** Pointer to the life bar widget */
+	/** Pointer to the life bar widget. Null if the life bar is drawn by the batched life bar overlay */
 	UPROPERTY(EditAnywhere, Category="Damage")
 	TObjectPtr<UCombatLifeBar> LifeBarWidget;
 
+	/** Handle to this character's bar in the batched life bar overlay */
+	int32 LifeBarHandle = INDEX_NONE;
+
 	/** Max amount of time that may elapse for a non-combo attack input to not be considered stale */
 	UPROPERTY(EditAnywhere, Category="Melee Attack", meta = (ClampMin = 0, ClampMax = 5, Units = "s"))
 	float AttackInputCacheTimeTolerance = 1.0f;
 
-	/** Time at which an attack button was last pressed */
-	float CachedAttackInputTime = 0.0f;
-
-	/** If true, the character is currently playing an attack animation */
-	bool bIsAttacking = false;
-
-	/** Distance ahead of the character that melee attack sphere collision traces will extend */
-	UPROPERTY(EditAnywhere, Category="Melee Attack|Trace", meta = (ClampMin = 0, ClampMax = 500, Units="cm"))
-	float MeleeTraceDistance = 75.0f;
-
-	/** Radius of the sphere trace for melee attacks */
-	UPROPERTY(EditAnywhere, Category="Melee Attack|Trace", meta = (ClampMin = 0, ClampMax = 200, Units = "cm"))
-	float MeleeTraceRadius = 75.0f;
-
-	/** Amount of damage a melee attack will deal */
-	UPROPERTY(EditAnywhere, Category="Melee Attack|Damage", meta = (ClampMin = 0, ClampMax = 100))
-	float MeleeDamage = 1.0f;
-
-	/** Amount of knockback impulse a melee attack will apply */
-	UPROPERTY(EditAnywhere, Category="Melee Attack|Damage", meta = (ClampMin = 0, ClampMax = 1000, Units = "cm/s"))
-	float MeleeKnockbackImpulse = 250.0f;
-
-	/** Amount of upwards impulse a melee attack will apply */
-	UPROPERTY(EditAnywhere, Category="Melee Attack|Damage", meta = (ClampMin = 0, ClampMax = 1000, Units = "cm/s"))
-	float MeleeLaunchImpulse = 300.0f;
+	/** Index of this character's HP and attack state in the combat simulation */
+	int32 CombatantIndex = INDEX_NONE;
 
 	/** AnimMontage that will play for combo attacks */
 	UPROPERTY(EditAnywhere, Category="Melee Attack|Combo")
@@ -127,13 +153,14 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Melee Attack|Combo")
 	TArray<FName> ComboSectionNames;
 
+	/** Optional timeline extracted from the combo attack montage. If set, combo attack timing runs from it instead of the montage's notifies */
+	UPROPERTY(EditAnywhere, Category="Melee Attack|Combo")
+	UCombatAttackTimeline* ComboAttackTimeline;
+
 	/** Max amount of time that may elapse for a combo attack input to not be considered stale */
 	UPROPERTY(EditAnywhere, Category="Melee Attack|Combo", meta = (ClampMin = 0, ClampMax = 5, Units = "s"))
 	float ComboInputCacheTimeTolerance = 0.45f;
 
-	/** Index of the current stage of the melee attack combo */
-	int32 ComboCount = 0;
-
 	/** AnimMontage that will play for charged attacks */
 	UPROPERTY(EditAnywhere, Category="Melee Attack|Charged")
 	UAnimMontage* ChargedAttackMontage;
@@ -146,11 +173,9 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Melee Attack|Charged")
 	FName ChargeAttackSection;
 
-	/** Flag that determines if the player is currently holding the charged attack input */
-	bool bIsChargingAttack = false;
-	
-	/** If true, the charged attack hold check has been tested at least once */
-	bool bHasLoopedChargedAttack = false;
+	/** Optional timeline extracted from the charged attack montage. If set, charged attack timing runs from it instead of the montage's notifies */
+	UPROPERTY(EditAnywhere, Category="Melee Attack|Charged")
+	UCombatAttackTimeline* ChargedAttackTimeline;
 
 	/** Camera boom length while the character is dead */
 	UPROPERTY(EditAnywhere, Category="Camera", meta = (ClampMin = 0, ClampMax = 1000, Units = "cm"))
@@ -178,6 +203,9 @@ public:
 	/** Constructor */
 	ACombatCharacter();
 
+	/** Migrates deprecated melee tuning to the Melee component */
+	virtual void PostLoad() override;
+
 protected:
 
 	/** Called for movement input */
@@ -223,6 +251,9 @@ public:
 
 protected:
 
+	/** Returns the combat simulation holding this character's HP and attack state */
+	FCombatSimulation& GetCombatSimulation() const;
+
 	/** Resets the character's current HP to maximum */
 	void ResetHP();
 
@@ -235,6 +266,17 @@ protected:
 	/** Called from a delegate when the attack montage ends */
 	void AttackMontageEnded(UAnimMontage* Montage, bool bInterrupted);
 
+	/** Called from a delegate when the attack timeline ends */
+	void AttackTimelineEnded(bool bInterrupted);
+
+	/** Jumps to a section in both the attack montage and the attack timeline */
+	void JumpToAttackSection(UAnimMontage* Montage, FName SectionName);
+
+	/** Updates the life bar fill, on either the widget or the batched life bar overlay */
+	void SetLifeBarPercentage(float Percent);
+
+	/** Hides the life bar */
+	void HideLifeBar();
 	
 public:
 
@@ -249,6 +291,9 @@ public:
 	/** Performs the charged attack hold check */
 	virtual void CheckChargedAttack() override;
 
+	/** Returns true while attack timing is being driven by an attack timeline */
+	virtual bool IsAttackTimelineActive() const override;
+
 	// ~end CombatAttacker interface
 
 	// ~begin CombatDamageable interface
@@ -264,9 +309,12 @@ public:
 
 	// ~end CombatDamageable interface
 
-	/** Called from the respawn timer to destroy and re-create the character */
+	/** Called from the respawn timer to reset the character in place, or destroy it so it's re-created */
 	void RespawnCharacter();
 
+	/** Resets HP, ragdoll, movement and camera, and teleports the character to the respawn transform */
+	void RespawnInPlace(const FTransform& RespawnTransform);
+
 public:
 
 	/** Overrides the default TakeDamage functionality */
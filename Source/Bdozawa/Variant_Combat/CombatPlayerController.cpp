@@ -4,9 +4,8 @@
 #include "Variant_Combat/CombatPlayerController.h"
 #include "EnhancedInputSubsystems.h"
 #include "InputMappingContext.h"
-#include "Kismet/GameplayStatics.h"
-#include "GameFramework/PlayerStart.h"
 #include "CombatCharacter.h"
+#include "BdozawaSpawnPointSubsystem.h"
 #include "Engine/LocalPlayer.h"
 #include "Engine/World.h"
 #include "Blueprint/UserWidget.h"
@@ -72,12 +71,24 @@ void ACombatPlayerController::OnPossess(APawn* InPawn)
 
 void ACombatPlayerController::SetRespawnTransform(const FTransform& NewRespawn)
 {
-	// save the new respawn transform
-	RespawnTransform = NewRespawn;
+	// save the new respawn transform as our checkpoint
+	if (UBdozawaSpawnPointSubsystem* SpawnPoints = GetWorld()->GetSubsystem<UBdozawaSpawnPointSubsystem>())
+	{
+		SpawnPoints->SetCheckpoint(this, NewRespawn);
+	}
 }
 
 void ACombatPlayerController::OnPawnDestroyed(AActor* DestroyedActor)
 {
+	// find the checkpoint or player start to respawn at
+	UBdozawaSpawnPointSubsystem* SpawnPoints = GetWorld()->GetSubsystem<UBdozawaSpawnPointSubsystem>();
+	FTransform RespawnTransform;
+
+	if (!SpawnPoints || !SpawnPoints->GetRespawnTransform(this, RespawnTransform))
+	{
+		return;
+	}
+
 	// spawn a new character at the respawn transform
 	if (ACombatCharacter* RespawnedCharacter = GetWorld()->SpawnActor<ACombatCharacter>(CharacterClass, RespawnTransform))
 	{
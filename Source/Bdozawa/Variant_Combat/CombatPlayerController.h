@@ -12,7 +12,8 @@ class ACombatCharacter;
 /**
  *  Simple Player Controller for a third person combat game
  *  Manages input mappings
- *  Respawns the player character at the checkpoint when it's destroyed
+ *  Respawns the player character at the checkpoint when it's destroyed.
+ *  Checkpoints are kept in the spawn point registry
  */
 UCLASS(abstract)
 class ACombatPlayerController : public APlayerController
@@ -40,9 +41,6 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Respawn")
 	TSubclassOf<ACombatCharacter> CharacterClass;
 
-	/** Transform to respawn the character at. Can be set to create checkpoints */
-	FTransform RespawnTransform;
-
 protected:
 
 	/** Gameplay initialization */
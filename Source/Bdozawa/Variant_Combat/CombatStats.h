@@ -0,0 +1,9 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+/** Stat group for the combat variant gameplay systems. Use "stat Combat" to display it */
+DECLARE_STATS_GROUP(TEXT("Combat"), STATGROUP_Combat, STATCAT_Advanced);
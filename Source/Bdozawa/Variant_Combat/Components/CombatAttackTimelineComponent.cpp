@@ -0,0 +1,157 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatAttackTimelineComponent.h"
+#include "CombatAttackTimeline.h"
+#include "CombatAttacker.h"
+#include "GameFramework/Actor.h"
+
+UCombatAttackTimelineComponent::UCombatAttackTimelineComponent()
+{
+	// only tick while a timeline is playing
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+}
+
+void UCombatAttackTimelineComponent::Play(UCombatAttackTimeline* InTimeline)
+{
+	if (!InTimeline || InTimeline->GetSections().IsEmpty())
+	{
+		return;
+	}
+
+	Timeline = InTimeline;
+	EnterSection(0);
+
+	SetComponentTickEnabled(true);
+}
+
+void UCombatAttackTimelineComponent::JumpToSection(FName SectionName)
+{
+	if (!Timeline)
+	{
+		return;
+	}
+
+	const int32 SectionIndex = Timeline->FindSection(SectionName);
+
+	if (SectionIndex != INDEX_NONE)
+	{
+		EnterSection(SectionIndex);
+	}
+}
+
+void UCombatAttackTimelineComponent::Stop()
+{
+	if (Timeline)
+	{
+		EndPlayback(true);
+	}
+}
+
+void UCombatAttackTimelineComponent::EnterSection(int32 SectionIndex)
+{
+	CurrentSection = SectionIndex;
+	NextEvent = Timeline->GetSections()[SectionIndex].FirstEvent;
+	SectionPosition = 0.0f;
+
+	++PlaybackSerial;
+}
+
+void UCombatAttackTimelineComponent::EndPlayback(bool bInterrupted)
+{
+	// reset the playback state before calling the delegate, so handlers can start a new timeline
+	Timeline = nullptr;
+	CurrentSection = INDEX_NONE;
+
+	++PlaybackSerial;
+
+	SetComponentTickEnabled(false);
+
+	OnTimelineEnded.ExecuteIfBound(bInterrupted);
+}
+
+void UCombatAttackTimelineComponent::TriggerEvent(int32 EventIndex)
+{
+	ICombatAttacker* Attacker = Cast<ICombatAttacker>(GetOwner());
+
+	if (!Attacker)
+	{
+		return;
+	}
+
+	const FCombatTimelineEvent& Event = Timeline->GetEvents()[EventIndex];
+
+	switch (Event.Type)
+	{
+		case ECombatTimelineEventType::AttackTrace:
+			Attacker->DoAttackTrace(Event.AttackBoneName);
+			break;
+
+		case ECombatTimelineEventType::CheckCombo:
+			Attacker->CheckCombo();
+			break;
+
+		case ECombatTimelineEventType::CheckChargedAttack:
+			Attacker->CheckChargedAttack();
+			break;
+	}
+}
+
+void UCombatAttackTimelineComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (!Timeline)
+	{
+		return;
+	}
+
+	SectionPosition += DeltaTime * Timeline->GetRateScale();
+
+	while (Timeline)
+	{
+		const FCombatTimelineSection& Section = Timeline->GetSections()[CurrentSection];
+
+		// trigger all events we've passed in this section
+		while (NextEvent < Section.FirstEvent + Section.NumEvents && Timeline->GetEvents()[NextEvent].Time <= SectionPosition)
+		{
+			const uint32 EventSerial = PlaybackSerial;
+
+			TriggerEvent(NextEvent++);
+
+			// the event handler jumped, stopped or restarted the timeline, so resume from the new position next frame
+			if (EventSerial != PlaybackSerial)
+			{
+				return;
+			}
+		}
+
+		// are we still within the section?
+		if (SectionPosition < Section.Length)
+		{
+			return;
+		}
+
+		// guard against empty sections linking to each other
+		if (Section.Length <= UE_KINDA_SMALL_NUMBER)
+		{
+			EndPlayback(false);
+			return;
+		}
+
+		// continue into the linked section, carrying over the extra time
+		const float Overflow = SectionPosition - Section.Length;
+		const int32 NextSection = Timeline->FindSection(Section.NextSectionName);
+
+		if (NextSection == INDEX_NONE)
+		{
+			// the timeline has finished
+			EndPlayback(false);
+			return;
+		}
+
+		EnterSection(NextSection);
+		SectionPosition = Overflow;
+	}
+}
@@ -0,0 +1,76 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "CombatAttackTimelineComponent.generated.h"
+
+class UCombatAttackTimeline;
+
+/** Called when an attack timeline finishes playing or is stopped */
+DECLARE_DELEGATE_OneParam(FOnAttackTimelineEnded, bool /* bInterrupted */);
+
+/**
+ *  Plays attack timelines on a game-time clock and forwards their events to the owner's ICombatAttacker interface.
+ *  Replaces montage notifies as the source of combat timing, so the owner's animation can be throttled or disabled.
+ */
+UCLASS(ClassGroup = (Combat))
+class UCombatAttackTimelineComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+	/** Timeline currently playing */
+	UPROPERTY(Transient)
+	TObjectPtr<UCombatAttackTimeline> Timeline;
+
+	/** Index of the section currently playing */
+	int32 CurrentSection = INDEX_NONE;
+
+	/** Index of the next event to trigger */
+	int32 NextEvent = 0;
+
+	/** Playback position within the current section */
+	float SectionPosition = 0.0f;
+
+	/** Incremented whenever playback is started, stopped or jumps, so events can detect changes made by their handlers */
+	uint32 PlaybackSerial = 0;
+
+public:
+
+	/** Called when the timeline finishes playing or is stopped */
+	FOnAttackTimelineEnded OnTimelineEnded;
+
+public:
+
+	/** Constructor */
+	UCombatAttackTimelineComponent();
+
+	/** Starts playing a timeline from its first section. Replaces any timeline already playing */
+	void Play(UCombatAttackTimeline* InTimeline);
+
+	/** Jumps to the start of the named section */
+	void JumpToSection(FName SectionName);
+
+	/** Stops the timeline and reports it as interrupted */
+	void Stop();
+
+	/** Returns true if a timeline is playing */
+	bool IsPlaying() const { return Timeline != nullptr; }
+
+protected:
+
+	/** Starts playing the provided section */
+	void EnterSection(int32 SectionIndex);
+
+	/** Stops playback and calls the ended delegate */
+	void EndPlayback(bool bInterrupted);
+
+	/** Triggers an event on the owner */
+	void TriggerEvent(int32 EventIndex);
+
+public:
+
+	/** Advances playback */
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+};
@@ -0,0 +1,61 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatFactionComponent.h"
+#include "CombatFactionSubsystem.h"
+#include "Engine/World.h"
+
+UCombatFactionComponent::UCombatFactionComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UCombatFactionComponent::SetFaction(ECombatFaction InFaction, ECombatFaction InHostileFactions)
+{
+	Faction = static_cast<int32>(InFaction);
+	HostileFactions = static_cast<int32>(InHostileFactions);
+
+	// update the registry if we're already in play
+	if (FactionSubsystem)
+	{
+		FactionSubsystem->RegisterFaction(GetOwner(), GetFaction());
+	}
+}
+
+bool UCombatFactionComponent::IsHostileTo(const AActor* Target) const
+{
+	if (!Target)
+	{
+		return false;
+	}
+
+	// look up the target's faction and test it against our hostile mask
+	const ECombatFaction TargetFaction = FactionSubsystem ? FactionSubsystem->GetFaction(Target) : ECombatFaction::Neutral;
+
+	return (static_cast<int32>(TargetFaction) & HostileFactions) != 0;
+}
+
+void UCombatFactionComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// register the owner's faction so other actors can look it up
+	FactionSubsystem = GetWorld()->GetSubsystem<UCombatFactionSubsystem>();
+
+	if (FactionSubsystem)
+	{
+		FactionSubsystem->RegisterFaction(GetOwner(), GetFaction());
+	}
+}
+
+void UCombatFactionComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// remove the owner from the registry
+	if (FactionSubsystem)
+	{
+		FactionSubsystem->UnregisterFaction(GetOwner());
+		FactionSubsystem = nullptr;
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
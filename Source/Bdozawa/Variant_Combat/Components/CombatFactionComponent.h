@@ -0,0 +1,69 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "CombatFactionComponent.generated.h"
+
+class UCombatFactionSubsystem;
+
+/**
+ *  Combat factions. Used as bit flags so a set of hostile factions can be tested with a single mask
+ */
+UENUM(BlueprintType, meta = (Bitflags, UseEnumValuesAsMaskValuesInEditor = "true"))
+enum class ECombatFaction : uint8
+{
+	None		= 0 UMETA(Hidden),
+	Player		= 1 << 0,
+	Enemy		= 1 << 1,
+	Neutral		= 1 << 2
+};
+ENUM_CLASS_FLAGS(ECombatFaction);
+
+/**
+ *  Assigns a combat faction to its owner and decides which factions it's allowed to damage.
+ *  Owners without a faction component are treated as Neutral.
+ */
+UCLASS(ClassGroup = (Combat), meta = (BlueprintSpawnableComponent))
+class UCombatFactionComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Faction the owner belongs to */
+	UPROPERTY(EditAnywhere, Category="Faction", meta = (Bitmask, BitmaskEnum = "/Script/Bdozawa.ECombatFaction"))
+	int32 Faction = static_cast<int32>(ECombatFaction::Neutral);
+
+	/** Factions the owner is allowed to damage */
+	UPROPERTY(EditAnywhere, Category="Faction", meta = (Bitmask, BitmaskEnum = "/Script/Bdozawa.ECombatFaction"))
+	int32 HostileFactions = 0;
+
+	/** Faction registry for the owner's world */
+	UPROPERTY(Transient)
+	TObjectPtr<UCombatFactionSubsystem> FactionSubsystem;
+
+public:
+
+	/** Constructor */
+	UCombatFactionComponent();
+
+	/** Sets the owner's faction and the factions it's allowed to damage */
+	void SetFaction(ECombatFaction InFaction, ECombatFaction InHostileFactions);
+
+	/** Returns the owner's faction */
+	ECombatFaction GetFaction() const { return static_cast<ECombatFaction>(Faction); }
+
+	/** Returns true if the owner is allowed to damage the target actor */
+	UFUNCTION(BlueprintPure, Category="Faction")
+	bool IsHostileTo(const AActor* Target) const;
+
+protected:
+
+	/** Registers the owner's faction */
+	virtual void BeginPlay() override;
+
+	/** Unregisters the owner's faction */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+};
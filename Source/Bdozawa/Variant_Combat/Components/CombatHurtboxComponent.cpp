@@ -0,0 +1,156 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatHurtboxComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/Character.h"
+#include "Engine/World.h"
+#include "CombatBroadphaseSubsystem.h"
+
+UCombatHurtboxComponent::UCombatHurtboxComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+
+	// default shapes for the mannequin skeleton. Limb bones point along X, so capsules are pitched to follow them
+	AddDefaultShape(FName("head"), ECombatHurtboxZone::Head, 13.0f, 13.0f, FVector(8.0f, 2.0f, 0.0f));
+	AddDefaultShape(FName("spine_03"), ECombatHurtboxZone::Torso, 20.0f, 28.0f, FVector(5.0f, 0.0f, 0.0f));
+	AddDefaultShape(FName("pelvis"), ECombatHurtboxZone::Torso, 18.0f, 18.0f);
+	AddDefaultShape(FName("upperarm_l"), ECombatHurtboxZone::Limb, 7.0f, 16.0f, FVector(14.0f, 0.0f, 0.0f));
+	AddDefaultShape(FName("upperarm_r"), ECombatHurtboxZone::Limb, 7.0f, 16.0f, FVector(-14.0f, 0.0f, 0.0f));
+	AddDefaultShape(FName("lowerarm_l"), ECombatHurtboxZone::Limb, 6.0f, 16.0f, FVector(13.0f, 0.0f, 0.0f));
+	AddDefaultShape(FName("lowerarm_r"), ECombatHurtboxZone::Limb, 6.0f, 16.0f, FVector(-13.0f, 0.0f, 0.0f));
+	AddDefaultShape(FName("thigh_l"), ECombatHurtboxZone::Limb, 9.0f, 24.0f, FVector(21.0f, 0.0f, 0.0f));
+	AddDefaultShape(FName("thigh_r"), ECombatHurtboxZone::Limb, 9.0f, 24.0f, FVector(-21.0f, 0.0f, 0.0f));
+	AddDefaultShape(FName("calf_l"), ECombatHurtboxZone::Limb, 7.0f, 24.0f, FVector(21.0f, 0.0f, 0.0f));
+	AddDefaultShape(FName("calf_r"), ECombatHurtboxZone::Limb, 7.0f, 24.0f, FVector(-21.0f, 0.0f, 0.0f));
+}
+
+void UCombatHurtboxComponent::AddDefaultShape(FName BoneName, ECombatHurtboxZone Zone, float Radius, float HalfHeight, const FVector& Offset)
+{
+	FCombatHurtboxShape& NewShape = Shapes.AddDefaulted_GetRef();
+	NewShape.BoneName = BoneName;
+	NewShape.Zone = Zone;
+	NewShape.Radius = Radius;
+	NewShape.HalfHeight = HalfHeight;
+	NewShape.Offset = Offset;
+	NewShape.Rotation = FRotator(90.0f, 0.0f, 0.0f);
+}
+
+void UCombatHurtboxComponent::SetHurtboxesEnabled(bool bEnabled)
+{
+	for (UCombatHurtboxShapeComponent* CurrentShape : ShapeComponents)
+	{
+		if (CurrentShape)
+		{
+			CurrentShape->SetCollisionEnabled(bEnabled ? ECollisionEnabled::QueryOnly : ECollisionEnabled::NoCollision);
+		}
+	}
+}
+
+void UCombatHurtboxComponent::RegisterWithBroadphase()
+{
+	if (bRegisteredWithBroadphase || ShapeComponents.IsEmpty())
+	{
+		return;
+	}
+
+	// add the shapes to the combat broadphase so grid queries see the same shapes as physics queries
+	if (UCombatBroadphaseSubsystem* Broadphase = GetWorld()->GetSubsystem<UCombatBroadphaseSubsystem>())
+	{
+		for (UCombatHurtboxShapeComponent* CurrentShape : ShapeComponents)
+		{
+			Broadphase->RegisterDamageable(GetOwner(), CurrentShape);
+		}
+
+		bRegisteredWithBroadphase = true;
+	}
+}
+
+void UCombatHurtboxComponent::UnregisterFromBroadphase()
+{
+	if (!bRegisteredWithBroadphase)
+	{
+		return;
+	}
+
+	bRegisteredWithBroadphase = false;
+
+	if (UCombatBroadphaseSubsystem* Broadphase = GetWorld()->GetSubsystem<UCombatBroadphaseSubsystem>())
+	{
+		for (UCombatHurtboxShapeComponent* CurrentShape : ShapeComponents)
+		{
+			Broadphase->UnregisterShape(CurrentShape);
+		}
+	}
+}
+
+float UCombatHurtboxComponent::GetZoneDamageMultiplier(ECombatHurtboxZone Zone) const
+{
+	switch (Zone)
+	{
+		case ECombatHurtboxZone::Head:
+			return HeadDamageMultiplier;
+
+		case ECombatHurtboxZone::Limb:
+			return LimbDamageMultiplier;
+
+		default:
+			return TorsoDamageMultiplier;
+	}
+}
+
+void UCombatHurtboxComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// find the skeletal mesh to attach the shapes to
+	USkeletalMeshComponent* Mesh = nullptr;
+
+	if (ACharacter* CharacterOwner = Cast<ACharacter>(GetOwner()))
+	{
+		Mesh = CharacterOwner->GetMesh();
+
+	} else {
+
+		Mesh = GetOwner()->FindComponentByClass<USkeletalMeshComponent>();
+	}
+
+	if (!Mesh)
+	{
+		return;
+	}
+
+	// create the shapes
+	for (const FCombatHurtboxShape& CurrentShape : Shapes)
+	{
+		UCombatHurtboxShapeComponent* NewShape = NewObject<UCombatHurtboxShapeComponent>(GetOwner(), NAME_None, RF_Transient);
+		NewShape->SetCapsuleSize(CurrentShape.Radius, FMath::Max(CurrentShape.HalfHeight, CurrentShape.Radius));
+		NewShape->SetZone(CurrentShape.Zone, GetZoneDamageMultiplier(CurrentShape.Zone));
+		NewShape->SetupAttachment(Mesh, CurrentShape.BoneName);
+		NewShape->SetRelativeLocationAndRotation(CurrentShape.Offset, CurrentShape.Rotation);
+		NewShape->RegisterComponent();
+
+		ShapeComponents.Add(NewShape);
+	}
+
+	RegisterWithBroadphase();
+}
+
+void UCombatHurtboxComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// leave the combat broadphase
+	UnregisterFromBroadphase();
+
+	// destroy the shapes
+	for (UCombatHurtboxShapeComponent* CurrentShape : ShapeComponents)
+	{
+		if (CurrentShape)
+		{
+			CurrentShape->DestroyComponent();
+		}
+	}
+
+	ShapeComponents.Empty();
+
+	Super::EndPlay(EndPlayReason);
+}
@@ -0,0 +1,107 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "CombatHurtboxShapeComponent.h"
+#include "CombatHurtboxComponent.generated.h"
+
+class USkeletalMeshComponent;
+
+/**
+ *  Describes a hurtbox shape attached to a bone
+ */
+USTRUCT(BlueprintType)
+struct FCombatHurtboxShape
+{
+	GENERATED_BODY()
+
+	/** Bone the shape will be attached to */
+	UPROPERTY(EditAnywhere, Category="Hurtbox")
+	FName BoneName;
+
+	/** Body zone covered by the shape */
+	UPROPERTY(EditAnywhere, Category="Hurtbox")
+	ECombatHurtboxZone Zone = ECombatHurtboxZone::Torso;
+
+	/** Capsule radius */
+	UPROPERTY(EditAnywhere, Category="Hurtbox", meta = (ClampMin = 1, ClampMax = 100, Units = "cm"))
+	float Radius = 10.0f;
+
+	/** Capsule half height. Shapes with a half height equal to their radius are spheres */
+	UPROPERTY(EditAnywhere, Category="Hurtbox", meta = (ClampMin = 1, ClampMax = 200, Units = "cm"))
+	float HalfHeight = 10.0f;
+
+	/** Offset from the bone, in bone space */
+	UPROPERTY(EditAnywhere, Category="Hurtbox")
+	FVector Offset = FVector::ZeroVector;
+
+	/** Rotation from the bone, in bone space */
+	UPROPERTY(EditAnywhere, Category="Hurtbox")
+	FRotator Rotation = FRotator::ZeroRotator;
+};
+
+/**
+ *  Attaches a small set of query only shapes to named bones on the Hurtbox object channel.
+ *  Melee attacks query this channel instead of pawn capsules and skeletal mesh bodies,
+ *  and scale their damage by the body zone of the shape they hit.
+ */
+UCLASS(ClassGroup = (Combat), meta = (BlueprintSpawnableComponent))
+class UCombatHurtboxComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Shapes to attach to the owner's skeletal mesh */
+	UPROPERTY(EditAnywhere, Category="Hurtbox")
+	TArray<FCombatHurtboxShape> Shapes;
+
+	/** Damage multiplier for head hits */
+	UPROPERTY(EditAnywhere, Category="Hurtbox|Damage", meta = (ClampMin = 0, ClampMax = 10))
+	float HeadDamageMultiplier = 2.0f;
+
+	/** Damage multiplier for torso hits */
+	UPROPERTY(EditAnywhere, Category="Hurtbox|Damage", meta = (ClampMin = 0, ClampMax = 10))
+	float TorsoDamageMultiplier = 1.0f;
+
+	/** Damage multiplier for limb hits */
+	UPROPERTY(EditAnywhere, Category="Hurtbox|Damage", meta = (ClampMin = 0, ClampMax = 10))
+	float LimbDamageMultiplier = 0.75f;
+
+	/** Shape components created on BeginPlay */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UCombatHurtboxShapeComponent>> ShapeComponents;
+
+	/** True while the shapes are registered with the combat broadphase */
+	bool bRegisteredWithBroadphase = false;
+
+public:
+
+	/** Constructor */
+	UCombatHurtboxComponent();
+
+	/** Enables or disables query collision on all hurtbox shapes */
+	void SetHurtboxesEnabled(bool bEnabled);
+
+	/** Adds the hurtbox shapes to the combat broadphase. Does nothing if they're already registered */
+	void RegisterWithBroadphase();
+
+	/** Removes the hurtbox shapes from the combat broadphase */
+	void UnregisterFromBroadphase();
+
+	/** Returns the damage multiplier for the provided body zone */
+	float GetZoneDamageMultiplier(ECombatHurtboxZone Zone) const;
+
+protected:
+
+	/** Creates the hurtbox shapes */
+	virtual void BeginPlay() override;
+
+	/** Destroys the hurtbox shapes */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** Adds a default shape to the list */
+	void AddDefaultShape(FName BoneName, ECombatHurtboxZone Zone, float Radius, float HalfHeight, const FVector& Offset = FVector::ZeroVector);
+};
@@ -0,0 +1,29 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatHurtboxShapeComponent.h"
+#include "Engine/HitResult.h"
+
+UCombatHurtboxShapeComponent::UCombatHurtboxShapeComponent()
+{
+	// hurtboxes are only ever queried by melee attacks
+	SetCollisionProfileName(COMBAT_HURTBOX_PROFILE);
+	SetGenerateOverlapEvents(false);
+	SetCanEverAffectNavigation(false);
+	CanCharacterStepUpOn = ECB_No;
+
+	bHiddenInGame = true;
+}
+
+void UCombatHurtboxShapeComponent::SetZone(ECombatHurtboxZone InZone, float InDamageMultiplier)
+{
+	Zone = InZone;
+	DamageMultiplier = InDamageMultiplier;
+}
+
+float UCombatHurtboxShapeComponent::GetDamageMultiplier(const FHitResult& Hit)
+{
+	const UCombatHurtboxShapeComponent* Hurtbox = Cast<UCombatHurtboxShapeComponent>(Hit.GetComponent());
+
+	return Hurtbox ? Hurtbox->DamageMultiplier : 1.0f;
+}
@@ -0,0 +1,61 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/CapsuleComponent.h"
+#include "CombatHurtboxShapeComponent.generated.h"
+
+/** Object channel used by hurtbox shapes. Must match the Hurtbox object channel in DefaultEngine.ini */
+#define ECC_CombatHurtbox ECC_GameTraceChannel2
+
+/** Name of the query only collision profile used by hurtbox shapes */
+#define COMBAT_HURTBOX_PROFILE FName("Hurtbox")
+
+/**
+ *  Body zones used to scale melee damage
+ */
+UENUM(BlueprintType)
+enum class ECombatHurtboxZone : uint8
+{
+	Head,
+	Torso,
+	Limb
+};
+
+/**
+ *  A single query only hurtbox shape attached to a bone.
+ *  Melee attacks read its damage multiplier straight from the hit component.
+ */
+UCLASS(ClassGroup = (Combat))
+class UCombatHurtboxShapeComponent : public UCapsuleComponent
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Body zone covered by this shape */
+	UPROPERTY(VisibleAnywhere, Category="Hurtbox")
+	ECombatHurtboxZone Zone = ECombatHurtboxZone::Torso;
+
+	/** Damage multiplier for hits on this shape */
+	UPROPERTY(VisibleAnywhere, Category="Hurtbox")
+	float DamageMultiplier = 1.0f;
+
+public:
+
+	/** Constructor */
+	UCombatHurtboxShapeComponent();
+
+	/** Sets the body zone and damage multiplier for this shape */
+	void SetZone(ECombatHurtboxZone InZone, float InDamageMultiplier);
+
+	/** Returns the body zone covered by this shape */
+	ECombatHurtboxZone GetZone() const { return Zone; }
+
+	/** Returns the damage multiplier for hits on this shape */
+	float GetDamageMultiplier() const { return DamageMultiplier; }
+
+	/** Returns the damage multiplier for the hit component, or 1 if it's not a hurtbox */
+	static float GetDamageMultiplier(const FHitResult& Hit);
+};
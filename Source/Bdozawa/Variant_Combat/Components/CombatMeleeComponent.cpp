@@ -0,0 +1,226 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatMeleeComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/SkeletalMesh.h"
+#include "Engine/SkeletalMeshSocket.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "CombatDamageable.h"
+#include "CombatFactionComponent.h"
+#include "CombatHurtboxShapeComponent.h"
+#include "CombatTraceSubsystem.h"
+#include "CombatDamageSubsystem.h"
+#include "BdozawaAllocationScope.h"
+
+UCombatMeleeComponent::UCombatMeleeComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UCombatMeleeComponent::SetPolicy(ECombatMeleePolicy InPolicy)
+{
+	Policy = InPolicy;
+
+	// pick the policy instantiations once, so the trace itself never branches on the policy
+	switch (Policy)
+	{
+		case ECombatMeleePolicy::Player:
+			DoAttackTraceFunc = &UCombatMeleeComponent::DoAttackTraceImpl<FCombatMeleePlayerPolicy>;
+			ResolveAttackTraceFunc = &UCombatMeleeComponent::ResolveAttackTraceImpl<FCombatMeleePlayerPolicy>;
+			break;
+
+		case ECombatMeleePolicy::Enemy:
+			DoAttackTraceFunc = &UCombatMeleeComponent::DoAttackTraceImpl<FCombatMeleeEnemyPolicy>;
+			ResolveAttackTraceFunc = &UCombatMeleeComponent::ResolveAttackTraceImpl<FCombatMeleeEnemyPolicy>;
+			break;
+
+		default:
+			DoAttackTraceFunc = &UCombatMeleeComponent::DoAttackTraceImpl<FCombatMeleeNeutralPolicy>;
+			ResolveAttackTraceFunc = &UCombatMeleeComponent::ResolveAttackTraceImpl<FCombatMeleeNeutralPolicy>;
+			break;
+	}
+}
+
+void UCombatMeleeComponent::DoAttackTrace(FName DamageSourceBone)
+{
+	BDOZAWA_ZERO_ALLOC_SCOPE("Combat.Melee.DoAttackTrace");
+
+	// we need a mesh to read the attack bones from
+	if (SourceMesh)
+	{
+		(this->*DoAttackTraceFunc)(DamageSourceBone);
+	}
+}
+
+void UCombatMeleeComponent::OnCombatTraceResolved(const TArray<FHitResult>& Hits, uint32 SwingId)
+{
+	BDOZAWA_ZERO_ALLOC_SCOPE("Combat.Melee.ResolveAttackTrace");
+
+	(this->*ResolveAttackTraceFunc)(Hits, SwingId);
+}
+
+template<typename TPolicy>
+void UCombatMeleeComponent::DoAttackTraceImpl(FName DamageSourceBone)
+{
+	AActor* Owner = GetOwner();
+	UWorld* World = GetWorld();
+
+	// start at the provided socket location, sweep forward
+	FCombatTraceRequest Request;
+	Request.Attacker = Owner;
+	Request.Start = GetAttackBoneLocation(DamageSourceBone);
+	Request.End = Request.Start + (Owner->GetActorForwardVector() * MeleeTraceDistance);
+	Request.Radius = MeleeTraceRadius;
+	Request.bUseBroadphase = bUseCombatBroadphase;
+
+	// check for hurtbox or pawn collision
+	Request.ObjectParams.AddObjectTypesToQuery(bTraceHurtboxes ? ECC_CombatHurtbox : ECC_Pawn);
+
+	// check for world dynamic objects, if the policy knocks them around
+	if constexpr (TPolicy::bQueryWorldDynamic)
+	{
+		Request.ObjectParams.AddObjectTypesToQuery(ECC_WorldDynamic);
+	}
+
+	// each trace is its own swing, so it can only damage a target once
+	const uint32 SwingId = World->GetSubsystem<UCombatDamageSubsystem>()->BeginSwing();
+
+	// process the hits once the trace is resolved
+	Request.ListenerObject = this;
+	Request.Listener = this;
+	Request.SwingId = SwingId;
+
+	// pass the trace to the scheduler
+	World->GetSubsystem<UCombatTraceSubsystem>()->SubmitTrace(MoveTemp(Request));
+}
+
+template<typename TPolicy>
+void UCombatMeleeComponent::ResolveAttackTraceImpl(const TArray<FHitResult>& Hits, uint32 SwingId)
+{
+	// keep the allocation around for the next trace
+	TargetHits.Reset();
+
+	for (const FHitResult& CurrentHit : Hits)
+	{
+		AActor* HitActor = CurrentHit.GetActor();
+
+		// skip friendly actors
+		if (Faction && !Faction->IsHostileTo(HitActor))
+		{
+			continue;
+		}
+
+		// skip actors that can't be damaged
+		if (!Cast<ICombatDamageable>(HitActor))
+		{
+			continue;
+		}
+
+		// scale the damage by the hurtbox zone we hit
+		const float Damage = MeleeDamage * UCombatHurtboxShapeComponent::GetDamageMultiplier(CurrentHit);
+
+		// one sweep may hit several hurtbox shapes on the same target, so only keep the strongest hit
+		FMeleeTargetHit* TargetHit = TargetHits.FindByPredicate([HitActor](const FMeleeTargetHit& Hit) { return Hit.Target == HitActor; });
+
+		if (!TargetHit)
+		{
+			TargetHit = &TargetHits.AddDefaulted_GetRef();
+			TargetHit->Target = HitActor;
+			TargetHit->Damage = -1.0f;
+		}
+
+		if (Damage > TargetHit->Damage)
+		{
+			TargetHit->Damage = Damage;
+			TargetHit->ImpactPoint = CurrentHit.ImpactPoint;
+
+			// knock upwards and away from the impact normal
+			TargetHit->Impulse = (CurrentHit.ImpactNormal * -MeleeKnockbackImpulse) + (FVector::UpVector * MeleeLaunchImpulse);
+		}
+	}
+
+	if (TargetHits.IsEmpty())
+	{
+		return;
+	}
+
+	UCombatDamageSubsystem* DamageSubsystem = GetWorld()->GetSubsystem<UCombatDamageSubsystem>();
+
+	for (const FMeleeTargetHit& TargetHit : TargetHits)
+	{
+		// queue the damage event. Skip effects if this swing has already hit the actor
+		if (DamageSubsystem->QueueDamage(TargetHit.Target, TargetHit.Damage, GetOwner(), TargetHit.ImpactPoint, TargetHit.Impulse, SwingId))
+		{
+			if constexpr (TPolicy::bReportDamageDealt)
+			{
+				OnDamageDealt.ExecuteIfBound(TargetHit.Damage, TargetHit.ImpactPoint);
+			}
+		}
+	}
+}
+
+FVector UCombatMeleeComponent::GetAttackBoneLocation(FName BoneName)
+{
+	// drop the cached bones if the mesh asset was swapped
+	USkeletalMesh* MeshAsset = SourceMesh->GetSkeletalMeshAsset();
+
+	if (CachedBonesMesh.Get() != MeshAsset)
+	{
+		CachedBones.Reset();
+		CachedBonesMesh = MeshAsset;
+	}
+
+	FCachedAttackBone* CachedBone = CachedBones.FindByPredicate([BoneName](const FCachedAttackBone& Bone) { return Bone.Name == BoneName; });
+
+	if (!CachedBone)
+	{
+		CachedBone = &CachedBones.AddDefaulted_GetRef();
+		CachedBone->Name = BoneName;
+
+		// sockets resolve to their parent bone plus their local transform
+		if (const USkeletalMeshSocket* Socket = SourceMesh->GetSocketByName(BoneName))
+		{
+			CachedBone->BoneIndex = SourceMesh->GetBoneIndex(Socket->BoneName);
+			CachedBone->RelativeTransform = Socket->GetSocketLocalTransform();
+
+		} else {
+
+			CachedBone->BoneIndex = SourceMesh->GetBoneIndex(BoneName);
+		}
+	}
+
+	// unknown bones fall back to the component location, same as GetSocketLocation
+	if (CachedBone->BoneIndex == INDEX_NONE)
+	{
+		return SourceMesh->GetComponentLocation();
+	}
+
+	return (CachedBone->RelativeTransform * SourceMesh->GetBoneTransform(CachedBone->BoneIndex)).GetLocation();
+}
+
+void UCombatMeleeComponent::OnRegister()
+{
+	Super::OnRegister();
+
+	// select the attack trace instantiation for the serialized policy
+	SetPolicy(Policy);
+}
+
+void UCombatMeleeComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// read attack bones from the character mesh, or the first skeletal mesh on other actors
+	if (ACharacter* CharacterOwner = Cast<ACharacter>(GetOwner()))
+	{
+		SourceMesh = CharacterOwner->GetMesh();
+
+	} else {
+
+		SourceMesh = GetOwner()->FindComponentByClass<USkeletalMeshComponent>();
+	}
+
+	Faction = GetOwner()->FindComponentByClass<UCombatFactionComponent>();
+}
@@ -0,0 +1,188 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Engine/HitResult.h"
+#include "CombatTraceSubsystem.h"
+#include "CombatMeleeComponent.generated.h"
+
+class USkeletalMeshComponent;
+class USkeletalMesh;
+class UCombatFactionComponent;
+
+/** Called when a melee attack queues damage on a target */
+DECLARE_DELEGATE_TwoParams(FOnMeleeDamageDealt, float /* Damage */, const FVector& /* ImpactPoint */);
+
+/**
+ *  Selects the compile-time filtering policy used by a melee component
+ */
+UENUM(BlueprintType)
+enum class ECombatMeleePolicy : uint8
+{
+	Player,
+	Enemy,
+	Neutral
+};
+
+/**
+ *  Melee policy for player characters. Hits pawns and knocks around world dynamic objects, and reports damage dealt for effects
+ */
+struct FCombatMeleePlayerPolicy
+{
+	static constexpr bool bQueryWorldDynamic = true;
+	static constexpr bool bReportDamageDealt = true;
+};
+
+/**
+ *  Melee policy for enemies. Only hits pawns, they don't knock back boxes
+ */
+struct FCombatMeleeEnemyPolicy
+{
+	static constexpr bool bQueryWorldDynamic = false;
+	static constexpr bool bReportDamageDealt = false;
+};
+
+/**
+ *  Melee policy for neutral attackers such as hazards. Hits pawns and world dynamic objects without reporting damage
+ */
+struct FCombatMeleeNeutralPolicy
+{
+	static constexpr bool bQueryWorldDynamic = true;
+	static constexpr bool bReportDamageDealt = false;
+};
+
+/**
+ *  Performs melee attack traces and queues their damage for its owner.
+ *  Shared by player and enemy attackers. Filtering is resolved at compile time from the selected policy,
+ *  so the trace and resolve paths don't branch on the attacker type.
+ */
+UCLASS(ClassGroup = (Combat), meta = (BlueprintSpawnableComponent))
+class UCombatMeleeComponent : public UActorComponent, public ICombatTraceListener
+{
+	GENERATED_BODY()
+
+	/** A bone or socket resolved to a bone index and a bone-relative transform */
+	struct FCachedAttackBone
+	{
+		FName Name;
+		int32 BoneIndex = INDEX_NONE;
+		FTransform RelativeTransform;
+	};
+
+	/** A damageable target found by a melee trace, with its best hit */
+	struct FMeleeTargetHit
+	{
+		AActor* Target = nullptr;
+		float Damage = 0.0f;
+		FVector ImpactPoint = FVector::ZeroVector;
+		FVector Impulse = FVector::ZeroVector;
+	};
+
+	/** Pointers to the policy instantiations of the attack trace and its resolve */
+	using FDoAttackTraceFunc = void (UCombatMeleeComponent::*)(FName);
+	using FResolveAttackTraceFunc = void (UCombatMeleeComponent::*)(const TArray<FHitResult>&, uint32);
+
+protected:
+
+	/** Compile-time filtering policy used by the attack traces */
+	UPROPERTY(EditAnywhere, Category="Melee Attack")
+	ECombatMeleePolicy Policy = ECombatMeleePolicy::Neutral;
+
+public:
+
+	/** Distance ahead of the owner that melee attack sphere collision traces will extend */
+	UPROPERTY(EditAnywhere, Category="Melee Attack|Trace", meta = (ClampMin = 0, ClampMax = 500, Units = "cm"))
+	float MeleeTraceDistance = 75.0f;
+
+	/** Radius of the sphere trace for melee attacks */
+	UPROPERTY(EditAnywhere, Category="Melee Attack|Trace", meta = (ClampMin = 0, ClampMax = 500, Units = "cm"))
+	float MeleeTraceRadius = 75.0f;
+
+	/** If true, melee attacks will be tested against the combat broadphase instead of the physics scene */
+	UPROPERTY(EditAnywhere, Category="Melee Attack|Trace")
+	bool bUseCombatBroadphase = false;
+
+	/** If true, melee attacks will look for hurtbox shapes instead of pawn collision, and scale damage by the zone hit */
+	UPROPERTY(EditAnywhere, Category="Melee Attack|Trace")
+	bool bTraceHurtboxes = true;
+
+	/** Amount of damage a melee attack will deal */
+	UPROPERTY(EditAnywhere, Category="Melee Attack|Damage", meta = (ClampMin = 0, ClampMax = 100))
+	float MeleeDamage = 1.0f;
+
+	/** Amount of knockback impulse a melee attack will apply */
+	UPROPERTY(EditAnywhere, Category="Melee Attack|Damage", meta = (ClampMin = 0, ClampMax = 1000, Units = "cm/s"))
+	float MeleeKnockbackImpulse = 250.0f;
+
+	/** Amount of upwards impulse a melee attack will apply */
+	UPROPERTY(EditAnywhere, Category="Melee Attack|Damage", meta = (ClampMin = 0, ClampMax = 1000, Units = "cm/s"))
+	float MeleeLaunchImpulse = 300.0f;
+
+	/** Called for each target a melee attack damages, if the policy reports damage dealt */
+	FOnMeleeDamageDealt OnDamageDealt;
+
+protected:
+
+	/** Mesh the attack bones are read from */
+	UPROPERTY(Transient)
+	TObjectPtr<USkeletalMeshComponent> SourceMesh;
+
+	/** Owner's faction, used to skip friendly targets */
+	UPROPERTY(Transient)
+	TObjectPtr<UCombatFactionComponent> Faction;
+
+	/** Skeletal mesh asset the cached bones were resolved against */
+	TWeakObjectPtr<USkeletalMesh> CachedBonesMesh;
+
+	/** Attack bones resolved so far. Attackers only use a handful, so a linear search is enough */
+	TArray<FCachedAttackBone, TInlineAllocator<4>> CachedBones;
+
+	/** Reusable per-trace target buffer */
+	TArray<FMeleeTargetHit, TInlineAllocator<8>> TargetHits;
+
+	/** Attack trace instantiation for the current policy */
+	FDoAttackTraceFunc DoAttackTraceFunc = nullptr;
+
+	/** Attack trace resolve instantiation for the current policy */
+	FResolveAttackTraceFunc ResolveAttackTraceFunc = nullptr;
+
+public:
+
+	/** Constructor */
+	UCombatMeleeComponent();
+
+	/** Sets the filtering policy */
+	void SetPolicy(ECombatMeleePolicy InPolicy);
+
+	/** Returns the filtering policy */
+	ECombatMeleePolicy GetPolicy() const { return Policy; }
+
+	/** Sweeps forward from the given bone or socket and queues damage on any hostile damageables hit */
+	void DoAttackTrace(FName DamageSourceBone);
+
+protected:
+
+	/** Sweeps forward from the given bone or socket using the given policy */
+	template<typename TPolicy>
+	void DoAttackTraceImpl(FName DamageSourceBone);
+
+	/** Processes the results of an attack trace using the given policy */
+	template<typename TPolicy>
+	void ResolveAttackTraceImpl(const TArray<FHitResult>& Hits, uint32 SwingId);
+
+	/** Returns the world location of an attack bone or socket, resolving and caching its bone index on first use */
+	FVector GetAttackBoneLocation(FName BoneName);
+
+public:
+
+	// ~begin ICombatTraceListener interface
+	virtual void OnCombatTraceResolved(const TArray<FHitResult>& Hits, uint32 SwingId) override;
+	// ~end ICombatTraceListener interface
+
+	// ~begin UActorComponent interface
+	virtual void OnRegister() override;
+	virtual void BeginPlay() override;
+	// ~end UActorComponent interface
+};
@@ -0,0 +1,303 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatSimulation.h"
+
+int32 FCombatSimulation::AddCombatant(float InMaxHP, int32 InNumComboSections, bool bAIDriven)
+{
+	int32 Index;
+
+	// reuse a free slot if we have one
+	if (!FreeIndices.IsEmpty())
+	{
+		Index = FreeIndices.Pop(EAllowShrinking::No);
+
+	} else {
+
+		Index = Flags.Num();
+
+		HP.AddUninitialized();
+		MaxHP.AddUninitialized();
+		Flags.AddUninitialized();
+		NumComboSections.AddUninitialized();
+		AttackStage.AddUninitialized();
+		TargetAttackStage.AddUninitialized();
+		CachedInputTime.AddUninitialized();
+		NotifyTimer.AddUninitialized();
+	}
+
+	// initialize the combatant at full HP
+	HP[Index] = InMaxHP;
+	MaxHP[Index] = InMaxHP;
+	Flags[Index] = bAIDriven ? (ECombatantFlags::InUse | ECombatantFlags::AIDriven) : ECombatantFlags::InUse;
+	NumComboSections[Index] = InNumComboSections;
+	AttackStage[Index] = 0;
+	TargetAttackStage[Index] = 0;
+	CachedInputTime[Index] = 0.0;
+	NotifyTimer[Index] = 0.0f;
+
+	return Index;
+}
+
+void FCombatSimulation::RemoveCombatant(int32 Index)
+{
+	if (IsValidCombatant(Index))
+	{
+		Flags[Index] = ECombatantFlags::None;
+		FreeIndices.Add(Index);
+	}
+}
+
+void FCombatSimulation::Reset()
+{
+	HP.Reset();
+	MaxHP.Reset();
+	Flags.Reset();
+	NumComboSections.Reset();
+	AttackStage.Reset();
+	TargetAttackStage.Reset();
+	CachedInputTime.Reset();
+	NotifyTimer.Reset();
+	FreeIndices.Reset();
+	PendingHits.Reset();
+}
+
+void FCombatSimulation::ResetHP(int32 Index)
+{
+	HP[Index] = MaxHP[Index];
+}
+
+void FCombatSimulation::SetMaxHP(int32 Index, float InMaxHP)
+{
+	MaxHP[Index] = InMaxHP;
+}
+
+void FCombatSimulation::SetHP(int32 Index, float InHP)
+{
+	HP[Index] = FMath::Clamp(InHP, 0.0f, MaxHP[Index]);
+}
+
+FCombatDamageResult FCombatSimulation::ApplyDamage(int32 Index, float Damage)
+{
+	FCombatDamageResult Result;
+
+	// only process damage if the combatant is still alive
+	if (HP[Index] <= 0.0f)
+	{
+		return Result;
+	}
+
+	// reduce the current HP
+	HP[Index] -= Damage;
+
+	Result.ActualDamage = Damage;
+	Result.bKilled = HP[Index] <= 0.0f;
+
+	return Result;
+}
+
+void FCombatSimulation::StartComboAttack(int32 Index, int32 TargetComboCount)
+{
+	// raise the attacking flag
+	EnumAddFlags(Flags[Index], ECombatantFlags::Attacking);
+	EnumRemoveFlags(Flags[Index], ECombatantFlags::ChargedAttack);
+
+	// reset the combo count
+	AttackStage[Index] = 0;
+	TargetAttackStage[Index] = TargetComboCount;
+}
+
+void FCombatSimulation::StartChargedAttack(int32 Index, int32 TargetChargeLoops)
+{
+	// raise the attacking flag
+	EnumAddFlags(Flags[Index], ECombatantFlags::Attacking | ECombatantFlags::ChargedAttack);
+
+	// reset the charge loop flag
+	EnumRemoveFlags(Flags[Index], ECombatantFlags::HasLoopedCharge);
+
+	// reset the charge loop counter
+	AttackStage[Index] = 0;
+	TargetAttackStage[Index] = TargetChargeLoops;
+}
+
+void FCombatSimulation::CacheAttackInput(int32 Index, double Time)
+{
+	CachedInputTime[Index] = Time;
+}
+
+void FCombatSimulation::SetChargingAttack(int32 Index, bool bCharging)
+{
+	if (bCharging)
+	{
+		EnumAddFlags(Flags[Index], ECombatantFlags::ChargingAttack);
+
+	} else {
+
+		EnumRemoveFlags(Flags[Index], ECombatantFlags::ChargingAttack);
+	}
+}
+
+int32 FCombatSimulation::CheckCombo(int32 Index, double Time, float ComboInputTolerance)
+{
+	// AI driven combatants play a fixed number of stages
+	if (EnumHasAnyFlags(Flags[Index], ECombatantFlags::AIDriven))
+	{
+		// increase the combo counter
+		++AttackStage[Index];
+
+		// do we still have attacks to play in this string?
+		return AttackStage[Index] < TargetAttackStage[Index] ? AttackStage[Index] : INDEX_NONE;
+	}
+
+	// are we playing a non-charge attack animation?
+	if (!IsAttacking(Index) || IsChargingAttack(Index))
+	{
+		return INDEX_NONE;
+	}
+
+	// is the last attack input stale?
+	if (Time - CachedInputTime[Index] > ComboInputTolerance)
+	{
+		return INDEX_NONE;
+	}
+
+	// consume the attack input so we don't accidentally trigger it twice
+	CachedInputTime[Index] = 0.0;
+
+	// increase the combo counter
+	++AttackStage[Index];
+
+	// do we still have a combo section to play?
+	return AttackStage[Index] < NumComboSections[Index] ? AttackStage[Index] : INDEX_NONE;
+}
+
+bool FCombatSimulation::CheckChargedAttack(int32 Index)
+{
+	// AI driven combatants loop a fixed number of times
+	if (EnumHasAnyFlags(Flags[Index], ECombatantFlags::AIDriven))
+	{
+		// increase the charge loop counter
+		++AttackStage[Index];
+
+		return AttackStage[Index] < TargetAttackStage[Index];
+	}
+
+	// raise the looped charged attack flag
+	EnumAddFlags(Flags[Index], ECombatantFlags::HasLoopedCharge);
+
+	// keep looping while the charge input is held
+	return IsChargingAttack(Index);
+}
+
+ECombatFollowUpAttack FCombatSimulation::EndAttack(int32 Index, double Time, float AttackInputTolerance)
+{
+	// reset the attacking flag
+	EnumRemoveFlags(Flags[Index], ECombatantFlags::Attacking | ECombatantFlags::ChargedAttack);
+
+	// AI driven combatants don't buffer inputs
+	if (EnumHasAnyFlags(Flags[Index], ECombatantFlags::AIDriven))
+	{
+		return ECombatFollowUpAttack::None;
+	}
+
+	// check if we have a non-stale cached input
+	if (Time - CachedInputTime[Index] > AttackInputTolerance)
+	{
+		return ECombatFollowUpAttack::None;
+	}
+
+	// are we holding the charged attack button?
+	return IsChargingAttack(Index) ? ECombatFollowUpAttack::Charged : ECombatFollowUpAttack::Combo;
+}
+
+void FCombatSimulation::Simulate(float DeltaTime, const FCombatSimulationParams& Params, FRandomStream& Stream, FCombatSimulationStats& OutStats)
+{
+	const int32 NumSlots = Flags.Num();
+
+	// nobody to attack
+	if (NumSlots < 2)
+	{
+		return;
+	}
+
+	PendingHits.Reset();
+
+	for (int32 i = 0; i < NumSlots; ++i)
+	{
+		const ECombatantFlags CurrentFlags = Flags[i];
+
+		// only simulate living AI driven combatants
+		if (!EnumHasAllFlags(CurrentFlags, ECombatantFlags::InUse | ECombatantFlags::AIDriven) || HP[i] <= 0.0f)
+		{
+			continue;
+		}
+
+		// start a new attack string if we're idle
+		if (!EnumHasAnyFlags(CurrentFlags, ECombatantFlags::Attacking))
+		{
+			if (Stream.FRand() < Params.ChargedAttackChance)
+			{
+				StartChargedAttack(i, Stream.RandRange(Params.MinChargeLoops, Params.MaxChargeLoops));
+
+			} else {
+
+				StartComboAttack(i, Stream.RandRange(1, FMath::Max(NumComboSections[i] - 1, 1)));
+			}
+
+			NotifyTimer[i] = Params.SectionTime;
+			++OutStats.AttacksStarted;
+
+			continue;
+		}
+
+		// wait for the next notify
+		NotifyTimer[i] -= DeltaTime;
+
+		if (NotifyTimer[i] > 0.0f)
+		{
+			continue;
+		}
+
+		NotifyTimer[i] += Params.SectionTime;
+
+		// charged attacks only hit once the charge has been released
+		if (EnumHasAnyFlags(CurrentFlags, ECombatantFlags::ChargedAttack) && CheckChargedAttack(i))
+		{
+			continue;
+		}
+
+		// pick a random target for the attack
+		const int32 Target = Stream.RandHelper(NumSlots);
+
+		if (Target != i && IsValidCombatant(Target))
+		{
+			PendingHits.Emplace(Target, Params.AttackDamage);
+		}
+
+		// continue the combo or end the attack
+		if (EnumHasAnyFlags(CurrentFlags, ECombatantFlags::ChargedAttack) || CheckCombo(i) == INDEX_NONE)
+		{
+			EndAttack(i);
+		}
+	}
+
+	// resolve all damage after every combatant has attacked, so results don't depend on iteration order
+	for (const TPair<int32, float>& CurrentHit : PendingHits)
+	{
+		const FCombatDamageResult Result = ApplyDamage(CurrentHit.Key, CurrentHit.Value);
+
+		if (Result.ActualDamage > 0.0f)
+		{
+			++OutStats.Hits;
+		}
+
+		if (Result.bKilled)
+		{
+			++OutStats.Deaths;
+
+			// bring the combatant back so the population stays constant
+			ResetHP(CurrentHit.Key);
+			EnumRemoveFlags(Flags[CurrentHit.Key], ECombatantFlags::Attacking | ECombatantFlags::ChargedAttack);
+		}
+	}
+}
@@ -0,0 +1,198 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Math/RandomStream.h"
+
+/** State flags for a single combatant */
+enum class ECombatantFlags : uint8
+{
+	None				= 0,
+	InUse				= 1 << 0,	// slot holds a combatant
+	AIDriven			= 1 << 1,	// attack strings are decided up front instead of by player input
+	Attacking			= 1 << 2,	// an attack animation is playing
+	ChargedAttack		= 1 << 3,	// the attack being played is a charged attack
+	ChargingAttack		= 1 << 4,	// the charged attack input is being held
+	HasLoopedCharge		= 1 << 5	// the charged attack hold check has been tested at least once
+};
+ENUM_CLASS_FLAGS(ECombatantFlags);
+
+/** Attack to perform after an attack animation ends */
+enum class ECombatFollowUpAttack : uint8
+{
+	None,
+	Combo,
+	Charged
+};
+
+/**
+ *  Outcome of a damage event
+ */
+struct FCombatDamageResult
+{
+	/** Damage actually dealt. Zero if the combatant was already dead */
+	float ActualDamage = 0.0f;
+
+	/** If true, this damage event killed the combatant */
+	bool bKilled = false;
+};
+
+/**
+ *  Tuning for headless simulation runs. Stands in for montage timing and the actors' melee settings
+ */
+struct FCombatSimulationParams
+{
+	/** Time between attack notifies, standing in for the length of a montage section */
+	float SectionTime = 0.5f;
+
+	/** Damage dealt by each attack */
+	float AttackDamage = 1.0f;
+
+	/** Chance of starting a charged attack instead of a combo attack */
+	float ChargedAttackChance = 0.3f;
+
+	/** Minimum number of charge loops for AI charged attacks */
+	int32 MinChargeLoops = 2;
+
+	/** Maximum number of charge loops for AI charged attacks */
+	int32 MaxChargeLoops = 5;
+};
+
+/**
+ *  Counters gathered during headless simulation runs
+ */
+struct FCombatSimulationStats
+{
+	/** Attack strings started */
+	int32 AttacksStarted = 0;
+
+	/** Damage events applied */
+	int32 Hits = 0;
+
+	/** Combatants killed */
+	int32 Deaths = 0;
+};
+
+/**
+ *  Engine-independent combat state for any number of combatants.
+ *  Stores HP and attack state as parallel arrays indexed by combatant, and runs the combo and charged attack
+ *  state machines used by the combat characters. Actors own a combatant index and drive it from their
+ *  input, animation and damage callbacks, while headless runs can drive it directly through Simulate.
+ */
+class FCombatSimulation
+{
+	/** Current HP per combatant */
+	TArray<float> HP;
+
+	/** Max HP per combatant */
+	TArray<float> MaxHP;
+
+	/** State flags per combatant */
+	TArray<ECombatantFlags> Flags;
+
+	/** Number of combo sections available to each combatant */
+	TArray<int32> NumComboSections;
+
+	/** Current stage of the combo string, or current charge loop for charged attacks */
+	TArray<int32> AttackStage;
+
+	/** Target number of combo stages or charge loops. Only used by AI driven combatants */
+	TArray<int32> TargetAttackStage;
+
+	/** Time at which an attack input was last cached */
+	TArray<double> CachedInputTime;
+
+	/** Time left until the next attack notify. Only used by headless simulation runs */
+	TArray<float> NotifyTimer;
+
+	/** Unused combatant slots */
+	TArray<int32> FreeIndices;
+
+	/** Damage events gathered during a headless simulation step */
+	TArray<TPair<int32, float>> PendingHits;
+
+public:
+
+	/** Adds a combatant at full HP and returns its index */
+	int32 AddCombatant(float InMaxHP, int32 InNumComboSections, bool bAIDriven);
+
+	/** Removes a combatant. Its index may be reused by later combatants */
+	void RemoveCombatant(int32 Index);
+
+	/** Removes all combatants */
+	void Reset();
+
+	/** Returns the number of combatant slots, including unused ones */
+	int32 Num() const { return Flags.Num(); }
+
+	/** Returns true if the index refers to a combatant in use */
+	bool IsValidCombatant(int32 Index) const { return Flags.IsValidIndex(Index) && EnumHasAnyFlags(Flags[Index], ECombatantFlags::InUse); }
+
+public:
+
+	/** Resets the combatant's HP to maximum */
+	void ResetHP(int32 Index);
+
+	/** Sets the combatant's max HP without changing its current HP */
+	void SetMaxHP(int32 Index, float InMaxHP);
+
+	/** Sets the combatant's current HP, clamped to its max HP */
+	void SetHP(int32 Index, float InHP);
+
+	/** Reduces the combatant's HP. Dead combatants ignore damage */
+	FCombatDamageResult ApplyDamage(int32 Index, float Damage);
+
+	/** Returns the combatant's current HP */
+	float GetHP(int32 Index) const { return HP[Index]; }
+
+	/** Returns the combatant's max HP */
+	float GetMaxHP(int32 Index) const { return MaxHP[Index]; }
+
+	/** Returns the combatant's current HP as a fraction of max HP */
+	float GetHPPercentage(int32 Index) const { return MaxHP[Index] > 0.0f ? HP[Index] / MaxHP[Index] : 0.0f; }
+
+	/** Returns true if the combatant has HP left */
+	bool IsAlive(int32 Index) const { return HP[Index] > 0.0f; }
+
+public:
+
+	/** Starts a combo attack string. AI driven combatants also need the number of stages to play */
+	void StartComboAttack(int32 Index, int32 TargetComboCount = 0);
+
+	/** Starts a charged attack. AI driven combatants also need the number of charge loops to play */
+	void StartChargedAttack(int32 Index, int32 TargetChargeLoops = 0);
+
+	/** Caches an attack input so it can be consumed by a combo check or when the current attack ends */
+	void CacheAttackInput(int32 Index, double Time);
+
+	/** Sets whether the charged attack input is being held */
+	void SetChargingAttack(int32 Index, bool bCharging);
+
+	/** Performs the combo string check. Returns the combo section to jump to, or INDEX_NONE to let the current section finish. AI driven combatants ignore the input timing */
+	int32 CheckCombo(int32 Index, double Time = 0.0, float ComboInputTolerance = 0.0f);
+
+	/** Performs the charged attack hold check. Returns true to keep looping the charge, false to release the attack */
+	bool CheckChargedAttack(int32 Index);
+
+	/** Ends the current attack and returns the attack to perform next, based on any cached input. AI driven combatants ignore the input timing */
+	ECombatFollowUpAttack EndAttack(int32 Index, double Time = 0.0, float AttackInputTolerance = 0.0f);
+
+	/** Returns true if the combatant is playing an attack */
+	bool IsAttacking(int32 Index) const { return EnumHasAnyFlags(Flags[Index], ECombatantFlags::Attacking); }
+
+	/** Returns true if the charged attack input is being held */
+	bool IsChargingAttack(int32 Index) const { return EnumHasAnyFlags(Flags[Index], ECombatantFlags::ChargingAttack); }
+
+	/** Returns true if the charged attack hold check has been tested at least once */
+	bool HasLoopedChargedAttack(int32 Index) const { return EnumHasAnyFlags(Flags[Index], ECombatantFlags::HasLoopedCharge); }
+
+public:
+
+	/**
+	 *  Advances all AI driven combatants without any actors or animations.
+	 *  Idle combatants start random attack strings, and every attack notify damages a random living combatant.
+	 *  Killed combatants are restored to full HP so the population stays constant.
+	 */
+	void Simulate(float DeltaTime, const FCombatSimulationParams& Params, FRandomStream& Stream, FCombatSimulationStats& OutStats);
+};
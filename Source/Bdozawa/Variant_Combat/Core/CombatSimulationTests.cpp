@@ -0,0 +1,234 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatSimulation.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace CombatSimulationTests
+{
+	/** Test flags shared by all combat simulation tests */
+	constexpr EAutomationTestFlags Flags = EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter;
+
+	/** Combo input tolerance used by the player driven tests */
+	constexpr float InputTolerance = 0.5f;
+
+	/** Lowest acceptable throughput of the headless simulation, in combatants simulated per millisecond.
+	 *  Well below what any target machine reaches, so this only catches large regressions */
+	constexpr double MinThroughput = 1000.0;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCombatSimulationComboTest, "Bdozawa.Combat.Simulation.Combo", CombatSimulationTests::Flags)
+
+bool FCombatSimulationComboTest::RunTest(const FString& Parameters)
+{
+	FCombatSimulation Simulation;
+
+	// player driven combo string with three sections
+	const int32 Player = Simulation.AddCombatant(3.0f, 3, false);
+
+	Simulation.StartComboAttack(Player);
+	TestTrue(TEXT("Starting a combo raises the attacking flag"), Simulation.IsAttacking(Player));
+
+	// no input has been cached yet
+	TestEqual(TEXT("Combo check without input lets the section finish"), Simulation.CheckCombo(Player, 1.0, CombatSimulationTests::InputTolerance), INDEX_NONE);
+
+	// a fresh input advances the combo and is consumed
+	Simulation.CacheAttackInput(Player, 1.0);
+	TestEqual(TEXT("Combo check with fresh input jumps to the second section"), Simulation.CheckCombo(Player, 1.2, CombatSimulationTests::InputTolerance), 1);
+	TestEqual(TEXT("Combo input is consumed by the check"), Simulation.CheckCombo(Player, 1.2, CombatSimulationTests::InputTolerance), INDEX_NONE);
+
+	// a stale input is ignored
+	Simulation.CacheAttackInput(Player, 2.0);
+	TestEqual(TEXT("Combo check with stale input lets the section finish"), Simulation.CheckCombo(Player, 3.0, CombatSimulationTests::InputTolerance), INDEX_NONE);
+
+	// the last section ends the string
+	Simulation.CacheAttackInput(Player, 4.0);
+	TestEqual(TEXT("Combo check jumps to the third section"), Simulation.CheckCombo(Player, 4.1, CombatSimulationTests::InputTolerance), 2);
+
+	Simulation.CacheAttackInput(Player, 5.0);
+	TestEqual(TEXT("Combo check past the last section lets it finish"), Simulation.CheckCombo(Player, 5.1, CombatSimulationTests::InputTolerance), INDEX_NONE);
+
+	// ending the attack with no buffered input returns to idle
+	TestTrue(TEXT("Ending without buffered input has no follow up"), Simulation.EndAttack(Player, 6.0, CombatSimulationTests::InputTolerance) == ECombatFollowUpAttack::None);
+	TestFalse(TEXT("Ending the attack lowers the attacking flag"), Simulation.IsAttacking(Player));
+
+	// buffered inputs pick the follow up attack
+	Simulation.StartComboAttack(Player);
+	Simulation.CacheAttackInput(Player, 7.0);
+	TestTrue(TEXT("Ending with a buffered input follows up with a combo"), Simulation.EndAttack(Player, 7.1, CombatSimulationTests::InputTolerance) == ECombatFollowUpAttack::Combo);
+
+	Simulation.StartComboAttack(Player);
+	Simulation.CacheAttackInput(Player, 8.0);
+	Simulation.SetChargingAttack(Player, true);
+	TestEqual(TEXT("Combo check is ignored while charging"), Simulation.CheckCombo(Player, 8.1, CombatSimulationTests::InputTolerance), INDEX_NONE);
+	TestTrue(TEXT("Ending with a buffered input while charging follows up with a charged attack"), Simulation.EndAttack(Player, 8.1, CombatSimulationTests::InputTolerance) == ECombatFollowUpAttack::Charged);
+
+	// AI driven combo string with a fixed number of stages
+	const int32 AI = Simulation.AddCombatant(3.0f, 3, true);
+
+	Simulation.StartComboAttack(AI, 2);
+	TestEqual(TEXT("AI combo check advances to the second stage"), Simulation.CheckCombo(AI), 1);
+	TestEqual(TEXT("AI combo check stops at the target stage"), Simulation.CheckCombo(AI), INDEX_NONE);
+
+	Simulation.CacheAttackInput(AI, 0.0);
+	TestTrue(TEXT("AI combatants don't buffer inputs"), Simulation.EndAttack(AI) == ECombatFollowUpAttack::None);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCombatSimulationChargeTest, "Bdozawa.Combat.Simulation.Charge", CombatSimulationTests::Flags)
+
+bool FCombatSimulationChargeTest::RunTest(const FString& Parameters)
+{
+	FCombatSimulation Simulation;
+
+	// player driven charge loops while the input is held
+	const int32 Player = Simulation.AddCombatant(3.0f, 3, false);
+
+	Simulation.StartChargedAttack(Player);
+	Simulation.SetChargingAttack(Player, true);
+
+	TestTrue(TEXT("Starting a charged attack raises the attacking flag"), Simulation.IsAttacking(Player));
+	TestFalse(TEXT("A new charged attack hasn't looped yet"), Simulation.HasLoopedChargedAttack(Player));
+
+	TestTrue(TEXT("Charge keeps looping while held"), Simulation.CheckChargedAttack(Player));
+	TestTrue(TEXT("Charge check raises the looped flag"), Simulation.HasLoopedChargedAttack(Player));
+
+	Simulation.SetChargingAttack(Player, false);
+	TestFalse(TEXT("Charge is released when the input is let go"), Simulation.CheckChargedAttack(Player));
+
+	Simulation.EndAttack(Player);
+	TestFalse(TEXT("Ending the charged attack lowers the attacking flag"), Simulation.IsAttacking(Player));
+
+	Simulation.StartChargedAttack(Player);
+	TestFalse(TEXT("Restarting a charged attack resets the looped flag"), Simulation.HasLoopedChargedAttack(Player));
+
+	// AI driven charge loops a fixed number of times
+	const int32 AI = Simulation.AddCombatant(3.0f, 3, true);
+
+	Simulation.StartChargedAttack(AI, 3);
+	TestTrue(TEXT("AI charge loops on the first check"), Simulation.CheckChargedAttack(AI));
+	TestTrue(TEXT("AI charge loops on the second check"), Simulation.CheckChargedAttack(AI));
+	TestFalse(TEXT("AI charge is released at the target loop count"), Simulation.CheckChargedAttack(AI));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCombatSimulationDamageTest, "Bdozawa.Combat.Simulation.Damage", CombatSimulationTests::Flags)
+
+bool FCombatSimulationDamageTest::RunTest(const FString& Parameters)
+{
+	FCombatSimulation Simulation;
+
+	const int32 Index = Simulation.AddCombatant(3.0f, 3, false);
+
+	TestTrue(TEXT("New combatants are valid"), Simulation.IsValidCombatant(Index));
+	TestEqual(TEXT("New combatants start at full HP"), Simulation.GetHPPercentage(Index), 1.0f);
+
+	// non lethal damage
+	FCombatDamageResult Result = Simulation.ApplyDamage(Index, 1.0f);
+
+	TestEqual(TEXT("Non lethal damage is dealt in full"), Result.ActualDamage, 1.0f);
+	TestFalse(TEXT("Non lethal damage doesn't kill"), Result.bKilled);
+	TestEqual(TEXT("Non lethal damage reduces HP"), Simulation.GetHP(Index), 2.0f);
+	TestEqual(TEXT("HP percentage follows the damage"), Simulation.GetHPPercentage(Index), 2.0f / 3.0f, UE_KINDA_SMALL_NUMBER);
+
+	// lethal damage
+	Result = Simulation.ApplyDamage(Index, 2.0f);
+
+	TestTrue(TEXT("Lethal damage kills"), Result.bKilled);
+	TestFalse(TEXT("Killed combatants aren't alive"), Simulation.IsAlive(Index));
+
+	// dead combatants ignore damage
+	Result = Simulation.ApplyDamage(Index, 1.0f);
+
+	TestEqual(TEXT("Dead combatants take no damage"), Result.ActualDamage, 0.0f);
+	TestFalse(TEXT("Dead combatants can't be killed again"), Result.bKilled);
+
+	// HP resets and clamping
+	Simulation.ResetHP(Index);
+	TestTrue(TEXT("Resetting HP revives the combatant"), Simulation.IsAlive(Index));
+	TestEqual(TEXT("Resetting HP restores max HP"), Simulation.GetHPPercentage(Index), 1.0f);
+
+	Simulation.SetHP(Index, 10.0f);
+	TestEqual(TEXT("HP is clamped to max HP"), Simulation.GetHP(Index), 3.0f);
+
+	// removed slots are reused
+	Simulation.RemoveCombatant(Index);
+	TestFalse(TEXT("Removed combatants are invalid"), Simulation.IsValidCombatant(Index));
+	TestEqual(TEXT("Added combatants reuse free slots"), Simulation.AddCombatant(5.0f, 3, false), Index);
+	TestEqual(TEXT("Reused slots start at their new max HP"), Simulation.GetHP(Index), 5.0f);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCombatSimulationThroughputTest, "Bdozawa.Combat.Simulation.Throughput", CombatSimulationTests::Flags)
+
+bool FCombatSimulationThroughputTest::RunTest(const FString& Parameters)
+{
+	// roughly matching the combat enemies' defaults
+	const int32 CombatantCount = 10000;
+	const int32 NumFrames = 120;
+	const float DeltaTime = 1.0f / 60.0f;
+
+	const FCombatSimulationParams Params;
+
+	// runs the simulation and returns the elapsed time in milliseconds
+	auto RunSimulation = [&](FCombatSimulation& Simulation, FCombatSimulationStats& Stats)
+	{
+		FRandomStream Stream(CombatantCount);
+
+		for (int32 i = 0; i < CombatantCount; ++i)
+		{
+			Simulation.AddCombatant(3.0f, 3, true);
+		}
+
+		const double StartTime = FPlatformTime::Seconds();
+
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			Simulation.Simulate(DeltaTime, Params, Stream, Stats);
+		}
+
+		return (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	};
+
+	FCombatSimulation Simulation;
+	FCombatSimulationStats Stats;
+	const double ElapsedMs = RunSimulation(Simulation, Stats);
+
+	TestTrue(TEXT("Combatants start attacks"), Stats.AttacksStarted > 0);
+	TestTrue(TEXT("Attacks land hits"), Stats.Hits > 0);
+	TestTrue(TEXT("Hits kill combatants"), Stats.Deaths > 0 && Stats.Deaths <= Stats.Hits);
+
+	// killed combatants are brought back, so the population stays constant
+	int32 NumAlive = 0;
+
+	for (int32 i = 0; i < Simulation.Num(); ++i)
+	{
+		NumAlive += Simulation.IsAlive(i) ? 1 : 0;
+	}
+
+	TestEqual(TEXT("Population stays constant"), NumAlive, CombatantCount);
+
+	// the same seed gives the same results
+	FCombatSimulation ReplaySimulation;
+	FCombatSimulationStats ReplayStats;
+	RunSimulation(ReplaySimulation, ReplayStats);
+
+	TestEqual(TEXT("Replayed attacks match"), ReplayStats.AttacksStarted, Stats.AttacksStarted);
+	TestEqual(TEXT("Replayed hits match"), ReplayStats.Hits, Stats.Hits);
+	TestEqual(TEXT("Replayed deaths match"), ReplayStats.Deaths, Stats.Deaths);
+
+	// throughput floor
+	const double Throughput = ElapsedMs > 0.0 ? (double(CombatantCount) * NumFrames) / ElapsedMs : MAX_dbl;
+
+	AddInfo(FString::Printf(TEXT("%d combatants, %d frames in %.3f ms. %.0f combatants simulated per ms."), CombatantCount, NumFrames, ElapsedMs, Throughput));
+	TestTrue(FString::Printf(TEXT("Throughput of %.0f combatants per ms is at least %.0f"), Throughput, CombatSimulationTests::MinThroughput), Throughput >= CombatSimulationTests::MinThroughput);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
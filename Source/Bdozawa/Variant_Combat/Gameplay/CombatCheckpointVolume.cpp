@@ -4,6 +4,8 @@
 #include "CombatCheckpointVolume.h"
 #include "CombatCharacter.h"
 #include "CombatPlayerController.h"
+#include "CombatCheckpointSubsystem.h"
+#include "Engine/World.h"
 
 ACombatCheckpointVolume::ACombatCheckpointVolume()
 {
@@ -41,7 +43,40 @@ void ACombatCheckpointVolume::OnOverlap(UPrimitiveComponent* OverlappedComponent
 
 			// update the player's respawn checkpoint
 			PC->SetRespawnTransform(PlayerCharacter->GetActorTransform());
+
+			// save the world state so it can be restored when the player respawns
+			if (UCombatCheckpointSubsystem* Checkpoints = GetWorld()->GetSubsystem<UCombatCheckpointSubsystem>())
+			{
+				Checkpoints->CaptureSnapshot();
+			}
 		}
 
 	}
 }
+
+void ACombatCheckpointVolume::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// save our state in checkpoint snapshots
+	if (UCombatCheckpointSubsystem* Checkpoints = GetWorld()->GetSubsystem<UCombatCheckpointSubsystem>())
+	{
+		Checkpoints->RegisterCheckpointable(this);
+	}
+}
+
+void ACombatCheckpointVolume::EndPlay(EEndPlayReason::Type EndPlayReason)
+{
+	Super::EndPlay(EndPlayReason);
+
+	// leave the checkpoint snapshots
+	if (UCombatCheckpointSubsystem* Checkpoints = GetWorld()->GetSubsystem<UCombatCheckpointSubsystem>())
+	{
+		Checkpoints->UnregisterCheckpointable(this);
+	}
+}
+
+void ACombatCheckpointVolume::SerializeCheckpoint(FArchive& Ar)
+{
+	Ar << bCheckpointUsed;
+}
@@ -5,10 +5,15 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "Components/BoxComponent.h"
+#include "CombatCheckpointable.h"
 #include "CombatCheckpointVolume.generated.h"
 
+/**
+ *  Sets the player's respawn checkpoint when entered, and captures a checkpoint snapshot of the world state
+ *  so the arena can be reset without a level reload when the player dies.
+ */
 UCLASS(abstract)
-class ACombatCheckpointVolume : public AActor
+class ACombatCheckpointVolume : public AActor, public ICombatCheckpointable
 {
 	GENERATED_BODY()
 	
@@ -29,4 +34,19 @@ protected:
 	/** Handles overlaps with the box volume */
 	UFUNCTION()
 	void OnOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+
+	/** Initialization */
+	virtual void BeginPlay() override;
+
+	/** Cleanup */
+	virtual void EndPlay(EEndPlayReason::Type EndPlayReason) override;
+
+public:
+
+	// ~begin ICombatCheckpointable interface
+
+	/** Saves or restores the checkpoint used flag */
+	virtual void SerializeCheckpoint(FArchive& Ar) override;
+
+	// ~end ICombatCheckpointable interface
 };
@@ -5,6 +5,8 @@
 #include "Components/StaticMeshComponent.h"
 #include "TimerManager.h"
 #include "Engine/World.h"
+#include "CombatBroadphaseSubsystem.h"
+#include "CombatCheckpointSubsystem.h"
 
 ACombatDamageableBox::ACombatDamageableBox()
 {
@@ -25,8 +27,61 @@ ACombatDamageableBox::ACombatDamageableBox()
 
 void ACombatDamageableBox::RemoveFromLevel()
 {
-	// destroy this actor
-	Destroy();
+	bRemovedFromLevel = true;
+
+	// hide the box and stop simulating it, but keep the actor around so a checkpoint restore can bring it back
+	Mesh->SetSimulatePhysics(false);
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+
+	// remove the box from the combat broadphase
+	if (UCombatBroadphaseSubsystem* Broadphase = GetWorld()->GetSubsystem<UCombatBroadphaseSubsystem>())
+	{
+		Broadphase->UnregisterDamageable(this);
+	}
+}
+
+void ACombatDamageableBox::ReturnToLevel()
+{
+	GetWorld()->GetTimerManager().ClearTimer(DeathTimer);
+
+	// undo the death collision change
+	Mesh->SetCollisionObjectType(MeshObjectType);
+
+	if (bRemovedFromLevel)
+	{
+		bRemovedFromLevel = false;
+
+		SetActorHiddenInGame(false);
+		SetActorEnableCollision(true);
+		Mesh->SetSimulatePhysics(true);
+
+		// rejoin the combat broadphase
+		if (UCombatBroadphaseSubsystem* Broadphase = GetWorld()->GetSubsystem<UCombatBroadphaseSubsystem>())
+		{
+			Broadphase->RegisterDamageable(this, Mesh);
+		}
+	}
+}
+
+void ACombatDamageableBox::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// save the object type so it can be restored after the box dies
+	MeshObjectType = Mesh->GetCollisionObjectType();
+
+	// add the box to the combat broadphase
+	if (UCombatBroadphaseSubsystem* Broadphase = GetWorld()->GetSubsystem<UCombatBroadphaseSubsystem>())
+	{
+		Broadphase->RegisterDamageable(this, Mesh);
+	}
+
+	// save our state in checkpoint snapshots
+	if (UCombatCheckpointSubsystem* Checkpoints = GetWorld()->GetSubsystem<UCombatCheckpointSubsystem>())
+	{
+		Checkpoints->RegisterCheckpointable(this);
+	}
 }
 
 void ACombatDamageableBox::EndPlay(EEndPlayReason::Type EndPlayReason)
@@ -35,6 +90,18 @@ void ACombatDamageableBox::EndPlay(EEndPlayReason::Type EndPlayReason)
 
 	// clear the death timer
 	GetWorld()->GetTimerManager().ClearTimer(DeathTimer);
+
+	// remove the box from the combat broadphase
+	if (UCombatBroadphaseSubsystem* Broadphase = GetWorld()->GetSubsystem<UCombatBroadphaseSubsystem>())
+	{
+		Broadphase->UnregisterDamageable(this);
+	}
+
+	// leave the checkpoint snapshots
+	if (UCombatCheckpointSubsystem* Checkpoints = GetWorld()->GetSubsystem<UCombatCheckpointSubsystem>())
+	{
+		Checkpoints->UnregisterCheckpointable(this);
+	}
 }
 
 void ACombatDamageableBox::ApplyDamage(float Damage, AActor* DamageCauser, const FVector& DamageLocation, const FVector& DamageImpulse)
@@ -76,3 +143,33 @@ void ACombatDamageableBox::ApplyHealing(float Healing, AActor* Healer)
 	// stub
 }
 
+void ACombatDamageableBox::SerializeCheckpoint(FArchive& Ar)
+{
+	FTransform BoxTransform = GetActorTransform();
+
+	Ar << CurrentHP;
+	Ar << BoxTransform;
+
+	if (Ar.IsLoading())
+	{
+		// boxes that were dead at the checkpoint don't come back
+		if (CurrentHP <= 0.0f)
+		{
+			GetWorld()->GetTimerManager().ClearTimer(DeathTimer);
+
+			if (!bRemovedFromLevel)
+			{
+				RemoveFromLevel();
+			}
+
+			return;
+		}
+
+		ReturnToLevel();
+
+		// put the box back at rest where it was
+		SetActorTransform(BoxTransform, false, nullptr, ETeleportType::ResetPhysics);
+		Mesh->SetPhysicsLinearVelocity(FVector::ZeroVector);
+		Mesh->SetPhysicsAngularVelocityInDegrees(FVector::ZeroVector);
+	}
+}
@@ -5,13 +5,15 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "CombatDamageable.h"
+#include "CombatCheckpointable.h"
 #include "CombatDamageableBox.generated.h"
 
 /**
  *  A simple physics box that reacts to damage through the ICombatDamageable interface
+ *  Destroyed boxes are hidden rather than destroyed, so checkpoint restores can bring them back
  */
 UCLASS(abstract)
-class ACombatDamageableBox : public AActor, public ICombatDamageable
+class ACombatDamageableBox : public AActor, public ICombatDamageable, public ICombatCheckpointable
 {
 	GENERATED_BODY()
 	
@@ -37,6 +39,12 @@ protected:
 	/** Timer to defer destruction of this box after its HP are depleted */
 	FTimerHandle DeathTimer;
 
+	/** Collision object type of the mesh on spawn, restored when the box is brought back by a checkpoint */
+	TEnumAsByte<ECollisionChannel> MeshObjectType = ECC_WorldDynamic;
+
+	/** True once the box has been removed from the level */
+	bool bRemovedFromLevel = false;
+
 	/** Blueprint damage handler for effect playback */
 	UFUNCTION(BlueprintImplementableEvent, Category="Damage")
 	void OnBoxDamaged(const FVector& DamageLocation, const FVector& DamageImpulse);
@@ -48,8 +56,14 @@ protected:
 	/** Timer callback to remove the box from the level after it dies */
 	void RemoveFromLevel();
 
+	/** Puts a removed or dying box back into play */
+	void ReturnToLevel();
+
 public:
 
+	/** Initialization */
+	virtual void BeginPlay() override;
+
 	/** EndPlay cleanup */
 	void EndPlay(EEndPlayReason::Type EndPlayReason) override;
 
@@ -65,4 +79,11 @@ public:
 	virtual void ApplyHealing(float Healing, AActor* Healer) override;
 
 	// ~End CombatDamageable interface
+
+	// ~Begin CombatCheckpointable interface
+
+	/** Saves or restores the box's HP and transform */
+	virtual void SerializeCheckpoint(FArchive& Ar) override;
+
+	// ~End CombatCheckpointable interface
 };
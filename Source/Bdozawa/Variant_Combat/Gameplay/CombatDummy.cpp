@@ -5,6 +5,8 @@
 #include "Components/SceneComponent.h"
 #include "Components/StaticMeshComponent.h"
 #include "PhysicsEngine/PhysicsConstraintComponent.h"
+#include "Engine/World.h"
+#include "CombatBroadphaseSubsystem.h"
 
 ACombatDummy::ACombatDummy()
 {
@@ -31,6 +33,28 @@ ACombatDummy::ACombatDummy()
 	PhysicsConstraint->SetConstrainedComponents(BasePlate, NAME_None, Dummy, NAME_None);
 }
 
+void ACombatDummy::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// add the dummy to the combat broadphase
+	if (UCombatBroadphaseSubsystem* Broadphase = GetWorld()->GetSubsystem<UCombatBroadphaseSubsystem>())
+	{
+		Broadphase->RegisterDamageable(this, Dummy);
+	}
+}
+
+void ACombatDummy::EndPlay(EEndPlayReason::Type EndPlayReason)
+{
+	Super::EndPlay(EndPlayReason);
+
+	// remove the dummy from the combat broadphase
+	if (UCombatBroadphaseSubsystem* Broadphase = GetWorld()->GetSubsystem<UCombatBroadphaseSubsystem>())
+	{
+		Broadphase->UnregisterDamageable(this);
+	}
+}
+
 void ACombatDummy::ApplyDamage(float Damage, AActor* DamageCauser, const FVector& DamageLocation, const FVector& DamageImpulse)
 {
 	// apply impulse to the dummy
@@ -39,6 +39,12 @@ public:
 	/** Constructor */
 	ACombatDummy();
 
+	/** Initialization */
+	virtual void BeginPlay() override;
+
+	/** Cleanup */
+	virtual void EndPlay(EEndPlayReason::Type EndPlayReason) override;
+
 	// ~Begin CombatDamageable interface
 
 		/** Handles damage and knockback events */
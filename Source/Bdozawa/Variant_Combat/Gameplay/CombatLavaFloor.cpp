@@ -4,6 +4,9 @@
 #include "CombatLavaFloor.h"
 #include "CombatDamageable.h"
 #include "Components/StaticMeshComponent.h"
+#include "Engine/World.h"
+#include "CombatDamageSubsystem.h"
+#include "CombatFactionComponent.h"
 
 ACombatLavaFloor::ACombatLavaFloor()
 {
@@ -14,14 +17,25 @@ ACombatLavaFloor::ACombatLavaFloor()
 
 	// bind the hit handler
 	Mesh->OnComponentHit.AddDynamic(this, &ACombatLavaFloor::OnFloorHit);
+
+	// create the faction component. Lava damages every faction by default
+	Faction = CreateDefaultSubobject<UCombatFactionComponent>(TEXT("Faction"));
+	Faction->SetFaction(ECombatFaction::Neutral, ECombatFaction::Player | ECombatFaction::Enemy | ECombatFaction::Neutral);
 }
 
 void ACombatLavaFloor::OnFloorHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
 {
+	// skip actors the lava isn't set up to damage
+	if (!Faction->IsHostileTo(OtherActor))
+	{
+		return;
+	}
+
 	// check if the hit actor is damageable by casting to the interface
-	if (ICombatDamageable* Damageable = Cast<ICombatDamageable>(OtherActor))
+	if (Cast<ICombatDamageable>(OtherActor))
 	{
-		// damage the actor
-		Damageable->ApplyDamage(Damage, this, Hit.ImpactPoint, FVector::ZeroVector);
+		// queue damage for the actor. Each hit event counts as its own swing
+		UCombatDamageSubsystem* DamageSubsystem = GetWorld()->GetSubsystem<UCombatDamageSubsystem>();
+		DamageSubsystem->QueueDamage(OtherActor, Damage, this, Hit.ImpactPoint, FVector::ZeroVector, DamageSubsystem->BeginSwing());
 	}
 }
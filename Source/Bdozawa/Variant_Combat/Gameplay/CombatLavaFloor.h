@@ -8,6 +8,7 @@
 
 class UStaticMeshComponent;
 class UPrimitiveComponent;
+class UCombatFactionComponent;
 
 /**
  *  A basic actor that applies damage on contact through the ICombatDamageable interface. 
@@ -21,6 +22,10 @@ class ACombatLavaFloor : public AActor
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components", meta = (AllowPrivateAccess = "true"))
 	UStaticMeshComponent* Mesh;
 
+	/** Combat faction component */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components", meta = (AllowPrivateAccess = "true"))
+	UCombatFactionComponent* Faction;
+
 protected:
 
 	/** Amount of damage to deal on contact */
@@ -33,4 +33,7 @@ public:
 	/** Performs a charged attack's check to loop the charge animation. Usually called from a montage's AnimNotify */
 	UFUNCTION(BlueprintCallable, Category="Attacker")
 	virtual void CheckChargedAttack() = 0;
+
+	/** Returns true while attack timing is driven by an attack timeline. Montage notifies are ignored while this is true */
+	virtual bool IsAttackTimelineActive() const { return false; }
 };
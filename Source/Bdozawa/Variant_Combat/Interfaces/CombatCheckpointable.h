@@ -0,0 +1,28 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "CombatCheckpointable.generated.h"
+
+/**
+ *  Checkpointable Interface
+ *  Provides a way for actors and subsystems to save their gameplay state into checkpoint snapshots and restore it
+ *  without a level reload. Implementers register with the checkpoint subsystem to be included in snapshots.
+ */
+UINTERFACE(MinimalAPI, NotBlueprintable)
+class UCombatCheckpointable : public UInterface
+{
+	GENERATED_BODY()
+};
+
+class ICombatCheckpointable
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Writes the actor's checkpoint state when saving, or reads and applies it when loading */
+	virtual void SerializeCheckpoint(FArchive& Ar) = 0;
+};
@@ -0,0 +1,134 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatBroadphase.h"
+#include "BdozawaFrameArena.h"
+
+void FCombatBroadphase::Reset()
+{
+	Shapes.Reset();
+	ShapeCells.Reset();
+	SortedIndices.Reset();
+	Cells.Reset();
+
+	MaxShapeExtent = 0.0f;
+}
+
+int32 FCombatBroadphase::AddShape(const FCombatBroadphaseShape& Shape)
+{
+	// keep track of the largest shape so queries can be expanded to cover it
+	MaxShapeExtent = FMath::Max(MaxShapeExtent, Shape.Radius + Shape.HalfHeight);
+
+	return Shapes.Add(Shape);
+}
+
+void FCombatBroadphase::Build(float InCellSize)
+{
+	CellSize = FMath::Max(InCellSize, 1.0f);
+
+	// find the cell for each shape and count the shapes per cell
+	ShapeCells.SetNumUninitialized(Shapes.Num(), EAllowShrinking::No);
+
+	for (int32 i = 0; i < Shapes.Num(); ++i)
+	{
+		ShapeCells[i] = GetCell(Shapes[i].Center);
+		++Cells.FindOrAdd(ShapeCells[i]).Num;
+	}
+
+	// assign each cell its starting offset in the sorted array
+	int32 Offset = 0;
+
+	for (TPair<FIntVector, FCellRange>& CurrentCell : Cells)
+	{
+		CurrentCell.Value.Start = Offset;
+		Offset += CurrentCell.Value.Num;
+
+		// reset the count so we can use it as an insertion cursor
+		CurrentCell.Value.Num = 0;
+	}
+
+	// scatter the shape indices into their cells
+	SortedIndices.SetNumUninitialized(Shapes.Num(), EAllowShrinking::No);
+
+	for (int32 i = 0; i < Shapes.Num(); ++i)
+	{
+		FCellRange& Range = Cells.FindChecked(ShapeCells[i]);
+		SortedIndices[Range.Start + Range.Num] = i;
+		++Range.Num;
+	}
+}
+
+template<typename AllocatorType>
+void FCombatBroadphase::SweepSphere(const FVector& Start, const FVector& End, float Radius, int32 ObjectTypeMask, TArray<FCombatBroadphaseHit, AllocatorType>& OutHits) const
+{
+	if (Shapes.IsEmpty())
+	{
+		return;
+	}
+
+	// find the range of cells that may contain shapes touching the sweep
+	const float QueryExtent = Radius + MaxShapeExtent;
+
+	const FIntVector MinCell = GetCell(Start.ComponentMin(End) - FVector(QueryExtent));
+	const FIntVector MaxCell = GetCell(Start.ComponentMax(End) + FVector(QueryExtent));
+
+	for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+			{
+				const FCellRange* Range = Cells.Find(FIntVector(X, Y, Z));
+
+				if (!Range)
+				{
+					continue;
+				}
+
+				for (int32 i = Range->Start; i < Range->Start + Range->Num; ++i)
+				{
+					const int32 ShapeIndex = SortedIndices[i];
+					const FCombatBroadphaseShape& Shape = Shapes[ShapeIndex];
+
+					// skip object types we're not looking for
+					if ((Shape.ObjectTypeBit & ObjectTypeMask) == 0)
+					{
+						continue;
+					}
+
+					// find the closest points between the sweep and the capsule's inner segment
+					const FVector HalfSegment(0.0f, 0.0f, Shape.HalfHeight);
+
+					FVector SweepPoint, ShapePoint;
+					FMath::SegmentDistToSegmentSafe(Start, End, Shape.Center - HalfSegment, Shape.Center + HalfSegment, SweepPoint, ShapePoint);
+
+					// are the swept sphere and the capsule touching?
+					const float TouchDistance = Radius + Shape.Radius;
+					const FVector Delta = SweepPoint - ShapePoint;
+
+					if (Delta.SizeSquared() > FMath::Square(TouchDistance))
+					{
+						continue;
+					}
+
+					// report the point on the capsule surface facing the sweep
+					FCombatBroadphaseHit& Hit = OutHits.AddDefaulted_GetRef();
+					Hit.ShapeIndex = ShapeIndex;
+					Hit.ImpactNormal = Delta.GetSafeNormal(UE_SMALL_NUMBER, FVector::UpVector);
+					Hit.ImpactPoint = ShapePoint + (Hit.ImpactNormal * Shape.Radius);
+				}
+			}
+		}
+	}
+}
+
+template void FCombatBroadphase::SweepSphere<FDefaultAllocator>(const FVector&, const FVector&, float, int32, TArray<FCombatBroadphaseHit, FDefaultAllocator>&) const;
+template void FCombatBroadphase::SweepSphere<TFrameArenaAllocator<>>(const FVector&, const FVector&, float, int32, TArray<FCombatBroadphaseHit, TFrameArenaAllocator<>>&) const;
+
+FIntVector FCombatBroadphase::GetCell(const FVector& Location) const
+{
+	return FIntVector(
+		FMath::FloorToInt32(Location.X / CellSize),
+		FMath::FloorToInt32(Location.Y / CellSize),
+		FMath::FloorToInt32(Location.Z / CellSize));
+}
@@ -0,0 +1,96 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ *  Simplified collision shape stored in the combat broadphase.
+ *  Shapes are vertical capsules; spheres are represented with a zero half height.
+ */
+struct FCombatBroadphaseShape
+{
+	/** World space center of the shape */
+	FVector Center = FVector::ZeroVector;
+
+	/** Capsule radius */
+	float Radius = 0.0f;
+
+	/** Half height of the capsule's inner segment, excluding the radius */
+	float HalfHeight = 0.0f;
+
+	/** Collision object type bit of the shape, as returned by ECC_TO_BITFIELD */
+	int32 ObjectTypeBit = 0;
+};
+
+/**
+ *  A shape overlapped by a broadphase sweep
+ */
+struct FCombatBroadphaseHit
+{
+	/** Index of the shape that was hit */
+	int32 ShapeIndex = INDEX_NONE;
+
+	/** Point on the surface of the shape closest to the sweep */
+	FVector ImpactPoint = FVector::ZeroVector;
+
+	/** Surface normal at the impact point, pointing away from the shape */
+	FVector ImpactNormal = FVector::UpVector;
+};
+
+/**
+ *  Uniform spatial hash of simplified combat shapes.
+ *  Shapes are bucketed by their center, and queries are expanded by the largest shape extent,
+ *  so each shape is stored only once and never reported twice by the same query.
+ *  Rebuilding keeps all allocations, so steady state rebuilds don't allocate.
+ */
+class FCombatBroadphase
+{
+	/** Range of sorted shape indices stored in a single cell */
+	struct FCellRange
+	{
+		int32 Start = 0;
+		int32 Num = 0;
+	};
+
+	/** Shapes added since the last reset */
+	TArray<FCombatBroadphaseShape> Shapes;
+
+	/** Cell coordinates for each shape */
+	TArray<FIntVector> ShapeCells;
+
+	/** Shape indices, sorted by cell */
+	TArray<int32> SortedIndices;
+
+	/** Maps cell coordinates to their range of sorted indices */
+	TMap<FIntVector, FCellRange> Cells;
+
+	/** Size of each cell */
+	float CellSize = 400.0f;
+
+	/** Largest distance between a shape's center and its surface */
+	float MaxShapeExtent = 0.0f;
+
+public:
+
+	/** Removes all shapes, keeping the allocations */
+	void Reset();
+
+	/** Adds a shape. Returns its index */
+	int32 AddShape(const FCombatBroadphaseShape& Shape);
+
+	/** Buckets all added shapes into the grid */
+	void Build(float InCellSize);
+
+	/** Sweeps a sphere through the grid and collects all shapes it touches that match the object type mask. Instantiated for the default and frame arena allocators */
+	template<typename AllocatorType>
+	void SweepSphere(const FVector& Start, const FVector& End, float Radius, int32 ObjectTypeMask, TArray<FCombatBroadphaseHit, AllocatorType>& OutHits) const;
+
+	/** Returns the number of shapes in the grid */
+	int32 Num() const { return Shapes.Num(); }
+
+protected:
+
+	/** Returns the cell coordinates containing the given location */
+	FIntVector GetCell(const FVector& Location) const;
+};
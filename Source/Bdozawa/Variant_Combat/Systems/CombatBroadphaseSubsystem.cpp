@@ -0,0 +1,324 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatBroadphaseSubsystem.h"
+#include "Components/PrimitiveComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/SphereComponent.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+#include "Bdozawa.h"
+#include "CombatStats.h"
+#include "BdozawaFrameArena.h"
+#include "BdozawaAllocationScope.h"
+
+DECLARE_CYCLE_STAT(TEXT("Broadphase Rebuild"), STAT_CombatBroadphaseRebuild, STATGROUP_Combat);
+DECLARE_CYCLE_STAT(TEXT("Broadphase Sweep"), STAT_CombatBroadphaseSweep, STATGROUP_Combat);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Broadphase Damageables"), STAT_CombatBroadphaseDamageables, STATGROUP_Combat);
+
+static int32 GCombatBroadphaseEnabled = 1;
+static FAutoConsoleVariableRef CVarCombatBroadphaseEnabled(
+	TEXT("Combat.Broadphase.Enabled"),
+	GCombatBroadphaseEnabled,
+	TEXT("If 0, attackers set up to use the combat broadphase fall back to physics scene queries."),
+	ECVF_Default);
+
+static float GCombatBroadphaseCellSize = 400.0f;
+static FAutoConsoleVariableRef CVarCombatBroadphaseCellSize(
+	TEXT("Combat.Broadphase.CellSize"),
+	GCombatBroadphaseCellSize,
+	TEXT("Size in cm of each cell in the combat broadphase spatial hash."),
+	ECVF_Default);
+
+void UCombatBroadphaseSubsystem::RegisterDamageable(AActor* Actor, UPrimitiveComponent* Shape)
+{
+	// ensure the actor and shape are valid
+	if (!IsValid(Actor) || !IsValid(Shape))
+	{
+		return;
+	}
+
+	FRegisteredDamageable& NewDamageable = Damageables.AddDefaulted_GetRef();
+	NewDamageable.Actor = Actor;
+	NewDamageable.Shape = Shape;
+
+	INC_DWORD_STAT(STAT_CombatBroadphaseDamageables);
+}
+
+void UCombatBroadphaseSubsystem::UnregisterDamageable(AActor* Actor)
+{
+	// clear the actor's entries instead of removing them, since the grid still references their indices.
+	// Sweeps skip cleared entries, and the next rebuild drops them
+	for (FRegisteredDamageable& CurrentDamageable : Damageables)
+	{
+		if (CurrentDamageable.Actor.Get() == Actor && CurrentDamageable.Shape.IsValid())
+		{
+			CurrentDamageable.Actor.Reset();
+			CurrentDamageable.Shape.Reset();
+
+			DEC_DWORD_STAT(STAT_CombatBroadphaseDamageables);
+		}
+	}
+}
+
+void UCombatBroadphaseSubsystem::UnregisterShape(UPrimitiveComponent* Shape)
+{
+	// clear the shape's entry, same as when unregistering a whole actor
+	for (FRegisteredDamageable& CurrentDamageable : Damageables)
+	{
+		if (CurrentDamageable.Shape.Get() == Shape)
+		{
+			CurrentDamageable.Actor.Reset();
+			CurrentDamageable.Shape.Reset();
+
+			DEC_DWORD_STAT(STAT_CombatBroadphaseDamageables);
+		}
+	}
+}
+
+void UCombatBroadphaseSubsystem::SweepSphere(const FVector& Start, const FVector& End, float Radius, const FCollisionObjectQueryParams& ObjectParams, const AActor* IgnoredActor, TArray<FHitResult>& OutHits) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_CombatBroadphaseSweep);
+	BDOZAWA_ZERO_ALLOC_SCOPE("Combat.Broadphase.SweepSphere");
+
+	// query the grid. The hits only live until they're converted, so they go in the frame arena
+	TFrameArray<FCombatBroadphaseHit> BroadphaseHits;
+	Broadphase.SweepSphere(Start, End, Radius, ObjectParams.GetQueryBitfield(), BroadphaseHits);
+
+	// convert the broadphase hits into hit results
+	for (const FCombatBroadphaseHit& CurrentHit : BroadphaseHits)
+	{
+		const FRegisteredDamageable& Damageable = Damageables[ShapeOwners[CurrentHit.ShapeIndex]];
+
+		AActor* HitActor = Damageable.Actor.Get();
+
+		// skip stale or ignored actors
+		if (!HitActor || HitActor == IgnoredActor)
+		{
+			continue;
+		}
+
+		FHitResult& Hit = OutHits.Emplace_GetRef(Start, End);
+		Hit.HitObjectHandle = FActorInstanceHandle(HitActor);
+		Hit.Component = Damageable.Shape;
+		Hit.Location = CurrentHit.ImpactPoint;
+		Hit.ImpactPoint = CurrentHit.ImpactPoint;
+		Hit.Normal = CurrentHit.ImpactNormal;
+		Hit.ImpactNormal = CurrentHit.ImpactNormal;
+	}
+}
+
+bool UCombatBroadphaseSubsystem::IsBroadphaseEnabled()
+{
+	return GCombatBroadphaseEnabled != 0;
+}
+
+void UCombatBroadphaseSubsystem::RebuildGrid()
+{
+	SCOPE_CYCLE_COUNTER(STAT_CombatBroadphaseRebuild);
+
+	// drop entries cleared since the last rebuild. Order doesn't matter since the grid is rebuilt from scratch
+	Damageables.RemoveAllSwap([](const FRegisteredDamageable& Damageable) { return !Damageable.Actor.IsValid() || !Damageable.Shape.IsValid(); }, EAllowShrinking::No);
+
+	Broadphase.Reset();
+	ShapeOwners.Reset();
+
+	for (int32 i = 0; i < Damageables.Num(); ++i)
+	{
+		const UPrimitiveComponent* Shape = Damageables[i].Shape.Get();
+
+		// skip shapes that have been destroyed or can't currently be hit
+		if (!Shape || !Shape->IsQueryCollisionEnabled())
+		{
+			continue;
+		}
+
+		// build the simplified shape from the component's current bounds
+		FCombatBroadphaseShape NewShape;
+		NewShape.Center = Shape->Bounds.Origin;
+		NewShape.ObjectTypeBit = ECC_TO_BITFIELD(Shape->GetCollisionObjectType());
+
+		const UCapsuleComponent* Capsule = Cast<UCapsuleComponent>(Shape);
+
+		if (Capsule && FMath::Abs(Capsule->GetUpVector().Z) > 0.99f)
+		{
+			// upright capsules map directly to the broadphase shape
+			NewShape.Radius = Capsule->GetScaledCapsuleRadius();
+			NewShape.HalfHeight = Capsule->GetScaledCapsuleHalfHeight_WithoutHemisphere();
+
+		} else {
+
+			// approximate everything else with a vertical capsule wrapping the bounds
+			const FVector Extent = Shape->Bounds.BoxExtent;
+
+			NewShape.Radius = FMath::Max(Extent.X, Extent.Y);
+			NewShape.HalfHeight = FMath::Max(Extent.Z - NewShape.Radius, 0.0f);
+		}
+
+		Broadphase.AddShape(NewShape);
+		ShapeOwners.Add(i);
+	}
+
+	Broadphase.Build(GCombatBroadphaseCellSize);
+}
+
+void UCombatBroadphaseSubsystem::OnPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds)
+{
+	// the delegate is global, so ignore other worlds
+	if (InWorld == GetWorld())
+	{
+		RebuildGrid();
+	}
+}
+
+void UCombatBroadphaseSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// update the grid once per frame, after everything has moved
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UCombatBroadphaseSubsystem::OnPostActorTick);
+}
+
+void UCombatBroadphaseSubsystem::Deinitialize()
+{
+	// unsubscribe from the world delegate
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+
+	Damageables.Empty();
+	ShapeOwners.Empty();
+	Broadphase.Reset();
+
+	Super::Deinitialize();
+}
+
+bool UCombatBroadphaseSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+////////////////////////////////////////////////////////////////////
+
+/** Compares melee sweeps against the physics scene and the combat broadphase with a varying number of damageables */
+static void RunCombatBroadphaseBenchmark(const TArray<FString>& Args, UWorld* World)
+{
+	if (!World)
+	{
+		return;
+	}
+
+	const int32 NumQueries = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 1000;
+
+	// benchmark parameters, roughly matching the combat characters' defaults
+	const int32 DamageableCounts[] = { 50, 200, 1000 };
+	const FVector Origin(0.0f, 0.0f, 100000.0f);
+	const float ArenaSize = 10000.0f;
+	const float ShapeRadius = 40.0f;
+	const float SweepDistance = 75.0f;
+	const float SweepRadius = 75.0f;
+
+	FCollisionObjectQueryParams ObjectParams;
+	ObjectParams.AddObjectTypesToQuery(ECC_WorldDynamic);
+
+	for (const int32 DamageableCount : DamageableCounts)
+	{
+		FRandomStream Stream(DamageableCount);
+
+		// spawn a temporary host actor for the physics shapes, far away from the level
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.ObjectFlags |= RF_Transient;
+
+		AActor* Host = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform(Origin), SpawnParams);
+
+		if (!Host)
+		{
+			continue;
+		}
+
+		FCombatBroadphase Grid;
+
+		for (int32 i = 0; i < DamageableCount; ++i)
+		{
+			const FVector Location = Origin + FVector(Stream.FRandRange(-0.5f, 0.5f) * ArenaSize, Stream.FRandRange(-0.5f, 0.5f) * ArenaSize, 0.0f);
+
+			// add a query only sphere to the physics scene
+			USphereComponent* Sphere = NewObject<USphereComponent>(Host);
+			Sphere->SetSphereRadius(ShapeRadius);
+			Sphere->SetCollisionProfileName(FName("OverlapAllDynamic"));
+			Sphere->SetWorldLocation(Location);
+
+			if (!Host->GetRootComponent())
+			{
+				Host->SetRootComponent(Sphere);
+			}
+
+			Sphere->RegisterComponent();
+
+			// add the same sphere to the broadphase
+			FCombatBroadphaseShape Shape;
+			Shape.Center = Location;
+			Shape.Radius = ShapeRadius;
+			Shape.ObjectTypeBit = ECC_TO_BITFIELD(ECC_WorldDynamic);
+
+			Grid.AddShape(Shape);
+		}
+
+		// generate the sweeps
+		TArray<FVector> SweepStarts;
+		TArray<FVector> SweepEnds;
+
+		for (int32 i = 0; i < NumQueries; ++i)
+		{
+			const FVector Start = Origin + FVector(Stream.FRandRange(-0.5f, 0.5f) * ArenaSize, Stream.FRandRange(-0.5f, 0.5f) * ArenaSize, 0.0f);
+			const FVector Direction = FVector(Stream.FRandRange(-1.0f, 1.0f), Stream.FRandRange(-1.0f, 1.0f), 0.0f).GetSafeNormal();
+
+			SweepStarts.Add(Start);
+			SweepEnds.Add(Start + (Direction * SweepDistance));
+		}
+
+		// time the physics scene sweeps
+		TArray<FHitResult> PhysicsHits;
+		int32 NumPhysicsHits = 0;
+
+		const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(CombatBroadphaseBenchmark), false);
+
+		const double PhysicsStartTime = FPlatformTime::Seconds();
+
+		for (int32 i = 0; i < NumQueries; ++i)
+		{
+			PhysicsHits.Reset();
+			World->SweepMultiByObjectType(PhysicsHits, SweepStarts[i], SweepEnds[i], FQuat::Identity, ObjectParams, FCollisionShape::MakeSphere(SweepRadius), QueryParams);
+			NumPhysicsHits += PhysicsHits.Num();
+		}
+
+		const double PhysicsTime = FPlatformTime::Seconds() - PhysicsStartTime;
+
+		// time the broadphase sweeps, including one grid rebuild as it would happen every frame
+		TArray<FCombatBroadphaseHit> GridHits;
+		int32 NumGridHits = 0;
+
+		const double GridStartTime = FPlatformTime::Seconds();
+
+		Grid.Build(GCombatBroadphaseCellSize);
+
+		for (int32 i = 0; i < NumQueries; ++i)
+		{
+			GridHits.Reset();
+			Grid.SweepSphere(SweepStarts[i], SweepEnds[i], SweepRadius, ObjectParams.GetQueryBitfield(), GridHits);
+			NumGridHits += GridHits.Num();
+		}
+
+		const double GridTime = FPlatformTime::Seconds() - GridStartTime;
+
+		UE_LOG(LogBdozawa, Log, TEXT("Combat broadphase benchmark: %d damageables, %d sweeps. Physics scene: %.3f ms (%d hits). Broadphase: %.3f ms (%d hits)."),
+			DamageableCount, NumQueries, PhysicsTime * 1000.0, NumPhysicsHits, GridTime * 1000.0, NumGridHits);
+
+		// clean up the physics shapes
+		Host->Destroy();
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs CombatBroadphaseBenchmarkCommand(
+	TEXT("Combat.Broadphase.Benchmark"),
+	TEXT("Compares melee sweeps against the physics scene and the combat broadphase at 50, 200 and 1000 damageables. Optional argument: number of sweeps."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunCombatBroadphaseBenchmark));
@@ -0,0 +1,82 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineTypes.h"
+#include "Engine/HitResult.h"
+#include "WorldCollision.h"
+#include "CombatBroadphase.h"
+#include "CombatBroadphaseSubsystem.generated.h"
+
+class UPrimitiveComponent;
+
+/**
+ *  Keeps track of every ICombatDamageable actor in the world and buckets them in a uniform spatial hash once per frame.
+ *  Melee attackers can query this grid instead of the physics scene,
+ *  so attacks don't pay for ragdoll bodies, simulated props or other unrelated dynamic objects.
+ */
+UCLASS()
+class UCombatBroadphaseSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** A registered damageable actor */
+	struct FRegisteredDamageable
+	{
+		/** Damageable actor */
+		TWeakObjectPtr<AActor> Actor;
+
+		/** Primitive whose bounds and collision settings represent the actor in the grid */
+		TWeakObjectPtr<UPrimitiveComponent> Shape;
+	};
+
+	/** All registered damageables */
+	TArray<FRegisteredDamageable> Damageables;
+
+	/** Maps each shape in the grid back to its index in the damageables list */
+	TArray<int32> ShapeOwners;
+
+	/** Spatial hash rebuilt every frame */
+	FCombatBroadphase Broadphase;
+
+	/** Handle to the world post actor tick delegate */
+	FDelegateHandle PostActorTickHandle;
+
+public:
+
+	/** Adds a damageable actor's shape to the grid. The shape's bounds and collision object type will be used for queries. Actors may register multiple shapes */
+	void RegisterDamageable(AActor* Actor, UPrimitiveComponent* Shape);
+
+	/** Removes all of a damageable actor's shapes from the grid. The shapes stop being hit right away, and are dropped from the grid on the next rebuild */
+	void UnregisterDamageable(AActor* Actor);
+
+	/** Removes a single shape from the grid. The shape stops being hit right away, and is dropped from the grid on the next rebuild */
+	void UnregisterShape(UPrimitiveComponent* Shape);
+
+	/** Sweeps a sphere against the grid and outputs hit results for every damageable it touches */
+	void SweepSphere(const FVector& Start, const FVector& End, float Radius, const FCollisionObjectQueryParams& ObjectParams, const AActor* IgnoredActor, TArray<FHitResult>& OutHits) const;
+
+	/** Returns true if melee queries are allowed to use the grid */
+	static bool IsBroadphaseEnabled();
+
+	/** Drops unregistered damageables and rebuilds the spatial hash from the current damageable locations */
+	void RebuildGrid();
+
+protected:
+
+	/** Rebuilds the grid after all actors have ticked */
+	void OnPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds);
+
+public:
+
+	// ~begin USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	// ~end USubsystem interface
+
+	// ~begin UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	// ~end UWorldSubsystem interface
+};
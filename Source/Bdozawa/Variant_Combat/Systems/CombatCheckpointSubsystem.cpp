@@ -0,0 +1,267 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatCheckpointSubsystem.h"
+#include "CombatCheckpointable.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "CombatStats.h"
+#include "Bdozawa.h"
+
+DECLARE_CYCLE_STAT(TEXT("Checkpoint Capture"), STAT_CombatCheckpointCapture, STATGROUP_Combat);
+DECLARE_CYCLE_STAT(TEXT("Checkpoint Restore"), STAT_CombatCheckpointRestore, STATGROUP_Combat);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Checkpointables"), STAT_CombatCheckpointables, STATGROUP_Combat);
+DECLARE_MEMORY_STAT(TEXT("Checkpoint Snapshot"), STAT_CombatCheckpointSnapshotMemory, STATGROUP_Combat);
+
+static int32 GCombatCheckpointsRestoreOnRespawn = 1;
+static FAutoConsoleVariableRef CVarCombatCheckpointsRestoreOnRespawn(
+	TEXT("Combat.Checkpoints.RestoreOnRespawn"),
+	GCombatCheckpointsRestoreOnRespawn,
+	TEXT("If nonzero, the world state captured at the last checkpoint is restored when the player respawns."),
+	ECVF_Default);
+
+namespace CombatCheckpoints
+{
+	/** Written at the start of every snapshot, bumped when the record layout changes */
+	static const uint32 SnapshotVersion = 2;
+
+	/** Time a level reload benchmark was started. Zero if none is pending */
+	static double ReloadBenchmarkStartTime = 0.0;
+}
+
+bool UCombatCheckpointSubsystem::IsRestoreOnRespawnEnabled()
+{
+	return GCombatCheckpointsRestoreOnRespawn != 0;
+}
+
+void UCombatCheckpointSubsystem::RegisterCheckpointable(UObject* Object)
+{
+	if (Cast<ICombatCheckpointable>(Object))
+	{
+		Checkpointables.Add(Object->GetPathName(), Object);
+
+		SET_DWORD_STAT(STAT_CombatCheckpointables, Checkpointables.Num());
+	}
+}
+
+void UCombatCheckpointSubsystem::UnregisterCheckpointable(UObject* Object)
+{
+	if (Object)
+	{
+		Checkpointables.Remove(Object->GetPathName());
+
+		SET_DWORD_STAT(STAT_CombatCheckpointables, Checkpointables.Num());
+	}
+}
+
+void UCombatCheckpointSubsystem::CaptureSnapshot()
+{
+	SCOPE_CYCLE_COUNTER(STAT_CombatCheckpointCapture);
+
+	// keep the allocation, snapshots are usually the same size
+	Snapshot.Reset();
+
+	FMemoryWriter Writer(Snapshot);
+
+	uint32 Version = CombatCheckpoints::SnapshotVersion;
+	int32 NumRecords = 0;
+
+	Writer << Version;
+
+	// the record count is patched in once we know how many actors are still valid
+	const int64 NumRecordsOffset = Writer.Tell();
+	Writer << NumRecords;
+
+	for (const TPair<FString, TWeakObjectPtr<UObject>>& Pair : Checkpointables)
+	{
+		ICombatCheckpointable* Checkpointable = Cast<ICombatCheckpointable>(Pair.Value.Get());
+
+		if (!Checkpointable)
+		{
+			continue;
+		}
+
+		// each record is its key and its size, so records of missing objects can be skipped on restore
+		FString Key = Pair.Key;
+		Writer << Key;
+
+		int32 RecordSize = 0;
+		const int64 RecordSizeOffset = Writer.Tell();
+		Writer << RecordSize;
+
+		Checkpointable->SerializeCheckpoint(Writer);
+
+		const int64 RecordEnd = Writer.Tell();
+		RecordSize = static_cast<int32>(RecordEnd - RecordSizeOffset - sizeof(int32));
+
+		Writer.Seek(RecordSizeOffset);
+		Writer << RecordSize;
+		Writer.Seek(RecordEnd);
+
+		++NumRecords;
+	}
+
+	const int64 SnapshotEnd = Writer.Tell();
+	Writer.Seek(NumRecordsOffset);
+	Writer << NumRecords;
+	Writer.Seek(SnapshotEnd);
+
+	SET_MEMORY_STAT(STAT_CombatCheckpointSnapshotMemory, Snapshot.GetAllocatedSize());
+}
+
+bool UCombatCheckpointSubsystem::RestoreSnapshot()
+{
+	SCOPE_CYCLE_COUNTER(STAT_CombatCheckpointRestore);
+
+	if (Snapshot.IsEmpty())
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(Snapshot);
+
+	uint32 Version = 0;
+	int32 NumRecords = 0;
+
+	Reader << Version;
+
+	if (Version != CombatCheckpoints::SnapshotVersion)
+	{
+		UE_LOG(LogBdozawa, Warning, TEXT("Discarding checkpoint snapshot with version %u, expected %u."), Version, CombatCheckpoints::SnapshotVersion);
+		Snapshot.Reset();
+		return false;
+	}
+
+	Reader << NumRecords;
+
+	for (int32 i = 0; i < NumRecords && !Reader.IsError(); ++i)
+	{
+		FString Key;
+		int32 RecordSize = 0;
+
+		Reader << Key;
+		Reader << RecordSize;
+
+		const int64 RecordEnd = Reader.Tell() + RecordSize;
+
+		// skip records of objects that are gone
+		const TWeakObjectPtr<UObject>* Object = Checkpointables.Find(Key);
+
+		if (ICombatCheckpointable* Checkpointable = Object ? Cast<ICombatCheckpointable>(Object->Get()) : nullptr)
+		{
+			Checkpointable->SerializeCheckpoint(Reader);
+
+			// make sure a record that read too much or too little doesn't throw off the next one
+			ensureMsgf(Reader.Tell() == RecordEnd, TEXT("Checkpoint record for %s read %lld bytes, expected %d."), *Key, Reader.Tell() - (RecordEnd - RecordSize), RecordSize);
+		}
+
+		Reader.Seek(RecordEnd);
+	}
+
+	return !Reader.IsError();
+}
+
+void UCombatCheckpointSubsystem::Deinitialize()
+{
+	Checkpointables.Empty();
+	Snapshot.Empty();
+
+	SET_DWORD_STAT(STAT_CombatCheckpointables, 0);
+	SET_MEMORY_STAT(STAT_CombatCheckpointSnapshotMemory, 0);
+
+	Super::Deinitialize();
+}
+
+bool UCombatCheckpointSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCombatCheckpointSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// finish a pending level reload benchmark
+	if (CombatCheckpoints::ReloadBenchmarkStartTime > 0.0)
+	{
+		const double ReloadTime = FPlatformTime::Seconds() - CombatCheckpoints::ReloadBenchmarkStartTime;
+		CombatCheckpoints::ReloadBenchmarkStartTime = 0.0;
+
+		UE_LOG(LogBdozawa, Log, TEXT("Combat checkpoint benchmark: level reload took %.3f ms."), ReloadTime * 1000.0);
+	}
+}
+
+////////////////////////////////////////////////////////////////////
+
+/** Times checkpoint snapshot captures and restores in the current world, then optionally times a level reload for comparison */
+static void RunCombatCheckpointBenchmark(const TArray<FString>& Args, UWorld* World)
+{
+	UCombatCheckpointSubsystem* Checkpoints = World ? World->GetSubsystem<UCombatCheckpointSubsystem>() : nullptr;
+
+	if (!Checkpoints)
+	{
+		return;
+	}
+
+	const int32 NumIterations = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 100;
+	const bool bReload = Args.Num() > 1 && FCString::Atoi(*Args[1]) != 0;
+
+	// capture the current state, so the restores leave the world as it is
+	double CaptureTime = FPlatformTime::Seconds();
+	Checkpoints->CaptureSnapshot();
+	CaptureTime = FPlatformTime::Seconds() - CaptureTime;
+
+	double TotalRestoreTime = 0.0;
+	double MaxRestoreTime = 0.0;
+
+	for (int32 i = 0; i < NumIterations; ++i)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		Checkpoints->RestoreSnapshot();
+		const double RestoreTime = FPlatformTime::Seconds() - StartTime;
+
+		TotalRestoreTime += RestoreTime;
+		MaxRestoreTime = FMath::Max(MaxRestoreTime, RestoreTime);
+	}
+
+	UE_LOG(LogBdozawa, Log, TEXT("Combat checkpoint benchmark: %d bytes. Capture: %.3f ms. Restore: %.3f ms average, %.3f ms max over %d iterations."),
+		Checkpoints->GetSnapshotSize(), CaptureTime * 1000.0, TotalRestoreTime * 1000.0 / NumIterations, MaxRestoreTime * 1000.0, NumIterations);
+
+	// reload the level and time it until the new world begins play
+	if (bReload)
+	{
+		CombatCheckpoints::ReloadBenchmarkStartTime = FPlatformTime::Seconds();
+		UGameplayStatics::OpenLevel(World, FName(UGameplayStatics::GetCurrentLevelName(World, true)));
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs CombatCheckpointBenchmarkCommand(
+	TEXT("Combat.Checkpoints.Benchmark"),
+	TEXT("Times checkpoint snapshot capture and restore. Optional arguments: number of restores, and 1 to also time a level reload for comparison."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunCombatCheckpointBenchmark));
+
+static FAutoConsoleCommandWithWorldAndArgs CombatCheckpointCaptureCommand(
+	TEXT("Combat.Checkpoints.Capture"),
+	TEXT("Captures a checkpoint snapshot of the current world state."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (UCombatCheckpointSubsystem* Checkpoints = World ? World->GetSubsystem<UCombatCheckpointSubsystem>() : nullptr)
+		{
+			Checkpoints->CaptureSnapshot();
+		}
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs CombatCheckpointRestoreCommand(
+	TEXT("Combat.Checkpoints.Restore"),
+	TEXT("Restores the last checkpoint snapshot."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (UCombatCheckpointSubsystem* Checkpoints = World ? World->GetSubsystem<UCombatCheckpointSubsystem>() : nullptr)
+		{
+			Checkpoints->RestoreSnapshot();
+		}
+	}));
@@ -0,0 +1,59 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatCheckpointSubsystem.generated.h"
+
+/**
+ *  Captures the gameplay state of checkpointable actors and subsystems into a compact binary snapshot, and restores it
+ *  in place so an arena can be retried without reloading the level.
+ *  Each registered object writes a record keyed by its path name, so objects can be restored even if
+ *  others have been added or removed since the snapshot was captured.
+ */
+UCLASS()
+class UCombatCheckpointSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Objects included in snapshots, keyed by path name. Plain names can repeat across streamed sublevels */
+	TMap<FString, TWeakObjectPtr<UObject>> Checkpointables;
+
+	/** Last captured snapshot */
+	TArray<uint8> Snapshot;
+
+public:
+
+	/** Returns true if the last snapshot should be restored when the player respawns */
+	static bool IsRestoreOnRespawnEnabled();
+
+	/** Adds an actor or subsystem to the snapshots. The object must implement ICombatCheckpointable */
+	void RegisterCheckpointable(UObject* Object);
+
+	/** Removes an actor or subsystem from the snapshots */
+	void UnregisterCheckpointable(UObject* Object);
+
+	/** Captures the state of all registered objects, replacing the last snapshot */
+	void CaptureSnapshot();
+
+	/** Applies the last snapshot to the registered objects. Returns false if there's no snapshot */
+	bool RestoreSnapshot();
+
+	/** Returns true if a snapshot has been captured */
+	bool HasSnapshot() const { return !Snapshot.IsEmpty(); }
+
+	/** Returns the size of the last snapshot, in bytes */
+	int32 GetSnapshotSize() const { return Snapshot.Num(); }
+
+public:
+
+	// ~begin USubsystem interface
+	virtual void Deinitialize() override;
+	// ~end USubsystem interface
+
+	// ~begin UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	// ~end UWorldSubsystem interface
+};
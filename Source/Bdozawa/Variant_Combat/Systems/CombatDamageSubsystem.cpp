@@ -0,0 +1,181 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatDamageSubsystem.h"
+#include "CombatDamageable.h"
+#include "CombatDamageNumberSubsystem.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "CombatStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Damage Flush"), STAT_CombatDamageFlush, STATGROUP_Combat);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage Events Queued"), STAT_CombatDamageQueued, STATGROUP_Combat);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage Events Coalesced"), STAT_CombatDamageCoalesced, STATGROUP_Combat);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage Events Applied"), STAT_CombatDamageApplied, STATGROUP_Combat);
+
+uint32 UCombatDamageSubsystem::BeginSwing()
+{
+	// skip zero on wraparound so it's never a valid swing
+	if (++LastSwingId == 0)
+	{
+		++LastSwingId;
+	}
+
+	return LastSwingId;
+}
+
+bool UCombatDamageSubsystem::QueueDamage(AActor* Target, float Damage, AActor* DamageCauser, const FVector& DamageLocation, const FVector& DamageImpulse, uint32 SwingId)
+{
+	// ignore invalid targets
+	if (!IsValid(Target))
+	{
+		return false;
+	}
+
+	++CurrentCounters.Queued;
+	INC_DWORD_STAT(STAT_CombatDamageQueued);
+
+	// has this target already been damaged this frame?
+	int32& PendingIndex = PendingIndices.FindOrAdd(Target, INDEX_NONE);
+
+	if (PendingIndex == INDEX_NONE)
+	{
+		// start a new entry for the target
+		PendingIndex = PendingDamage.Num();
+
+		FPendingDamage& NewDamage = PendingDamage.AddDefaulted_GetRef();
+		NewDamage.Target = Target;
+		NewDamage.DamageCauser = DamageCauser;
+		NewDamage.DamageLocation = DamageLocation;
+		NewDamage.DamageImpulse = DamageImpulse;
+		NewDamage.Damage = Damage;
+		NewDamage.StrongestHit = Damage;
+		NewDamage.Swings.Add({ SwingId, Damage });
+
+		return true;
+	}
+
+	++CurrentCounters.Coalesced;
+	INC_DWORD_STAT(STAT_CombatDamageCoalesced);
+
+	FPendingDamage& ExistingDamage = PendingDamage[PendingIndex];
+
+	// has this swing already hit the target?
+	if (FSwingHit* ExistingHit = ExistingDamage.Swings.FindByPredicate([SwingId](const FSwingHit& Hit) { return Hit.SwingId == SwingId; }))
+	{
+		// keep the highest damage, e.g. if the swing hit several hurtbox zones
+		if (Damage > ExistingHit->Damage)
+		{
+			ExistingDamage.Damage += Damage - ExistingHit->Damage;
+			ExistingHit->Damage = Damage;
+
+			if (Damage > ExistingDamage.StrongestHit)
+			{
+				ExistingDamage.StrongestHit = Damage;
+				ExistingDamage.DamageCauser = DamageCauser;
+				ExistingDamage.DamageLocation = DamageLocation;
+			}
+		}
+
+		return false;
+	}
+
+	ExistingDamage.Swings.Add({ SwingId, Damage });
+
+	// add the new hit to the target's damage
+	ExistingDamage.Damage += Damage;
+	ExistingDamage.DamageImpulse += DamageImpulse;
+
+	// report the strongest hit's causer and location
+	if (Damage > ExistingDamage.StrongestHit)
+	{
+		ExistingDamage.StrongestHit = Damage;
+		ExistingDamage.DamageCauser = DamageCauser;
+		ExistingDamage.DamageLocation = DamageLocation;
+	}
+
+	return true;
+}
+
+void UCombatDamageSubsystem::FlushDamage()
+{
+	SCOPE_CYCLE_COUNTER(STAT_CombatDamageFlush);
+
+	// swap the queue out so damage handlers can safely queue more damage for the next flush
+	Swap(PendingDamage, FlushingDamage);
+	PendingIndices.Reset();
+
+	// show the applied damage as floating numbers
+	UCombatDamageNumberSubsystem* DamageNumbers = UCombatDamageNumberSubsystem::IsEnabled() ? GetWorld()->GetSubsystem<UCombatDamageNumberSubsystem>() : nullptr;
+
+	for (const FPendingDamage& CurrentDamage : FlushingDamage)
+	{
+		// skip targets that were destroyed after being hit
+		AActor* Target = CurrentDamage.Target.Get();
+
+		if (!IsValid(Target))
+		{
+			continue;
+		}
+
+		if (ICombatDamageable* Damageable = Cast<ICombatDamageable>(Target))
+		{
+			++CurrentCounters.Applied;
+			INC_DWORD_STAT(STAT_CombatDamageApplied);
+
+			Damageable->ApplyDamage(CurrentDamage.Damage, CurrentDamage.DamageCauser.Get(), CurrentDamage.DamageLocation, CurrentDamage.DamageImpulse);
+
+			if (DamageNumbers)
+			{
+				// tint damage taken by players so it stands out from damage dealt
+				const APawn* TargetPawn = Cast<APawn>(Target);
+				const bool bPlayerDamaged = TargetPawn && TargetPawn->IsPlayerControlled();
+
+				DamageNumbers->AddDamageNumber(CurrentDamage.DamageLocation, CurrentDamage.Damage, bPlayerDamaged ? FLinearColor(1.0f, 0.2f, 0.2f) : FLinearColor(1.0f, 0.9f, 0.4f));
+			}
+		}
+	}
+
+	FlushingDamage.Reset();
+
+	// publish this frame's counters
+	LastFrameCounters = CurrentCounters;
+	CurrentCounters = FCombatDamageQueueCounters();
+}
+
+void UCombatDamageSubsystem::OnPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds)
+{
+	// the delegate is global, so ignore other worlds
+	if (InWorld != GetWorld())
+	{
+		return;
+	}
+
+	FlushDamage();
+}
+
+void UCombatDamageSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// apply damage once all actors have ticked and all attack traces have been resolved
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UCombatDamageSubsystem::OnPostActorTick);
+}
+
+void UCombatDamageSubsystem::Deinitialize()
+{
+	// unsubscribe from the world delegate
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+
+	// drop any damage that hasn't been applied
+	PendingDamage.Empty();
+	FlushingDamage.Empty();
+	PendingIndices.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UCombatDamageSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
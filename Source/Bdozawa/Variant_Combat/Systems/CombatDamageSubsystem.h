@@ -0,0 +1,122 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineTypes.h"
+#include "UObject/ObjectKey.h"
+#include "CombatDamageSubsystem.generated.h"
+
+/**
+ *  Damage queue counters for a single frame
+ */
+struct FCombatDamageQueueCounters
+{
+	/** Damage events received */
+	int32 Queued = 0;
+
+	/** Damage events merged into an event already queued for the same target */
+	int32 Coalesced = 0;
+
+	/** ApplyDamage calls made on damageable actors */
+	int32 Applied = 0;
+};
+
+/**
+ *  Collects all damage dealt during the frame and applies it once per target after all actors have ticked.
+ *  Hits from the same swing on the same target are only counted once, so multi-component hits
+ *  don't run the target's damage, ragdoll and UI handling several times.
+ *  Hits from different swings on the same target are added together into a single damage event.
+ */
+UCLASS()
+class UCombatDamageSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** A swing that has hit a target this frame */
+	struct FSwingHit
+	{
+		/** Swing ID */
+		uint32 SwingId = 0;
+
+		/** Damage dealt by the swing */
+		float Damage = 0.0f;
+	};
+
+	/** All damage queued this frame for a single target */
+	struct FPendingDamage
+	{
+		/** Damaged actor */
+		TWeakObjectPtr<AActor> Target;
+
+		/** Causer of the strongest hit */
+		TWeakObjectPtr<AActor> DamageCauser;
+
+		/** Location of the strongest hit */
+		FVector DamageLocation = FVector::ZeroVector;
+
+		/** Sum of all knockback impulses */
+		FVector DamageImpulse = FVector::ZeroVector;
+
+		/** Sum of all damage */
+		float Damage = 0.0f;
+
+		/** Damage of the strongest hit */
+		float StrongestHit = 0.0f;
+
+		/** Swings that have already hit this target this frame */
+		TArray<FSwingHit, TInlineAllocator<4>> Swings;
+	};
+
+	/** Damage queued this frame, one entry per target */
+	TArray<FPendingDamage> PendingDamage;
+
+	/** Damage being applied by the current flush. Kept around to reuse the allocation */
+	TArray<FPendingDamage> FlushingDamage;
+
+	/** Maps each damaged actor to its entry in the pending damage list */
+	TMap<TObjectKey<AActor>, int32> PendingIndices;
+
+	/** Last swing ID handed out */
+	uint32 LastSwingId = 0;
+
+	/** Counters for the frame being collected */
+	FCombatDamageQueueCounters CurrentCounters;
+
+	/** Counters for the last flushed frame */
+	FCombatDamageQueueCounters LastFrameCounters;
+
+	/** Handle to the world post actor tick delegate */
+	FDelegateHandle PostActorTickHandle;
+
+public:
+
+	/** Starts a new swing and returns its ID. A swing's damage is applied at most once per target */
+	uint32 BeginSwing();
+
+	/** Queues damage for the target. Returns true if this is the first time the swing hit the target. Repeated swing hits only keep the highest damage */
+	bool QueueDamage(AActor* Target, float Damage, AActor* DamageCauser, const FVector& DamageLocation, const FVector& DamageImpulse, uint32 SwingId);
+
+	/** Applies all queued damage right away */
+	void FlushDamage();
+
+	/** Returns the counters for the last flushed frame */
+	const FCombatDamageQueueCounters& GetLastFrameCounters() const { return LastFrameCounters; }
+
+protected:
+
+	/** Applies the frame's damage after all actors have ticked */
+	void OnPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds);
+
+public:
+
+	// ~begin USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	// ~end USubsystem interface
+
+	// ~begin UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	// ~end UWorldSubsystem interface
+};
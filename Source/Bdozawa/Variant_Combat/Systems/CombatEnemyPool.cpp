@@ -0,0 +1,179 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatEnemyPool.h"
+#include "CombatEnemy.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "CombatStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Enemy Pool Prewarm"), STAT_CombatEnemyPoolPrewarm, STATGROUP_Combat);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Enemy Pool Hits"), STAT_CombatEnemyPoolHits, STATGROUP_Combat);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Enemy Pool Misses"), STAT_CombatEnemyPoolMisses, STATGROUP_Combat);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Enemy Pool Parked"), STAT_CombatEnemyPoolParked, STATGROUP_Combat);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Enemy Pool Peak Parked"), STAT_CombatEnemyPoolPeakParked, STATGROUP_Combat);
+
+static int32 GCombatEnemyPoolEnabled = 1;
+static FAutoConsoleVariableRef CVarCombatEnemyPoolEnabled(
+	TEXT("Combat.EnemyPool.Enabled"),
+	GCombatEnemyPoolEnabled,
+	TEXT("0: dead enemies are destroyed and spawners always spawn new ones.\n")
+	TEXT("1: dead enemies are parked and reused by spawners."),
+	ECVF_Default);
+
+static int32 GCombatEnemyPoolPrewarmPerFrame = 1;
+static FAutoConsoleVariableRef CVarCombatEnemyPoolPrewarmPerFrame(
+	TEXT("Combat.EnemyPool.PrewarmPerFrame"),
+	GCombatEnemyPoolPrewarmPerFrame,
+	TEXT("Maximum number of enemies spawned per frame while pre-warming the pool."),
+	ECVF_Default);
+
+bool UCombatEnemyPool::IsPoolingEnabled()
+{
+	return GCombatEnemyPoolEnabled != 0;
+}
+
+ACombatEnemy* UCombatEnemyPool::AcquireEnemy(TSubclassOf<ACombatEnemy> EnemyClass, const FTransform& Transform)
+{
+	if (ACombatEnemy* ParkedEnemy = TryAcquireParkedEnemy(EnemyClass, Transform))
+	{
+		return ParkedEnemy;
+	}
+
+	return IsValid(EnemyClass) ? SpawnEnemy(EnemyClass, Transform) : nullptr;
+}
+
+ACombatEnemy* UCombatEnemyPool::TryAcquireParkedEnemy(TSubclassOf<ACombatEnemy> EnemyClass, const FTransform& Transform)
+{
+	if (!IsValid(EnemyClass))
+	{
+		return nullptr;
+	}
+
+	// reuse a parked enemy if we have one
+	if (FCombatEnemyPoolList* PoolList = ParkedEnemies.Find(EnemyClass))
+	{
+		while (!PoolList->Enemies.IsEmpty())
+		{
+			ACombatEnemy* Enemy = PoolList->Enemies.Pop(EAllowShrinking::No);
+			--NumParked;
+
+			// skip enemies destroyed while parked, e.g. by a streaming level unload
+			if (IsValid(Enemy))
+			{
+				++NumHits;
+				UpdateStats();
+
+				Enemy->ActivateFromPool(Transform);
+				return Enemy;
+			}
+		}
+	}
+
+	++NumMisses;
+	UpdateStats();
+
+	return nullptr;
+}
+
+void UCombatEnemyPool::ReleaseEnemy(ACombatEnemy* Enemy)
+{
+	if (!IsValid(Enemy) || Enemy->IsParked())
+	{
+		return;
+	}
+
+	Enemy->ParkInPool();
+
+	ParkedEnemies.FindOrAdd(Enemy->GetClass()).Enemies.Add(Enemy);
+
+	++NumParked;
+	PeakParked = FMath::Max(PeakParked, NumParked);
+
+	UpdateStats();
+}
+
+void UCombatEnemyPool::PrewarmEnemies(TSubclassOf<ACombatEnemy> EnemyClass, const FTransform& Transform, int32 Count)
+{
+	if (!IsPoolingEnabled() || !IsValid(EnemyClass) || Count <= 0)
+	{
+		return;
+	}
+
+	FPrewarmRequest& Request = PrewarmRequests.AddDefaulted_GetRef();
+	Request.EnemyClass = EnemyClass;
+	Request.Transform = Transform;
+	Request.Remaining = Count;
+}
+
+ACombatEnemy* UCombatEnemyPool::SpawnEnemy(TSubclassOf<ACombatEnemy> EnemyClass, const FTransform& Transform) const
+{
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	return GetWorld()->SpawnActor<ACombatEnemy>(EnemyClass, Transform, SpawnParams);
+}
+
+void UCombatEnemyPool::UpdateStats() const
+{
+	SET_DWORD_STAT(STAT_CombatEnemyPoolHits, NumHits);
+	SET_DWORD_STAT(STAT_CombatEnemyPoolMisses, NumMisses);
+	SET_DWORD_STAT(STAT_CombatEnemyPoolParked, NumParked);
+	SET_DWORD_STAT(STAT_CombatEnemyPoolPeakParked, PeakParked);
+}
+
+void UCombatEnemyPool::Deinitialize()
+{
+	// parked enemies are destroyed along with the world
+	ParkedEnemies.Empty();
+	PrewarmRequests.Empty();
+
+	NumParked = 0;
+	PeakParked = 0;
+	NumHits = 0;
+	NumMisses = 0;
+
+	UpdateStats();
+
+	Super::Deinitialize();
+}
+
+bool UCombatEnemyPool::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCombatEnemyPool::Tick(float DeltaTime)
+{
+	if (PrewarmRequests.IsEmpty())
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_CombatEnemyPoolPrewarm);
+
+	// spread the pre-warm spawns over several frames
+	int32 SpawnBudget = FMath::Max(GCombatEnemyPoolPrewarmPerFrame, 1);
+
+	while (SpawnBudget > 0 && !PrewarmRequests.IsEmpty())
+	{
+		FPrewarmRequest& Request = PrewarmRequests[0];
+
+		if (ACombatEnemy* Enemy = SpawnEnemy(Request.EnemyClass, Request.Transform))
+		{
+			ReleaseEnemy(Enemy);
+		}
+
+		--SpawnBudget;
+
+		if (--Request.Remaining <= 0)
+		{
+			PrewarmRequests.RemoveAt(0, EAllowShrinking::No);
+		}
+	}
+}
+
+TStatId UCombatEnemyPool::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatEnemyPool, STATGROUP_Tickables);
+}
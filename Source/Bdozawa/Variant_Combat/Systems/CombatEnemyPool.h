@@ -0,0 +1,101 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatEnemyPool.generated.h"
+
+class ACombatEnemy;
+
+/**
+ *  Parked enemies of a single class
+ */
+USTRUCT()
+struct FCombatEnemyPoolList
+{
+	GENERATED_BODY()
+
+	/** Enemies waiting to be reused */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<ACombatEnemy>> Enemies;
+};
+
+/**
+ *  Reuses enemy actors instead of spawning and destroying them.
+ *  Dead enemies are parked here instead of being destroyed, and handed back out to spawners
+ *  after resetting their combat state. Pools are keyed by enemy class and can be pre-warmed
+ *  over several frames so the spawns happen at level start instead of during combat.
+ */
+UCLASS()
+class UCombatEnemyPool : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** A request to spawn and park enemies ahead of time */
+	struct FPrewarmRequest
+	{
+		TSubclassOf<ACombatEnemy> EnemyClass;
+		FTransform Transform;
+		int32 Remaining = 0;
+	};
+
+	/** Parked enemies, keyed by class */
+	UPROPERTY(Transient)
+	TMap<TSubclassOf<ACombatEnemy>, FCombatEnemyPoolList> ParkedEnemies;
+
+	/** Pending pre-warm requests, processed a few spawns per frame */
+	TArray<FPrewarmRequest> PrewarmRequests;
+
+	/** Number of enemies currently parked across all classes */
+	int32 NumParked = 0;
+
+	/** Highest number of enemies parked at once */
+	int32 PeakParked = 0;
+
+	/** Acquires served by a parked enemy */
+	int32 NumHits = 0;
+
+	/** Acquires that had to spawn a new enemy */
+	int32 NumMisses = 0;
+
+public:
+
+	/** Returns true if dead enemies should be parked for reuse instead of destroyed */
+	static bool IsPoolingEnabled();
+
+	/** Returns a parked enemy of the given class moved to the transform, or spawns a new one if none are parked */
+	ACombatEnemy* AcquireEnemy(TSubclassOf<ACombatEnemy> EnemyClass, const FTransform& Transform);
+
+	/** Returns a parked enemy of the given class moved to the transform, or null if none are parked. Misses are counted, so the caller is expected to spawn the enemy */
+	ACombatEnemy* TryAcquireParkedEnemy(TSubclassOf<ACombatEnemy> EnemyClass, const FTransform& Transform);
+
+	/** Parks an enemy so it can be reused by a later acquire */
+	void ReleaseEnemy(ACombatEnemy* Enemy);
+
+	/** Queues enemies of the given class to be spawned and parked over the next frames */
+	void PrewarmEnemies(TSubclassOf<ACombatEnemy> EnemyClass, const FTransform& Transform, int32 Count);
+
+protected:
+
+	/** Spawns an enemy at the given transform */
+	ACombatEnemy* SpawnEnemy(TSubclassOf<ACombatEnemy> EnemyClass, const FTransform& Transform) const;
+
+	/** Publishes the pool counters to the combat stat group */
+	void UpdateStats() const;
+
+public:
+
+	// ~begin USubsystem interface
+	virtual void Deinitialize() override;
+	// ~end USubsystem interface
+
+	// ~begin UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	// ~end UWorldSubsystem interface
+
+	// ~begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	// ~end FTickableGameObject interface
+};
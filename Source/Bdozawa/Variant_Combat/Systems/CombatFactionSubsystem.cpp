@@ -0,0 +1,37 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatFactionSubsystem.h"
+#include "GameFramework/Actor.h"
+
+void UCombatFactionSubsystem::RegisterFaction(const AActor* Actor, ECombatFaction Faction)
+{
+	if (Actor)
+	{
+		Factions.Add(Actor, Faction);
+	}
+}
+
+void UCombatFactionSubsystem::UnregisterFaction(const AActor* Actor)
+{
+	Factions.Remove(Actor);
+}
+
+ECombatFaction UCombatFactionSubsystem::GetFaction(const AActor* Actor) const
+{
+	const ECombatFaction* Faction = Factions.Find(Actor);
+
+	return Faction ? *Faction : ECombatFaction::Neutral;
+}
+
+void UCombatFactionSubsystem::Deinitialize()
+{
+	Factions.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UCombatFactionSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
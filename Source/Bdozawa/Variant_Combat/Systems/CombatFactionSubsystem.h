@@ -0,0 +1,43 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "CombatFactionComponent.h"
+#include "CombatFactionSubsystem.generated.h"
+
+/**
+ *  Keeps track of the faction of every actor with a faction component,
+ *  so hit resolution can filter targets with a map lookup and a mask test instead of tag or component searches.
+ */
+UCLASS()
+class UCombatFactionSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Faction for each registered actor */
+	TMap<TObjectKey<AActor>, ECombatFaction> Factions;
+
+public:
+
+	/** Sets the actor's faction */
+	void RegisterFaction(const AActor* Actor, ECombatFaction Faction);
+
+	/** Removes the actor from the registry */
+	void UnregisterFaction(const AActor* Actor);
+
+	/** Returns the actor's faction. Unregistered actors are Neutral */
+	ECombatFaction GetFaction(const AActor* Actor) const;
+
+public:
+
+	// ~begin USubsystem interface
+	virtual void Deinitialize() override;
+	// ~end USubsystem interface
+
+	// ~begin UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	// ~end UWorldSubsystem interface
+};
@@ -0,0 +1,64 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatSimulationSubsystem.h"
+#include "HAL/IConsoleManager.h"
+#include "Bdozawa.h"
+
+void UCombatSimulationSubsystem::Deinitialize()
+{
+	Simulation.Reset();
+
+	Super::Deinitialize();
+}
+
+bool UCombatSimulationSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+////////////////////////////////////////////////////////////////////
+
+/** Measures headless combat simulation throughput with a varying number of combatants */
+static void RunCombatSimulationBenchmark(const TArray<FString>& Args)
+{
+	const int32 NumFrames = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 600;
+
+	// benchmark parameters, roughly matching the combat enemies' defaults
+	const int32 CombatantCounts[] = { 1000, 10000, 100000 };
+	const float DeltaTime = 1.0f / 60.0f;
+	const float MaxHP = 3.0f;
+	const int32 NumComboSections = 3;
+
+	const FCombatSimulationParams Params;
+
+	for (const int32 CombatantCount : CombatantCounts)
+	{
+		FCombatSimulation Simulation;
+		FRandomStream Stream(CombatantCount);
+		FCombatSimulationStats Stats;
+
+		for (int32 i = 0; i < CombatantCount; ++i)
+		{
+			Simulation.AddCombatant(MaxHP, NumComboSections, true);
+		}
+
+		const double StartTime = FPlatformTime::Seconds();
+
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			Simulation.Simulate(DeltaTime, Params, Stream, Stats);
+		}
+
+		const double ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+		const double Throughput = ElapsedMs > 0.0 ? (double(CombatantCount) * NumFrames) / ElapsedMs : 0.0;
+
+		UE_LOG(LogBdozawa, Log, TEXT("Combat simulation benchmark: %d combatants, %d frames in %.3f ms. %.0f combatants simulated per ms. %d attacks, %d hits, %d deaths."),
+			CombatantCount, NumFrames, ElapsedMs, Throughput, Stats.AttacksStarted, Stats.Hits, Stats.Deaths);
+	}
+}
+
+static FAutoConsoleCommandWithArgs CombatSimulationBenchmarkCommand(
+	TEXT("Combat.Simulation.Benchmark"),
+	TEXT("Runs the headless combat simulation at 1000, 10000 and 100000 combatants and reports combatants simulated per millisecond. Optional argument: number of frames."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&RunCombatSimulationBenchmark));
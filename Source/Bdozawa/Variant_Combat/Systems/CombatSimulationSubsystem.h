@@ -0,0 +1,36 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatSimulation.h"
+#include "CombatSimulationSubsystem.generated.h"
+
+/**
+ *  Owns the combat simulation core for the world.
+ *  Combat characters register a combatant on BeginPlay and route their HP and attack state through it.
+ */
+UCLASS()
+class UCombatSimulationSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Combat state for every registered combatant in the world */
+	FCombatSimulation Simulation;
+
+public:
+
+	/** Returns the world's combat simulation */
+	FCombatSimulation& GetSimulation() { return Simulation; }
+
+public:
+
+	// ~begin USubsystem interface
+	virtual void Deinitialize() override;
+	// ~end USubsystem interface
+
+	// ~begin UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	// ~end UWorldSubsystem interface
+};
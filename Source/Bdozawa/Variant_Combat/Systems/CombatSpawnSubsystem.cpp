@@ -0,0 +1,185 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatSpawnSubsystem.h"
+#include "CombatEnemy.h"
+#include "CombatEnemyPool.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "CombatStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Spawn Queue Process"), STAT_CombatSpawnProcess, STATGROUP_Combat);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Spawns Processed"), STAT_CombatSpawnsProcessed, STATGROUP_Combat);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Spawns Queued"), STAT_CombatSpawnsQueued, STATGROUP_Combat);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Spawn Queue Latency Max (ms)"), STAT_CombatSpawnLatencyMax, STATGROUP_Combat);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Spawn Queue Latency Avg (ms)"), STAT_CombatSpawnLatencyAvg, STATGROUP_Combat);
+
+static float GCombatSpawnBudgetMs = 2.0f;
+static FAutoConsoleVariableRef CVarCombatSpawnBudgetMs(
+	TEXT("Combat.Spawn.BudgetMs"),
+	GCombatSpawnBudgetMs,
+	TEXT("Time budget in milliseconds for processing queued enemy spawns each frame. At least one spawn is processed per frame."),
+	ECVF_Default);
+
+void UCombatSpawnSubsystem::SubmitSpawn(TSubclassOf<ACombatEnemy> EnemyClass, const FTransform& Transform, int32 Priority, ESpawnActorCollisionHandlingMethod CollisionHandling, FOnCombatEnemySpawned&& OnSpawned)
+{
+	FSpawnRequest& Request = Requests.AddDefaulted_GetRef();
+	Request.EnemyClass = EnemyClass;
+	Request.Transform = Transform;
+	Request.Priority = Priority;
+	Request.CollisionHandling = CollisionHandling;
+	Request.SubmitTime = FPlatformTime::Seconds();
+	Request.OnSpawned = MoveTemp(OnSpawned);
+
+	SET_DWORD_STAT(STAT_CombatSpawnsQueued, Requests.Num());
+}
+
+void UCombatSpawnSubsystem::ProcessRequests()
+{
+	SCOPE_CYCLE_COUNTER(STAT_CombatSpawnProcess);
+
+	const double StartTime = FPlatformTime::Seconds();
+	const double Budget = FMath::Max(GCombatSpawnBudgetMs, 0.0f) / 1000.0;
+
+	// sort by priority, then closest to the player first
+	const APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	const APawn* PlayerPawn = PlayerController ? PlayerController->GetPawn() : nullptr;
+
+	for (FSpawnRequest& Request : Requests)
+	{
+		Request.DistanceSquared = PlayerPawn ? FVector::DistSquared(Request.Transform.GetLocation(), PlayerPawn->GetActorLocation()) : 0.0;
+	}
+
+	Requests.StableSort([](const FSpawnRequest& A, const FSpawnRequest& B)
+	{
+		if (A.Priority != B.Priority)
+		{
+			return A.Priority > B.Priority;
+		}
+
+		return A.DistanceSquared < B.DistanceSquared;
+	});
+
+	UCombatEnemyPool* EnemyPool = UCombatEnemyPool::IsPoolingEnabled() ? GetWorld()->GetSubsystem<UCombatEnemyPool>() : nullptr;
+
+	DeferredSpawns.Reset();
+
+	int32 NumProcessed = 0;
+
+	for (; NumProcessed < Requests.Num(); ++NumProcessed)
+	{
+		// stop once the next spawn, plus finishing the ones we've started, is expected to go over budget.
+		// Always process at least one request so the queue can't stall
+		const double ExpectedCost = (FPlatformTime::Seconds() - StartTime) + (EstimatedSpawnCost * (DeferredSpawns.Num() + 1));
+
+		if (NumProcessed > 0 && ExpectedCost > Budget)
+		{
+			break;
+		}
+
+		// move the request out, in case a callback queues more spawns
+		FSpawnRequest Request = MoveTemp(Requests[NumProcessed]);
+
+		// skip requests whose spawner went away
+		if (!Request.OnSpawned.IsBound())
+		{
+			continue;
+		}
+
+		// report a failed spawn if the class went away, so the spawner gives back its budget slot
+		if (!IsValid(Request.EnemyClass))
+		{
+			Request.OnSpawned.Execute(nullptr);
+			continue;
+		}
+
+		RecordLatency(Request.SubmitTime, FPlatformTime::Seconds());
+
+		// reuse a parked enemy if we can. This is cheap, so it doesn't need deferring
+		if (EnemyPool)
+		{
+			if (ACombatEnemy* ParkedEnemy = EnemyPool->TryAcquireParkedEnemy(Request.EnemyClass, Request.Transform))
+			{
+				Request.OnSpawned.Execute(ParkedEnemy);
+				continue;
+			}
+		}
+
+		// start the spawn, but hold off construction and collision fix-ups until the batch is finished
+		ACombatEnemy* Enemy = GetWorld()->SpawnActorDeferred<ACombatEnemy>(Request.EnemyClass, Request.Transform, nullptr, nullptr, Request.CollisionHandling);
+
+		if (!Enemy)
+		{
+			Request.OnSpawned.Execute(nullptr);
+			continue;
+		}
+
+		FDeferredSpawn& DeferredSpawn = DeferredSpawns.AddDefaulted_GetRef();
+		DeferredSpawn.Enemy = Enemy;
+		DeferredSpawn.Transform = Request.Transform;
+		DeferredSpawn.OnSpawned = MoveTemp(Request.OnSpawned);
+	}
+
+	Requests.RemoveAt(0, NumProcessed, EAllowShrinking::No);
+
+	// finish the batch
+	for (FDeferredSpawn& DeferredSpawn : DeferredSpawns)
+	{
+		const double FinishStartTime = FPlatformTime::Seconds();
+
+		DeferredSpawn.Enemy->FinishSpawning(DeferredSpawn.Transform);
+
+		// track the cost of a spawn to budget the next frames
+		const double SpawnCost = FPlatformTime::Seconds() - FinishStartTime;
+		EstimatedSpawnCost = EstimatedSpawnCost > 0.0 ? FMath::Lerp(EstimatedSpawnCost, SpawnCost, 0.25) : SpawnCost;
+
+		DeferredSpawn.OnSpawned.ExecuteIfBound(DeferredSpawn.Enemy);
+	}
+
+	DeferredSpawns.Reset();
+
+	INC_DWORD_STAT_BY(STAT_CombatSpawnsProcessed, NumProcessed);
+	SET_DWORD_STAT(STAT_CombatSpawnsQueued, Requests.Num());
+	SET_FLOAT_STAT(STAT_CombatSpawnLatencyMax, Latency.MaxLatency * 1000.0);
+	SET_FLOAT_STAT(STAT_CombatSpawnLatencyAvg, Latency.AverageLatency * 1000.0);
+}
+
+void UCombatSpawnSubsystem::RecordLatency(double SubmitTime, double Now)
+{
+	const double RequestLatency = Now - SubmitTime;
+
+	++Latency.NumSpawns;
+	Latency.AverageLatency += (RequestLatency - Latency.AverageLatency) / Latency.NumSpawns;
+	Latency.MaxLatency = FMath::Max(Latency.MaxLatency, RequestLatency);
+}
+
+void UCombatSpawnSubsystem::Deinitialize()
+{
+	// drop any spawns that haven't been processed
+	Requests.Empty();
+	DeferredSpawns.Empty();
+
+	SET_DWORD_STAT(STAT_CombatSpawnsQueued, 0);
+
+	Super::Deinitialize();
+}
+
+bool UCombatSpawnSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCombatSpawnSubsystem::Tick(float DeltaTime)
+{
+	if (!Requests.IsEmpty())
+	{
+		ProcessRequests();
+	}
+}
+
+TStatId UCombatSpawnSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatSpawnSubsystem, STATGROUP_Tickables);
+}
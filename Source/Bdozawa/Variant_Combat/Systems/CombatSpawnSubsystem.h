@@ -0,0 +1,119 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineTypes.h"
+#include "CombatSpawnSubsystem.generated.h"
+
+class ACombatEnemy;
+
+/** Called when a queued enemy spawn has been processed. The enemy is null if the spawn failed */
+DECLARE_DELEGATE_OneParam(FOnCombatEnemySpawned, ACombatEnemy* /* SpawnedEnemy */);
+
+/**
+ *  Spawn queue latency counters
+ */
+struct FCombatSpawnLatency
+{
+	/** Number of spawns processed */
+	int32 NumSpawns = 0;
+
+	/** Average time spawns waited in the queue, in seconds */
+	double AverageLatency = 0.0;
+
+	/** Longest time a spawn waited in the queue, in seconds */
+	double MaxLatency = 0.0;
+};
+
+/**
+ *  Processes enemy spawn requests from all spawners under a per-frame time budget.
+ *  Requests are sorted by priority and then by distance to the player, so the closest enemies appear first.
+ *  Parked enemies are reused from the enemy pool. New enemies are spawned deferred and finished together
+ *  at the end of the frame's batch, so their construction and collision fix-ups don't all land in the same frame.
+ */
+UCLASS()
+class UCombatSpawnSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** A queued spawn */
+	struct FSpawnRequest
+	{
+		/** Class of enemy to spawn */
+		TSubclassOf<ACombatEnemy> EnemyClass;
+
+		/** Spawn transform */
+		FTransform Transform;
+
+		/** How to resolve collisions at the spawn transform */
+		ESpawnActorCollisionHandlingMethod CollisionHandling = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+		/** Requests with higher priority are spawned first */
+		int32 Priority = 0;
+
+		/** Squared distance to the player, updated before sorting */
+		double DistanceSquared = 0.0;
+
+		/** Time the request was submitted */
+		double SubmitTime = 0.0;
+
+		/** Called once the enemy has been spawned */
+		FOnCombatEnemySpawned OnSpawned;
+	};
+
+	/** A deferred spawn waiting for FinishSpawning */
+	struct FDeferredSpawn
+	{
+		ACombatEnemy* Enemy = nullptr;
+		FTransform Transform;
+		FOnCombatEnemySpawned OnSpawned;
+	};
+
+	/** Queued spawns */
+	TArray<FSpawnRequest> Requests;
+
+	/** Deferred spawns started this frame. Kept around to reuse the allocation */
+	TArray<FDeferredSpawn> DeferredSpawns;
+
+	/** Moving average of the time a single spawn takes, in seconds. Used to avoid starting spawns that won't fit the budget */
+	double EstimatedSpawnCost = 0.0;
+
+	/** Queue latency counters */
+	FCombatSpawnLatency Latency;
+
+public:
+
+	/** Queues an enemy spawn. The delegate is called once the enemy has been spawned */
+	void SubmitSpawn(TSubclassOf<ACombatEnemy> EnemyClass, const FTransform& Transform, int32 Priority, ESpawnActorCollisionHandlingMethod CollisionHandling, FOnCombatEnemySpawned&& OnSpawned);
+
+	/** Returns the number of spawns waiting in the queue */
+	int32 GetNumQueuedSpawns() const { return Requests.Num(); }
+
+	/** Returns the queue latency counters */
+	const FCombatSpawnLatency& GetLatency() const { return Latency; }
+
+protected:
+
+	/** Spawns queued enemies until the frame's budget runs out */
+	void ProcessRequests();
+
+	/** Records the queue latency of a processed request */
+	void RecordLatency(double SubmitTime, double Now);
+
+public:
+
+	// ~begin USubsystem interface
+	virtual void Deinitialize() override;
+	// ~end USubsystem interface
+
+	// ~begin UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	// ~end UWorldSubsystem interface
+
+	// ~begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	// ~end FTickableGameObject interface
+};
@@ -0,0 +1,272 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatTraceSubsystem.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "CombatAttacker.h"
+#include "CombatBroadphaseSubsystem.h"
+#include "CombatStats.h"
+#include "BdozawaAllocationScope.h"
+
+DECLARE_CYCLE_STAT(TEXT("Attack Trace Flush"), STAT_CombatTraceFlush, STATGROUP_Combat);
+DECLARE_CYCLE_STAT(TEXT("Attack Trace Resolve"), STAT_CombatTraceResolve, STATGROUP_Combat);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Attack Traces Issued"), STAT_CombatTracesIssued, STATGROUP_Combat);
+DECLARE_CYCLE_STAT(TEXT("Notify Queue Drain"), STAT_CombatNotifyDrain, STATGROUP_Combat);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Notifies Dispatched"), STAT_CombatNotifiesDispatched, STATGROUP_Combat);
+
+static int32 GCombatTraceBatched = 1;
+static FAutoConsoleVariableRef CVarCombatTraceBatched(
+	TEXT("Combat.Trace.Batched"),
+	GCombatTraceBatched,
+	TEXT("0: melee attack traces are swept synchronously as soon as the anim notify fires.\n")
+	TEXT("1: melee attack traces are collected during the frame, issued as one batch of async sweeps and resolved at the start of the next frame."),
+	ECVF_Default);
+
+static int32 GCombatNotifyQueued = 1;
+static FAutoConsoleVariableRef CVarCombatNotifyQueued(
+	TEXT("Combat.Notify.Queued"),
+	GCombatNotifyQueued,
+	TEXT("0: combat anim notifies call into their attacker as soon as they fire.\n")
+	TEXT("1: combat anim notifies only push a request into a lock-free queue, which the game thread drains once per frame before flushing attack traces."),
+	ECVF_Default);
+
+void UCombatTraceSubsystem::SubmitTrace(FCombatTraceRequest&& Request)
+{
+	// are we batching traces?
+	if (IsBatchingEnabled())
+	{
+		// queue the request so it's issued along with the rest of the frame's traces
+		QueuedRequests.Add(MoveTemp(Request));
+		return;
+	}
+
+	// resolve the trace right away
+	ExecuteTraceSync(Request);
+}
+
+bool UCombatTraceSubsystem::IsBatchingEnabled()
+{
+	return GCombatTraceBatched != 0;
+}
+
+bool UCombatTraceSubsystem::IsNotifyQueueEnabled()
+{
+	return GCombatNotifyQueued != 0;
+}
+
+bool UCombatTraceSubsystem::EnqueueNotify(USkeletalMeshComponent* MeshComp, ECombatNotifyType Type, FName BoneName)
+{
+	// editor previews and other world types don't have the subsystem
+	UWorld* World = MeshComp->GetWorld();
+	UCombatTraceSubsystem* TraceSubsystem = World ? World->GetSubsystem<UCombatTraceSubsystem>() : nullptr;
+
+	if (!TraceSubsystem)
+	{
+		return false;
+	}
+
+	// only copy plain data here, the attacker is resolved on the game thread
+	TraceSubsystem->NotifyQueue.Enqueue(FCombatNotifyRequest { MeshComp->GetOwner(), Type, BoneName });
+	return true;
+}
+
+void UCombatTraceSubsystem::DrainNotifyQueue()
+{
+	check(IsInGameThread());
+
+	SCOPE_CYCLE_COUNTER(STAT_CombatNotifyDrain);
+
+	FCombatNotifyRequest Request;
+
+	while (NotifyQueue.Dequeue(Request))
+	{
+		// skip notifies from attackers that were destroyed since they were queued
+		ICombatAttacker* AttackerInterface = Cast<ICombatAttacker>(Request.Attacker.Get());
+
+		// skip the notify if the attack timing is being driven by an attack timeline
+		if (!AttackerInterface || AttackerInterface->IsAttackTimelineActive())
+		{
+			continue;
+		}
+
+		INC_DWORD_STAT(STAT_CombatNotifiesDispatched);
+
+		switch (Request.Type)
+		{
+			case ECombatNotifyType::AttackTrace:
+				AttackerInterface->DoAttackTrace(Request.BoneName);
+				break;
+
+			case ECombatNotifyType::CheckCombo:
+				AttackerInterface->CheckCombo();
+				break;
+
+			case ECombatNotifyType::CheckChargedAttack:
+				AttackerInterface->CheckChargedAttack();
+				break;
+		}
+	}
+}
+
+void UCombatTraceSubsystem::ExecuteTraceSync(const FCombatTraceRequest& Request)
+{
+	// ignore requests from attackers that are no longer valid
+	AActor* Attacker = Request.Attacker.Get();
+
+	if (!IsValid(Attacker))
+	{
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_CombatTracesIssued);
+
+	// reuse the hit buffer
+	SyncHits.Reset();
+
+	// should we test against the combat broadphase?
+	if (Request.bUseBroadphase && UCombatBroadphaseSubsystem::IsBroadphaseEnabled())
+	{
+		GetWorld()->GetSubsystem<UCombatBroadphaseSubsystem>()->SweepSphere(Request.Start, Request.End, Request.Radius, Request.ObjectParams, Attacker, SyncHits);
+
+	} else {
+
+		// ignore the attacker
+		const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(CombatAttackTrace), false, Attacker);
+
+		GetWorld()->SweepMultiByObjectType(SyncHits, Request.Start, Request.End, FQuat::Identity, Request.ObjectParams, FCollisionShape::MakeSphere(Request.Radius), QueryParams);
+	}
+
+	// pass the results back to the attacker
+	Request.Resolve(SyncHits);
+}
+
+void UCombatTraceSubsystem::FlushQueuedRequests()
+{
+	SCOPE_CYCLE_COUNTER(STAT_CombatTraceFlush);
+	BDOZAWA_ZERO_ALLOC_SCOPE("Combat.Trace.Flush");
+
+	UWorld* World = GetWorld();
+
+	for (FCombatTraceRequest& CurrentRequest : QueuedRequests)
+	{
+		// skip requests from attackers that were destroyed this frame
+		AActor* Attacker = CurrentRequest.Attacker.Get();
+
+		if (!IsValid(Attacker))
+		{
+			continue;
+		}
+
+		// broadphase queries are cheap and don't touch the physics scene, so resolve them right away
+		if (CurrentRequest.bUseBroadphase && UCombatBroadphaseSubsystem::IsBroadphaseEnabled())
+		{
+			ExecuteTraceSync(CurrentRequest);
+			continue;
+		}
+
+		INC_DWORD_STAT(STAT_CombatTracesIssued);
+
+		// ignore the attacker
+		const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(CombatAttackTrace), false, Attacker);
+
+		// issue the async sweep. Results will be available on the next frame
+		FPendingTrace& PendingTrace = PendingTraces.AddDefaulted_GetRef();
+		PendingTrace.Handle = World->AsyncSweepByObjectType(EAsyncTraceType::Multi, CurrentRequest.Start, CurrentRequest.End, FQuat::Identity, CurrentRequest.ObjectParams, FCollisionShape::MakeSphere(CurrentRequest.Radius), QueryParams);
+		PendingTrace.Request = MoveTemp(CurrentRequest);
+	}
+
+	// keep the allocation around for the next frame
+	QueuedRequests.Reset();
+}
+
+void UCombatTraceSubsystem::ResolvePendingTraces(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds)
+{
+	// the delegate is global, so ignore other worlds
+	if (InWorld != GetWorld() || PendingTraces.IsEmpty())
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_CombatTraceResolve);
+	BDOZAWA_ZERO_ALLOC_SCOPE("Combat.Trace.Resolve");
+
+	FTraceDatum TraceData;
+
+	for (int32 i = 0; i < PendingTraces.Num(); ++i)
+	{
+		FPendingTrace& CurrentTrace = PendingTraces[i];
+
+		// have the results for this trace come in?
+		if (InWorld->QueryTraceData(CurrentTrace.Handle, TraceData))
+		{
+			// ignore results for attackers that were destroyed while the trace was in flight
+			if (CurrentTrace.Request.Attacker.IsValid())
+			{
+				CurrentTrace.Request.Resolve(TraceData.OutHits);
+			}
+		}
+		// is the trace still in flight?
+		else if (InWorld->IsTraceHandleValid(CurrentTrace.Handle, false))
+		{
+			continue;
+		}
+
+		// the trace is either resolved or expired, so remove it
+		PendingTraces.RemoveAtSwap(i, 1, EAllowShrinking::No);
+		--i;
+	}
+}
+
+void UCombatTraceSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// resolve last frame's traces at a fixed point, before any actors tick
+	PreActorTickHandle = FWorldDelegates::OnWorldPreActorTick.AddUObject(this, &UCombatTraceSubsystem::ResolvePendingTraces);
+}
+
+void UCombatTraceSubsystem::Deinitialize()
+{
+	// unsubscribe from the world delegate
+	FWorldDelegates::OnWorldPreActorTick.Remove(PreActorTickHandle);
+
+	// drop any notifies and traces still in flight
+	FCombatNotifyRequest DiscardedNotify;
+
+	while (NotifyQueue.Dequeue(DiscardedNotify))
+	{
+	}
+
+	QueuedRequests.Empty();
+	PendingTraces.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UCombatTraceSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCombatTraceSubsystem::Tick(float DeltaTime)
+{
+	// dispatch this frame's combat notifies first, since attack trace notifies will submit traces
+	if (!NotifyQueue.IsEmpty())
+	{
+		DrainNotifyQueue();
+	}
+
+	// tickable world subsystems tick after all actors and components,
+	// so every trace requested by this frame's anim notifies has been queued by now
+	if (!QueuedRequests.IsEmpty())
+	{
+		FlushQueuedRequests();
+	}
+}
+
+TStatId UCombatTraceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatTraceSubsystem, STATGROUP_Tickables);
+}
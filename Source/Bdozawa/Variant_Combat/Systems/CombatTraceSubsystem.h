@@ -0,0 +1,175 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineTypes.h"
+#include "Engine/HitResult.h"
+#include "WorldCollision.h"
+#include "Containers/MpscQueue.h"
+#include "CombatTraceSubsystem.generated.h"
+
+/**
+ *  Receives the results of melee attack traces.
+ *  Used instead of a delegate so submitting a trace doesn't need a heap allocated delegate instance.
+ */
+class ICombatTraceListener
+{
+public:
+
+	virtual ~ICombatTraceListener() = default;
+
+	/** Called with the list of objects hit once a trace has been resolved */
+	virtual void OnCombatTraceResolved(const TArray<FHitResult>& Hits, uint32 SwingId) = 0;
+};
+
+/**
+ *  A single melee attack sphere sweep, as requested by an attacker
+ */
+struct FCombatTraceRequest
+{
+	/** Actor that requested the trace. It will be ignored by the sweep */
+	TWeakObjectPtr<AActor> Attacker;
+
+	/** Sweep start location */
+	FVector Start = FVector::ZeroVector;
+
+	/** Sweep end location */
+	FVector End = FVector::ZeroVector;
+
+	/** Radius of the swept sphere */
+	float Radius = 0.0f;
+
+	/** Collision object types the sweep will look for */
+	FCollisionObjectQueryParams ObjectParams;
+
+	/** If true, the sweep will be tested against the combat broadphase instead of the physics scene */
+	bool bUseBroadphase = false;
+
+	/** Object that receives the sweep results. Results are dropped if it's destroyed while the trace is in flight */
+	TWeakObjectPtr<UObject> ListenerObject;
+
+	/** Listener interface implemented by the listener object */
+	ICombatTraceListener* Listener = nullptr;
+
+	/** Damage swing the trace belongs to, passed back to the listener */
+	uint32 SwingId = 0;
+
+	/** Passes the sweep results to the listener, if it's still alive */
+	void Resolve(const TArray<FHitResult>& Hits) const
+	{
+		if (Listener && ListenerObject.IsValid())
+		{
+			Listener->OnCombatTraceResolved(Hits, SwingId);
+		}
+	}
+};
+
+class USkeletalMeshComponent;
+
+/** Combat anim notifies that can be deferred to the notify queue */
+enum class ECombatNotifyType : uint8
+{
+	AttackTrace,
+	CheckCombo,
+	CheckChargedAttack
+};
+
+/**
+ *  A combat anim notify pushed into the notify queue, to be dispatched to its attacker on the game thread
+ */
+struct FCombatNotifyRequest
+{
+	/** Actor that owns the notifying mesh */
+	TWeakObjectPtr<AActor> Attacker;
+
+	/** Notify to dispatch */
+	ECombatNotifyType Type = ECombatNotifyType::AttackTrace;
+
+	/** Source bone for attack trace notifies */
+	FName BoneName;
+};
+
+/**
+ *  Schedules melee attack traces for all combat attackers in the world.
+ *  Depending on Combat.Trace.Batched, traces are either resolved synchronously as soon as they're requested,
+ *  or collected during the frame and issued as a single batch of async sweeps that are resolved at the start of the next frame.
+ */
+UCLASS()
+class UCombatTraceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** An async sweep that has been issued but not resolved yet */
+	struct FPendingTrace
+	{
+		/** Async trace handle returned by the world */
+		FTraceHandle Handle;
+
+		/** Request that originated the trace */
+		FCombatTraceRequest Request;
+	};
+
+	/** Requests received this frame that haven't been issued yet */
+	TArray<FCombatTraceRequest> QueuedRequests;
+
+	/** Async sweeps issued on a previous frame, waiting to be resolved */
+	TArray<FPendingTrace> PendingTraces;
+
+	/** Reusable hit buffer for synchronous sweeps */
+	TArray<FHitResult> SyncHits;
+
+	/** Lock-free queue of combat notifies. Any thread may push into it, only the game thread drains it */
+	TMpscQueue<FCombatNotifyRequest> NotifyQueue;
+
+	/** Handle to the world pre actor tick delegate */
+	FDelegateHandle PreActorTickHandle;
+
+public:
+
+	/** Submits a melee attack trace. It may be resolved immediately or on the next frame */
+	void SubmitTrace(FCombatTraceRequest&& Request);
+
+	/** Returns true if traces are currently being batched and resolved asynchronously */
+	static bool IsBatchingEnabled();
+
+	/** Returns true if combat anim notifies should be pushed into the notify queue instead of dispatched inline */
+	static bool IsNotifyQueueEnabled();
+
+	/**
+	 *  Pushes a combat notify for the mesh's owner into its world's notify queue. Safe to call from any thread.
+	 *  Returns false if the world has no trace subsystem, in which case the caller should dispatch the notify itself.
+	 */
+	static bool EnqueueNotify(USkeletalMeshComponent* MeshComp, ECombatNotifyType Type, FName BoneName = NAME_None);
+
+protected:
+
+	/** Runs a sweep immediately and resolves it. Used for synchronous traces and broadphase queries */
+	void ExecuteTraceSync(const FCombatTraceRequest& Request);
+
+	/** Dispatches all queued combat notifies to their attackers. Game thread only */
+	void DrainNotifyQueue();
+
+	/** Issues all queued requests as async sweeps */
+	void FlushQueuedRequests();
+
+	/** Resolves all async sweeps issued on the previous frame. Called at the start of the world tick */
+	void ResolvePendingTraces(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds);
+
+public:
+
+	// ~begin USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	// ~end USubsystem interface
+
+	// ~begin UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	// ~end UWorldSubsystem interface
+
+	// ~begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	// ~end FTickableGameObject interface
+};
@@ -0,0 +1,427 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatWaveDirector.h"
+#include "CombatEnemySpawner.h"
+#include "CombatCheckpointSubsystem.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "RenderCore.h"
+#include "CombatStats.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Waves Alive Enemies"), STAT_CombatWavesAliveEnemies, STATGROUP_Combat);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Waves Alive Enemy Budget"), STAT_CombatWavesBudget, STATGROUP_Combat);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Waves Waiting Spawners"), STAT_CombatWavesWaiting, STATGROUP_Combat);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Waves Current Wave"), STAT_CombatWavesCurrentWave, STATGROUP_Combat);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Waves Spawns Deferred"), STAT_CombatWavesDeferred, STATGROUP_Combat);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Waves Game Thread (ms)"), STAT_CombatWavesGameThreadMs, STATGROUP_Combat);
+
+static int32 GCombatWavesMaxAliveEnemies = 12;
+static FAutoConsoleVariableRef CVarCombatWavesMaxAliveEnemies(
+	TEXT("Combat.Waves.MaxAliveEnemies"),
+	GCombatWavesMaxAliveEnemies,
+	TEXT("Maximum number of enemies alive at once across all spawners."),
+	ECVF_Default);
+
+static int32 GCombatWavesMinAliveEnemies = 2;
+static FAutoConsoleVariableRef CVarCombatWavesMinAliveEnemies(
+	TEXT("Combat.Waves.MinAliveEnemies"),
+	GCombatWavesMinAliveEnemies,
+	TEXT("The adaptive budget never drops below this number of alive enemies."),
+	ECVF_Default);
+
+static float GCombatWavesTargetGameThreadMs = 0.0f;
+static FAutoConsoleVariableRef CVarCombatWavesTargetGameThreadMs(
+	TEXT("Combat.Waves.TargetGameThreadMs"),
+	GCombatWavesTargetGameThreadMs,
+	TEXT("If above zero, the alive enemy budget is lowered while the game thread time is over this target, and raised again while it's well under it."),
+	ECVF_Default);
+
+static float GCombatWavesAdaptInterval = 1.0f;
+static FAutoConsoleVariableRef CVarCombatWavesAdaptInterval(
+	TEXT("Combat.Waves.AdaptInterval"),
+	GCombatWavesAdaptInterval,
+	TEXT("Time in seconds between adaptive budget changes."),
+	ECVF_Default);
+
+static float GCombatWavesDelay = 3.0f;
+static FAutoConsoleVariableRef CVarCombatWavesDelay(
+	TEXT("Combat.Waves.Delay"),
+	GCombatWavesDelay,
+	TEXT("Time in seconds between a wave being depleted and the next wave starting."),
+	ECVF_Default);
+
+void UCombatWaveDirector::RegisterSpawner(ACombatEnemySpawner* Spawner, int32 Wave)
+{
+	if (!Spawner || FindSpawner(Spawner))
+	{
+		return;
+	}
+
+	FDirectedSpawner& DirectedSpawner = Spawners.AddDefaulted_GetRef();
+	DirectedSpawner.Spawner = Spawner;
+	DirectedSpawner.Wave = Wave;
+}
+
+void UCombatWaveDirector::UnregisterSpawner(ACombatEnemySpawner* Spawner)
+{
+	const int32 Index = Spawners.IndexOfByPredicate([Spawner](const FDirectedSpawner& DirectedSpawner) { return DirectedSpawner.Spawner.Get() == Spawner; });
+
+	if (Index == INDEX_NONE)
+	{
+		return;
+	}
+
+	// give back the spawner's slots
+	AliveEnemies -= Spawners[Index].AliveEnemies;
+	Spawners.RemoveAtSwap(Index, EAllowShrinking::No);
+
+	WaitingSpawners.RemoveAll([Spawner](const FWaitingSpawner& WaitingSpawner) { return WaitingSpawner.Spawner.Get() == Spawner; });
+
+	UpdateStats();
+}
+
+bool UCombatWaveDirector::RequestSpawnSlot(ACombatEnemySpawner* Spawner)
+{
+	FDirectedSpawner* DirectedSpawner = FindSpawner(Spawner);
+
+	// spawners we don't own aren't budgeted
+	if (!DirectedSpawner)
+	{
+		return true;
+	}
+
+	if (AliveEnemies < AliveEnemyBudget)
+	{
+		++AliveEnemies;
+		++DirectedSpawner->AliveEnemies;
+
+		UpdateStats();
+		return true;
+	}
+
+	// over budget, so wait for a slot to free up. A spawner only waits for one slot at a time,
+	// so a request left over from before a checkpoint restore is refreshed instead of added again
+	if (FWaitingSpawner* WaitingSpawner = WaitingSpawners.FindByPredicate([Spawner](const FWaitingSpawner& Candidate) { return Candidate.Spawner.Get() == Spawner; }))
+	{
+		WaitingSpawner->SpawnSerial = Spawner->GetSpawnSerial();
+
+	} else {
+
+		WaitingSpawners.Add(FWaitingSpawner { Spawner, Spawner->GetSpawnSerial() });
+	}
+
+	INC_DWORD_STAT(STAT_CombatWavesDeferred);
+
+	UpdateStats();
+	return false;
+}
+
+void UCombatWaveDirector::ReleaseSpawnSlot(ACombatEnemySpawner* Spawner)
+{
+	FDirectedSpawner* DirectedSpawner = FindSpawner(Spawner);
+
+	if (DirectedSpawner && DirectedSpawner->AliveEnemies > 0)
+	{
+		--AliveEnemies;
+		--DirectedSpawner->AliveEnemies;
+
+		UpdateStats();
+	}
+}
+
+void UCombatWaveDirector::NotifySpawnerDepleted(ACombatEnemySpawner* Spawner)
+{
+	if (FDirectedSpawner* DirectedSpawner = FindSpawner(Spawner))
+	{
+		DirectedSpawner->bDepleted = true;
+	}
+}
+
+UCombatWaveDirector::FDirectedSpawner* UCombatWaveDirector::FindSpawner(const ACombatEnemySpawner* Spawner)
+{
+	return Spawners.FindByPredicate([Spawner](const FDirectedSpawner& DirectedSpawner) { return DirectedSpawner.Spawner.Get() == Spawner; });
+}
+
+void UCombatWaveDirector::AdaptBudget(float DeltaTime)
+{
+	const int32 MaxBudget = FMath::Max(GCombatWavesMaxAliveEnemies, 1);
+	const int32 MinBudget = FMath::Clamp(GCombatWavesMinAliveEnemies, 1, MaxBudget);
+
+	// smooth the game thread time so single spikes don't change the budget
+	const float GameThreadMs = FPlatformTime::ToMilliseconds(GGameThreadTime);
+	SmoothedGameThreadMs = FMath::Lerp(SmoothedGameThreadMs, GameThreadMs, 0.1f);
+
+	// use the max budget if adapting is disabled
+	if (GCombatWavesTargetGameThreadMs <= 0.0f)
+	{
+		AliveEnemyBudget = MaxBudget;
+		return;
+	}
+
+	BudgetAdaptCountdown -= DeltaTime;
+
+	if (BudgetAdaptCountdown > 0.0f)
+	{
+		AliveEnemyBudget = FMath::Clamp(AliveEnemyBudget, MinBudget, MaxBudget);
+		return;
+	}
+
+	BudgetAdaptCountdown = GCombatWavesAdaptInterval;
+
+	// step the budget down while over target, and back up while comfortably under it
+	if (SmoothedGameThreadMs > GCombatWavesTargetGameThreadMs)
+	{
+		--AliveEnemyBudget;
+
+	} else if (SmoothedGameThreadMs < GCombatWavesTargetGameThreadMs * 0.85f) {
+
+		++AliveEnemyBudget;
+	}
+
+	AliveEnemyBudget = FMath::Clamp(AliveEnemyBudget, MinBudget, MaxBudget);
+}
+
+void UCombatWaveDirector::GrantWaitingSpawners()
+{
+	while (!WaitingSpawners.IsEmpty() && AliveEnemies < AliveEnemyBudget)
+	{
+		ACombatEnemySpawner* Spawner = WaitingSpawners[0].Spawner.Get();
+		const int32 RequestSerial = WaitingSpawners[0].SpawnSerial;
+		WaitingSpawners.RemoveAt(0, EAllowShrinking::No);
+
+		// skip spawners destroyed while waiting. A null spawner would match any stale registration
+		if (!Spawner)
+		{
+			continue;
+		}
+
+		// skip requests made before a checkpoint restore. The restored spawn timer spawns for the spawner instead
+		if (RequestSerial != Spawner->GetSpawnSerial())
+		{
+			continue;
+		}
+
+		FDirectedSpawner* DirectedSpawner = FindSpawner(Spawner);
+
+		if (!DirectedSpawner)
+		{
+			continue;
+		}
+
+		// reserve the slot and let the spawner use it
+		++AliveEnemies;
+		++DirectedSpawner->AliveEnemies;
+
+		Spawner->SpawnGrantedEnemy();
+	}
+}
+
+bool UCombatWaveDirector::IsWaveDepleted(int32 Wave) const
+{
+	for (const FDirectedSpawner& DirectedSpawner : Spawners)
+	{
+		if (DirectedSpawner.Wave == Wave && DirectedSpawner.Spawner.IsValid() && !DirectedSpawner.bDepleted)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void UCombatWaveDirector::UpdateWaves(float DeltaTime)
+{
+	if (bWavesFinished)
+	{
+		return;
+	}
+
+	// wait for the current wave to be depleted before counting down to the next one
+	if (NextWaveCountdown < 0.0f)
+	{
+		if (CurrentWave == INDEX_NONE)
+		{
+			// start the first wave right away, if any spawners are assigned to waves
+			if (Spawners.ContainsByPredicate([](const FDirectedSpawner& DirectedSpawner) { return DirectedSpawner.Wave != INDEX_NONE; }))
+			{
+				NextWaveCountdown = 0.0f;
+			}
+
+		} else if (IsWaveDepleted(CurrentWave)) {
+
+			NextWaveCountdown = GCombatWavesDelay;
+		}
+
+		return;
+	}
+
+	NextWaveCountdown -= DeltaTime;
+
+	if (NextWaveCountdown <= 0.0f)
+	{
+		NextWaveCountdown = -1.0f;
+		bWavesFinished = !StartNextWave();
+	}
+}
+
+bool UCombatWaveDirector::StartNextWave()
+{
+	// find the lowest wave after the current one
+	int32 NextWave = MAX_int32;
+
+	for (const FDirectedSpawner& DirectedSpawner : Spawners)
+	{
+		if (DirectedSpawner.Wave > CurrentWave && DirectedSpawner.Wave < NextWave && DirectedSpawner.Spawner.IsValid())
+		{
+			NextWave = DirectedSpawner.Wave;
+		}
+	}
+
+	if (NextWave == MAX_int32)
+	{
+		return false;
+	}
+
+	CurrentWave = NextWave;
+
+	// copy the spawners out, since starting them may register or request slots
+	TArray<ACombatEnemySpawner*, TInlineAllocator<16>> WaveSpawners;
+
+	for (const FDirectedSpawner& DirectedSpawner : Spawners)
+	{
+		if (DirectedSpawner.Wave == CurrentWave)
+		{
+			if (ACombatEnemySpawner* Spawner = DirectedSpawner.Spawner.Get())
+			{
+				WaveSpawners.Add(Spawner);
+			}
+		}
+	}
+
+	for (ACombatEnemySpawner* Spawner : WaveSpawners)
+	{
+		Spawner->StartWave();
+	}
+
+	return true;
+}
+
+void UCombatWaveDirector::UpdateStats() const
+{
+	SET_DWORD_STAT(STAT_CombatWavesAliveEnemies, AliveEnemies);
+	SET_DWORD_STAT(STAT_CombatWavesBudget, AliveEnemyBudget);
+	SET_DWORD_STAT(STAT_CombatWavesWaiting, WaitingSpawners.Num());
+	SET_DWORD_STAT(STAT_CombatWavesCurrentWave, FMath::Max(CurrentWave, 0));
+	SET_FLOAT_STAT(STAT_CombatWavesGameThreadMs, SmoothedGameThreadMs);
+}
+
+void UCombatWaveDirector::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// save our wave progress in checkpoint snapshots, so restoring one can't leave a wave that never starts or ends
+	if (UCombatCheckpointSubsystem* Checkpoints = Collection.InitializeDependency<UCombatCheckpointSubsystem>())
+	{
+		Checkpoints->RegisterCheckpointable(this);
+	}
+
+	// start at the full budget
+	AliveEnemyBudget = FMath::Max(GCombatWavesMaxAliveEnemies, 1);
+}
+
+void UCombatWaveDirector::Deinitialize()
+{
+	// leave the checkpoint snapshots
+	if (UCombatCheckpointSubsystem* Checkpoints = GetWorld()->GetSubsystem<UCombatCheckpointSubsystem>())
+	{
+		Checkpoints->UnregisterCheckpointable(this);
+	}
+
+	Spawners.Empty();
+	WaitingSpawners.Empty();
+	AliveEnemies = 0;
+
+	UpdateStats();
+
+	Super::Deinitialize();
+}
+
+bool UCombatWaveDirector::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCombatWaveDirector::SerializeCheckpoint(FArchive& Ar)
+{
+	Ar << CurrentWave;
+	Ar << NextWaveCountdown;
+	Ar << bWavesFinished;
+
+	if (Ar.IsSaving())
+	{
+		// save the depleted flags keyed by spawner path name, same as the checkpoint records
+		int32 NumSpawners = 0;
+
+		for (const FDirectedSpawner& DirectedSpawner : Spawners)
+		{
+			NumSpawners += DirectedSpawner.Spawner.IsValid() ? 1 : 0;
+		}
+
+		Ar << NumSpawners;
+
+		for (const FDirectedSpawner& DirectedSpawner : Spawners)
+		{
+			if (ACombatEnemySpawner* Spawner = DirectedSpawner.Spawner.Get())
+			{
+				FString SpawnerName = Spawner->GetPathName();
+				bool bDepleted = DirectedSpawner.bDepleted;
+
+				Ar << SpawnerName;
+				Ar << bDepleted;
+			}
+		}
+
+		return;
+	}
+
+	// spawners registered since the snapshot hadn't been depleted when it was captured
+	for (FDirectedSpawner& DirectedSpawner : Spawners)
+	{
+		DirectedSpawner.bDepleted = false;
+	}
+
+	int32 NumSpawners = 0;
+	Ar << NumSpawners;
+
+	for (int32 i = 0; i < NumSpawners; ++i)
+	{
+		FString SpawnerName;
+		bool bDepleted = false;
+
+		Ar << SpawnerName;
+		Ar << bDepleted;
+
+		FDirectedSpawner* DirectedSpawner = Spawners.FindByPredicate([SpawnerName](const FDirectedSpawner& Candidate) { return Candidate.Spawner.IsValid() && Candidate.Spawner->GetPathName() == SpawnerName; });
+
+		if (DirectedSpawner)
+		{
+			DirectedSpawner->bDepleted = bDepleted;
+		}
+	}
+
+	UpdateStats();
+}
+
+void UCombatWaveDirector::Tick(float DeltaTime)
+{
+	AdaptBudget(DeltaTime);
+	GrantWaitingSpawners();
+	UpdateWaves(DeltaTime);
+	UpdateStats();
+}
+
+TStatId UCombatWaveDirector::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatWaveDirector, STATGROUP_Tickables);
+}
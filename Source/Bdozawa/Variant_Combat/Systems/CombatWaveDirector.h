@@ -0,0 +1,145 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatCheckpointable.h"
+#include "CombatWaveDirector.generated.h"
+
+class ACombatEnemySpawner;
+
+/**
+ *  Owns all enemy spawners in the world and decides when they may spawn.
+ *  Enforces a global budget of concurrently alive enemies. Spawners over budget wait in a queue
+ *  until an enemy dies. The budget can adapt to the measured game thread time, so busy arenas
+ *  shed enemies on low-end hardware. Spawners assigned to a wave are started by the director
+ *  once every spawner of the previous wave has been depleted. Wave progress is saved in checkpoint snapshots.
+ */
+UCLASS()
+class UCombatWaveDirector : public UTickableWorldSubsystem, public ICombatCheckpointable
+{
+	GENERATED_BODY()
+
+	/** A spawner owned by the director */
+	struct FDirectedSpawner
+	{
+		/** Registered spawner */
+		TWeakObjectPtr<ACombatEnemySpawner> Spawner;
+
+		/** Wave the spawner belongs to. INDEX_NONE for spawners activated outside of waves */
+		int32 Wave = INDEX_NONE;
+
+		/** Alive enemies spawned with a slot from the budget */
+		int32 AliveEnemies = 0;
+
+		/** True once the spawner has no more enemies to spawn */
+		bool bDepleted = false;
+	};
+
+	/** A spawner waiting for a slot */
+	struct FWaitingSpawner
+	{
+		/** Spawner that requested the slot */
+		TWeakObjectPtr<ACombatEnemySpawner> Spawner;
+
+		/** Spawner's spawn serial when it requested the slot. Requests made before a checkpoint restore are dropped */
+		int32 SpawnSerial = 0;
+	};
+
+	/** Registered spawners */
+	TArray<FDirectedSpawner> Spawners;
+
+	/** Spawners waiting for a slot, in request order */
+	TArray<FWaitingSpawner> WaitingSpawners;
+
+	/** Enemies alive across all spawners */
+	int32 AliveEnemies = 0;
+
+	/** Current alive enemy budget */
+	int32 AliveEnemyBudget = 0;
+
+	/** Wave currently running. INDEX_NONE before the first wave starts */
+	int32 CurrentWave = INDEX_NONE;
+
+	/** Time left before the next wave starts. Negative while no wave is pending */
+	float NextWaveCountdown = -1.0f;
+
+	/** True once the last wave has been started */
+	bool bWavesFinished = false;
+
+	/** Smoothed game thread time, in milliseconds */
+	float SmoothedGameThreadMs = 0.0f;
+
+	/** Time left before the budget is adapted again */
+	float BudgetAdaptCountdown = 0.0f;
+
+public:
+
+	/** Adds a spawner to the director. Spawners with a wave index are started by the director */
+	void RegisterSpawner(ACombatEnemySpawner* Spawner, int32 Wave);
+
+	/** Removes a spawner from the director and gives back its slots */
+	void UnregisterSpawner(ACombatEnemySpawner* Spawner);
+
+	/** Reserves a slot in the alive enemy budget. If over budget, the spawner is queued and spawns once a slot frees up */
+	bool RequestSpawnSlot(ACombatEnemySpawner* Spawner);
+
+	/** Gives back a slot, e.g. when the spawner's enemy dies or fails to spawn */
+	void ReleaseSpawnSlot(ACombatEnemySpawner* Spawner);
+
+	/** Marks the spawner as depleted, which may complete its wave */
+	void NotifySpawnerDepleted(ACombatEnemySpawner* Spawner);
+
+	/** Returns the number of enemies alive across all spawners */
+	int32 GetAliveEnemies() const { return AliveEnemies; }
+
+	/** Returns the current alive enemy budget */
+	int32 GetAliveEnemyBudget() const { return AliveEnemyBudget; }
+
+	/** Returns the wave currently running */
+	int32 GetCurrentWave() const { return CurrentWave; }
+
+protected:
+
+	/** Returns the registration for a spawner, or null if it's not registered */
+	FDirectedSpawner* FindSpawner(const ACombatEnemySpawner* Spawner);
+
+	/** Lowers or raises the budget to keep the game thread time near the target */
+	void AdaptBudget(float DeltaTime);
+
+	/** Returns true if every spawner of the wave has been depleted */
+	bool IsWaveDepleted(int32 Wave) const;
+
+	/** Hands freed slots to waiting spawners */
+	void GrantWaitingSpawners();
+
+	/** Starts the next wave once the current one is depleted */
+	void UpdateWaves(float DeltaTime);
+
+	/** Starts all spawners of the lowest wave after the current one. Returns false if there are no more waves */
+	bool StartNextWave();
+
+	/** Publishes the director's decisions to the combat stat group */
+	void UpdateStats() const;
+
+public:
+
+	// ~begin USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	// ~end USubsystem interface
+
+	// ~begin UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	// ~end UWorldSubsystem interface
+
+	// ~begin ICombatCheckpointable interface
+	virtual void SerializeCheckpoint(FArchive& Ar) override;
+	// ~end ICombatCheckpointable interface
+
+	// ~begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	// ~end FTickableGameObject interface
+};
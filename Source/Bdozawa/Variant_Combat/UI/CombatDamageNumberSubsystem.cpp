@@ -0,0 +1,233 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatDamageNumberSubsystem.h"
+#include "SCombatDamageNumberOverlay.h"
+#include "Engine/World.h"
+#include "Engine/LocalPlayer.h"
+#include "Engine/GameViewportClient.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "SceneView.h"
+#include "CombatStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Damage Numbers Update"), STAT_CombatDamageNumbersUpdate, STATGROUP_Combat);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage Numbers Drawn"), STAT_CombatDamageNumbersDrawn, STATGROUP_Combat);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage Numbers Replaced"), STAT_CombatDamageNumbersReplaced, STATGROUP_Combat);
+
+static int32 GCombatDamageNumbersEnabled = 1;
+static FAutoConsoleVariableRef CVarCombatDamageNumbersEnabled(
+	TEXT("Combat.DamageNumbers.Enabled"),
+	GCombatDamageNumbersEnabled,
+	TEXT("If non-zero, floating damage numbers are shown when damage is applied."),
+	ECVF_Default);
+
+static int32 GCombatDamageNumbersMax = 32;
+static FAutoConsoleVariableRef CVarCombatDamageNumbersMax(
+	TEXT("Combat.DamageNumbers.Max"),
+	GCombatDamageNumbersMax,
+	TEXT("Maximum number of damage numbers on screen at once. The oldest number is replaced when over budget. Read when the world starts."),
+	ECVF_Default);
+
+static float GCombatDamageNumbersLifetime = 1.0f;
+static FAutoConsoleVariableRef CVarCombatDamageNumbersLifetime(
+	TEXT("Combat.DamageNumbers.Lifetime"),
+	GCombatDamageNumbersLifetime,
+	TEXT("Time in seconds a damage number stays on screen."),
+	ECVF_Default);
+
+namespace CombatDamageNumbers
+{
+	/** Speed the numbers float upwards at, in cm/s */
+	static const float RiseSpeed = 100.0f;
+
+	/** Time the pop-in animation lasts */
+	static const float PopTime = 0.15f;
+
+	/** Text scale at the start of the pop-in animation */
+	static const float PopScale = 1.6f;
+
+	/** Fraction of the lifetime spent fading out */
+	static const float FadeFraction = 0.3f;
+
+	/** Max characters in a damage number's text */
+	static const int32 MaxTextLength = 16;
+}
+
+bool UCombatDamageNumberSubsystem::IsEnabled()
+{
+	return GCombatDamageNumbersEnabled != 0;
+}
+
+void UCombatDamageNumberSubsystem::AddDamageNumber(const FVector& Location, float Damage, const FLinearColor& Color)
+{
+	if (Entries.IsEmpty())
+	{
+		return;
+	}
+
+	FDamageNumberEntry& Entry = Entries[NextEntry];
+	NextEntry = (NextEntry + 1) % Entries.Num();
+
+	// we're over budget, so the oldest number is replaced
+	if (Entry.bActive)
+	{
+		INC_DWORD_STAT(STAT_CombatDamageNumbersReplaced);
+	}
+
+	Entry.WorldLocation = Location;
+	Entry.Color = Color;
+	Entry.Age = 0.0f;
+	Entry.bActive = true;
+
+	// reuse the reserved text buffer
+	Entry.Text.Reset();
+	Entry.Text.AppendInt(FMath::Max(FMath::RoundToInt32(Damage), 1));
+}
+
+void UCombatDamageNumberSubsystem::UpdateDrawItems(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_CombatDamageNumbersUpdate);
+
+	using namespace CombatDamageNumbers;
+
+	DrawItems.Reset();
+
+	// age all numbers, even if there's no view to draw them in
+	const float Lifetime = FMath::Max(GCombatDamageNumbersLifetime, UE_KINDA_SMALL_NUMBER);
+	bool bAnyActive = false;
+
+	for (FDamageNumberEntry& Entry : Entries)
+	{
+		if (Entry.bActive)
+		{
+			Entry.Age += DeltaTime;
+			Entry.bActive = Entry.Age < Lifetime;
+			bAnyActive |= Entry.bActive;
+		}
+	}
+
+	if (!bAnyActive)
+	{
+		return;
+	}
+
+	// damage numbers are drawn for the first local player's view
+	APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	ULocalPlayer* LocalPlayer = PlayerController ? PlayerController->GetLocalPlayer() : nullptr;
+
+	if (!LocalPlayer || !LocalPlayer->ViewportClient)
+	{
+		return;
+	}
+
+	FSceneViewProjectionData ProjectionData;
+
+	if (!LocalPlayer->GetProjectionData(LocalPlayer->ViewportClient->Viewport, ProjectionData))
+	{
+		return;
+	}
+
+	// compute the view projection once for all numbers
+	const FMatrix ViewProjection = ProjectionData.ComputeViewProjectionMatrix();
+	const FIntRect ViewRect = ProjectionData.GetConstrainedViewRect();
+
+	for (int32 EntryIndex = 0; EntryIndex < Entries.Num(); ++EntryIndex)
+	{
+		const FDamageNumberEntry& Entry = Entries[EntryIndex];
+
+		if (!Entry.bActive)
+		{
+			continue;
+		}
+
+		// float upwards
+		const FVector Location = Entry.WorldLocation + FVector(0.0f, 0.0f, RiseSpeed * Entry.Age);
+
+		// cull numbers behind the camera
+		FVector2D ScreenPosition;
+
+		if (!FSceneView::ProjectWorldToScreen(Location, ViewRect, ViewProjection, ScreenPosition))
+		{
+			continue;
+		}
+
+		// pop in, then fade out at the end of the lifetime
+		const float PopAlpha = FMath::Clamp(Entry.Age / PopTime, 0.0f, 1.0f);
+		const float FadeStart = Lifetime * (1.0f - FadeFraction);
+		const float Opacity = 1.0f - FMath::Clamp((Entry.Age - FadeStart) / (Lifetime - FadeStart), 0.0f, 1.0f);
+
+		FCombatDamageNumberDrawItem& DrawItem = DrawItems.AddDefaulted_GetRef();
+		DrawItem.ScreenPosition = FVector2f(ScreenPosition);
+		DrawItem.Scale = FMath::Lerp(PopScale, 1.0f, FMath::Square(PopAlpha));
+		DrawItem.Color = Entry.Color.CopyWithNewOpacity(Entry.Color.A * Opacity);
+		DrawItem.EntryIndex = EntryIndex;
+	}
+
+	SET_DWORD_STAT(STAT_CombatDamageNumbersDrawn, DrawItems.Num());
+}
+
+void UCombatDamageNumberSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// allocate the ring and its text buffers once
+	const int32 MaxNumbers = FMath::Max(GCombatDamageNumbersMax, 1);
+
+	Entries.SetNum(MaxNumbers);
+	DrawItems.Reserve(MaxNumbers);
+
+	for (FDamageNumberEntry& Entry : Entries)
+	{
+		Entry.Text.Reserve(CombatDamageNumbers::MaxTextLength);
+	}
+}
+
+void UCombatDamageNumberSubsystem::Deinitialize()
+{
+	// remove the overlay from the viewport
+	if (Overlay.IsValid())
+	{
+		if (UGameViewportClient* GameViewport = GetWorld()->GetGameViewport())
+		{
+			GameViewport->RemoveViewportWidgetContent(Overlay.ToSharedRef());
+		}
+
+		Overlay.Reset();
+	}
+
+	Entries.Empty();
+	DrawItems.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UCombatDamageNumberSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCombatDamageNumberSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// add the overlay to the game viewport. Dedicated servers don't have one
+	if (UGameViewportClient* GameViewport = InWorld.GetGameViewport())
+	{
+		SAssignNew(Overlay, SCombatDamageNumberOverlay, this);
+		GameViewport->AddViewportWidgetContent(Overlay.ToSharedRef());
+	}
+}
+
+void UCombatDamageNumberSubsystem::Tick(float DeltaTime)
+{
+	if (Overlay.IsValid())
+	{
+		UpdateDrawItems(DeltaTime);
+	}
+}
+
+TStatId UCombatDamageNumberSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatDamageNumberSubsystem, STATGROUP_Tickables);
+}
@@ -0,0 +1,105 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatDamageNumberSubsystem.generated.h"
+
+class SCombatDamageNumberOverlay;
+
+/**
+ *  A damage number that passed culling this frame, projected and animated
+ */
+struct FCombatDamageNumberDrawItem
+{
+	/** Center of the number in viewport pixels */
+	FVector2f ScreenPosition = FVector2f::ZeroVector;
+
+	/** Text scale for the pop-in animation */
+	float Scale = 1.0f;
+
+	/** Text color, with the fade out applied to the alpha */
+	FLinearColor Color = FLinearColor::White;
+
+	/** Index of the ring entry holding the text */
+	int32 EntryIndex = INDEX_NONE;
+};
+
+/**
+ *  Floating damage numbers fed by the combat damage flush.
+ *  Numbers live in a fixed-size ring that is allocated once, so adding a number never allocates.
+ *  When the ring is full, the oldest number is replaced. Numbers are animated here and painted by a single viewport overlay.
+ */
+UCLASS()
+class UCombatDamageNumberSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** A damage number in the ring */
+	struct FDamageNumberEntry
+	{
+		/** World location the number was spawned at */
+		FVector WorldLocation = FVector::ZeroVector;
+
+		/** Text color */
+		FLinearColor Color = FLinearColor::White;
+
+		/** Time since the number was spawned */
+		float Age = 0.0f;
+
+		/** True while the number is on screen */
+		bool bActive = false;
+
+		/** Damage text. Reserved up front so formatting it doesn't allocate */
+		FString Text;
+	};
+
+	/** Fixed-size ring of damage numbers */
+	TArray<FDamageNumberEntry> Entries;
+
+	/** Ring index the next number will be written to */
+	int32 NextEntry = 0;
+
+	/** Numbers to draw this frame */
+	TArray<FCombatDamageNumberDrawItem> DrawItems;
+
+	/** Overlay widget added to the game viewport */
+	TSharedPtr<SCombatDamageNumberOverlay> Overlay;
+
+public:
+
+	/** Returns true if damage numbers should be shown */
+	static bool IsEnabled();
+
+	/** Adds a damage number at the given location. Replaces the oldest number if the budget is full */
+	void AddDamageNumber(const FVector& Location, float Damage, const FLinearColor& Color);
+
+	/** Returns the text of a ring entry */
+	const FString& GetEntryText(int32 EntryIndex) const { return Entries[EntryIndex].Text; }
+
+	/** Returns the numbers to draw this frame */
+	const TArray<FCombatDamageNumberDrawItem>& GetDrawItems() const { return DrawItems; }
+
+protected:
+
+	/** Ages, animates, projects and culls all active numbers for the first local player's view */
+	void UpdateDrawItems(float DeltaTime);
+
+public:
+
+	// ~begin USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	// ~end USubsystem interface
+
+	// ~begin UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	// ~end UWorldSubsystem interface
+
+	// ~begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	// ~end FTickableGameObject interface
+};
@@ -0,0 +1,200 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatLifeBarPool.h"
+#include "CombatLifeBar.h"
+#include "Components/WidgetComponent.h"
+#include "Blueprint/WidgetTree.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "CombatStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Life Bar Acquire"), STAT_CombatLifeBarAcquire, STATGROUP_Combat);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Life Bar Widgets Active"), STAT_CombatLifeBarWidgetsActive, STATGROUP_Combat);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Life Bar Widgets Pooled"), STAT_CombatLifeBarWidgetsPooled, STATGROUP_Combat);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Life Bar Widgets Created"), STAT_CombatLifeBarWidgetsCreated, STATGROUP_Combat);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Life Bars Pending"), STAT_CombatLifeBarsPending, STATGROUP_Combat);
+DECLARE_MEMORY_STAT(TEXT("Life Bar Widget Memory"), STAT_CombatLifeBarWidgetMemory, STATGROUP_Combat);
+
+static int32 GCombatLifeBarsPooled = 1;
+static FAutoConsoleVariableRef CVarCombatLifeBarsPooled(
+	TEXT("Combat.LifeBars.Pooled"),
+	GCombatLifeBarsPooled,
+	TEXT("0: enemies create their life bar widget when they begin play.\n")
+	TEXT("1: enemies get a pooled life bar widget on their first rendered frame or first damage. Only used when life bars aren't batched."),
+	ECVF_Default);
+
+static float GCombatLifeBarsOnScreenTime = 0.1f;
+static FAutoConsoleVariableRef CVarCombatLifeBarsOnScreenTime(
+	TEXT("Combat.LifeBars.OnScreenTime"),
+	GCombatLifeBarsOnScreenTime,
+	TEXT("A pending life bar gets its widget once its owner has been rendered within this many seconds."),
+	ECVF_Default);
+
+bool UCombatLifeBarPool::IsPoolingEnabled()
+{
+	return GCombatLifeBarsPooled != 0;
+}
+
+void UCombatLifeBarPool::AddPendingLifeBar(UWidgetComponent* Component, TSubclassOf<UCombatLifeBar> WidgetClass)
+{
+	if (!Component || !WidgetClass)
+	{
+		return;
+	}
+
+	FPendingLifeBar& PendingLifeBar = PendingLifeBars.AddDefaulted_GetRef();
+	PendingLifeBar.Component = Component;
+	PendingLifeBar.WidgetClass = WidgetClass;
+
+	UpdateStats();
+}
+
+UCombatLifeBar* UCombatLifeBarPool::AcquireLifeBar(UWidgetComponent* Component, TSubclassOf<UCombatLifeBar> WidgetClass)
+{
+	SCOPE_CYCLE_COUNTER(STAT_CombatLifeBarAcquire);
+
+	if (!Component || !WidgetClass)
+	{
+		return nullptr;
+	}
+
+	// the component may have received its widget on its first rendered frame
+	if (UCombatLifeBar* CurrentWidget = Cast<UCombatLifeBar>(Component->GetWidget()))
+	{
+		return CurrentWidget;
+	}
+
+	// the component no longer needs to wait for a widget
+	PendingLifeBars.RemoveAllSwap([Component](const FPendingLifeBar& PendingLifeBar) { return PendingLifeBar.Component == Component; });
+
+	// reuse a free widget of the same class if we have one
+	UCombatLifeBar* LifeBarWidget = nullptr;
+	const int32 FreeIndex = FreeLifeBars.IndexOfByPredicate([&WidgetClass](const UCombatLifeBar* FreeLifeBar) { return FreeLifeBar && FreeLifeBar->GetClass() == WidgetClass; });
+
+	if (FreeIndex != INDEX_NONE)
+	{
+		LifeBarWidget = FreeLifeBars[FreeIndex];
+		FreeLifeBars.RemoveAtSwap(FreeIndex, EAllowShrinking::No);
+
+	} else {
+
+		LifeBarWidget = CreateWidget<UCombatLifeBar>(GetWorld(), WidgetClass);
+
+		if (!LifeBarWidget)
+		{
+			return nullptr;
+		}
+
+		++NumCreatedLifeBars;
+		ResidentMemory += GetWidgetMemory(LifeBarWidget);
+	}
+
+	// pooled widgets may carry the fill of their previous owner
+	LifeBarWidget->SetLifePercentage(1.0f);
+
+	Component->SetWidget(LifeBarWidget);
+	++NumActiveLifeBars;
+
+	UpdateStats();
+
+	return LifeBarWidget;
+}
+
+void UCombatLifeBarPool::ReleaseLifeBar(UWidgetComponent* Component)
+{
+	if (!Component)
+	{
+		return;
+	}
+
+	// stop waiting for the owner to be rendered
+	PendingLifeBars.RemoveAllSwap([Component](const FPendingLifeBar& PendingLifeBar) { return PendingLifeBar.Component == Component; });
+
+	// take the widget back from the component
+	if (UCombatLifeBar* LifeBarWidget = Cast<UCombatLifeBar>(Component->GetWidget()))
+	{
+		Component->SetWidget(nullptr);
+
+		FreeLifeBars.Add(LifeBarWidget);
+		--NumActiveLifeBars;
+	}
+
+	UpdateStats();
+}
+
+SIZE_T UCombatLifeBarPool::GetWidgetMemory(const UCombatLifeBar* Widget)
+{
+	// count the UObject footprint of the user widget and every widget in its tree.
+	// Slate widgets and render targets aren't included, so this is a lower bound
+	SIZE_T Memory = Widget->GetClass()->GetStructureSize();
+
+	if (Widget->WidgetTree)
+	{
+		Memory += Widget->WidgetTree->GetClass()->GetStructureSize();
+
+		Widget->WidgetTree->ForEachWidget([&Memory](UWidget* TreeWidget)
+		{
+			Memory += TreeWidget->GetClass()->GetStructureSize();
+		});
+	}
+
+	return Memory;
+}
+
+void UCombatLifeBarPool::UpdateStats() const
+{
+	SET_DWORD_STAT(STAT_CombatLifeBarWidgetsActive, NumActiveLifeBars);
+	SET_DWORD_STAT(STAT_CombatLifeBarWidgetsPooled, FreeLifeBars.Num());
+	SET_DWORD_STAT(STAT_CombatLifeBarWidgetsCreated, NumCreatedLifeBars);
+	SET_DWORD_STAT(STAT_CombatLifeBarsPending, PendingLifeBars.Num());
+	SET_MEMORY_STAT(STAT_CombatLifeBarWidgetMemory, ResidentMemory);
+}
+
+void UCombatLifeBarPool::Deinitialize()
+{
+	// drop the pool. Widgets still assigned to components go away with their actors
+	FreeLifeBars.Empty();
+	PendingLifeBars.Empty();
+
+	NumActiveLifeBars = 0;
+	NumCreatedLifeBars = 0;
+	ResidentMemory = 0;
+
+	UpdateStats();
+
+	Super::Deinitialize();
+}
+
+bool UCombatLifeBarPool::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCombatLifeBarPool::Tick(float DeltaTime)
+{
+	// give a widget to any pending component whose owner was just rendered
+	for (int32 i = PendingLifeBars.Num() - 1; i >= 0; --i)
+	{
+		UWidgetComponent* Component = PendingLifeBars[i].Component.Get();
+
+		// drop stale entries
+		if (!Component || !Component->GetOwner())
+		{
+			PendingLifeBars.RemoveAtSwap(i, EAllowShrinking::No);
+			continue;
+		}
+
+		if (Component->GetOwner()->WasRecentlyRendered(GCombatLifeBarsOnScreenTime))
+		{
+			// acquiring removes the pending entry
+			AcquireLifeBar(Component, PendingLifeBars[i].WidgetClass);
+		}
+	}
+}
+
+TStatId UCombatLifeBarPool::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatLifeBarPool, STATGROUP_Tickables);
+}
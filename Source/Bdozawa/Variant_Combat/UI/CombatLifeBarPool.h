@@ -0,0 +1,82 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatLifeBarPool.generated.h"
+
+class UWidgetComponent;
+class UCombatLifeBar;
+
+/**
+ *  Hands out life bar widgets to widget components from a per-world pool.
+ *  Components register as pending when their owner begins play and only receive a widget
+ *  on their owner's first rendered frame, or when explicitly acquired on first damage.
+ *  Widgets are returned to the pool when their owner dies or leaves the level.
+ */
+UCLASS()
+class UCombatLifeBarPool : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** A widget component waiting for its owner to be rendered */
+	struct FPendingLifeBar
+	{
+		TWeakObjectPtr<UWidgetComponent> Component;
+		TSubclassOf<UCombatLifeBar> WidgetClass;
+	};
+
+	/** Widgets returned to the pool, ready to be handed out again */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UCombatLifeBar>> FreeLifeBars;
+
+	/** Components waiting for a widget */
+	TArray<FPendingLifeBar> PendingLifeBars;
+
+	/** Number of widgets currently assigned to components */
+	int32 NumActiveLifeBars = 0;
+
+	/** Number of widgets created by the pool */
+	int32 NumCreatedLifeBars = 0;
+
+	/** Estimated memory held by all widgets created by the pool */
+	SIZE_T ResidentMemory = 0;
+
+public:
+
+	/** Returns true if enemy life bar widgets should be created lazily from the pool */
+	static bool IsPoolingEnabled();
+
+	/** Registers a widget component to receive a widget once its owner is rendered */
+	void AddPendingLifeBar(UWidgetComponent* Component, TSubclassOf<UCombatLifeBar> WidgetClass);
+
+	/** Assigns a pooled widget to the component, reusing a free one if possible. Returns the component's widget if it already has one */
+	UCombatLifeBar* AcquireLifeBar(UWidgetComponent* Component, TSubclassOf<UCombatLifeBar> WidgetClass);
+
+	/** Takes the widget back from the component and returns it to the pool. Safe to call on components without a widget */
+	void ReleaseLifeBar(UWidgetComponent* Component);
+
+protected:
+
+	/** Returns a rough estimate of the memory held by a widget and its widget tree */
+	static SIZE_T GetWidgetMemory(const UCombatLifeBar* Widget);
+
+	/** Publishes the pool counters to the combat stat group */
+	void UpdateStats() const;
+
+public:
+
+	// ~begin USubsystem interface
+	virtual void Deinitialize() override;
+	// ~end USubsystem interface
+
+	// ~begin UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	// ~end UWorldSubsystem interface
+
+	// ~begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	// ~end FTickableGameObject interface
+};
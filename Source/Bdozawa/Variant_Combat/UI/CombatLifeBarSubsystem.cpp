@@ -0,0 +1,235 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatLifeBarSubsystem.h"
+#include "SCombatLifeBarOverlay.h"
+#include "Components/SceneComponent.h"
+#include "Engine/World.h"
+#include "Engine/LocalPlayer.h"
+#include "Engine/GameViewportClient.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "SceneView.h"
+#include "CombatStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Life Bars Update"), STAT_CombatLifeBarsUpdate, STATGROUP_Combat);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Life Bars Drawn"), STAT_CombatLifeBarsDrawn, STATGROUP_Combat);
+
+static int32 GCombatLifeBarsBatched = 1;
+static FAutoConsoleVariableRef CVarCombatLifeBarsBatched(
+	TEXT("Combat.LifeBars.Batched"),
+	GCombatLifeBarsBatched,
+	TEXT("0: each combatant draws its life bar with its own widget component.\n")
+	TEXT("1: all life bars are drawn by a single viewport overlay. Read when combatants begin play."),
+	ECVF_Default);
+
+static float GCombatLifeBarsMaxDistance = 3000.0f;
+static FAutoConsoleVariableRef CVarCombatLifeBarsMaxDistance(
+	TEXT("Combat.LifeBars.MaxDistance"),
+	GCombatLifeBarsMaxDistance,
+	TEXT("Life bars further away from the camera than this distance aren't drawn."),
+	ECVF_Default);
+
+static int32 GCombatLifeBarsMaxPerFrame = 64;
+static FAutoConsoleVariableRef CVarCombatLifeBarsMaxPerFrame(
+	TEXT("Combat.LifeBars.MaxPerFrame"),
+	GCombatLifeBarsMaxPerFrame,
+	TEXT("Maximum number of life bars drawn each frame. The closest bars are kept."),
+	ECVF_Default);
+
+bool UCombatLifeBarSubsystem::IsBatchingEnabled()
+{
+	return GCombatLifeBarsBatched != 0;
+}
+
+int32 UCombatLifeBarSubsystem::RegisterLifeBar(const USceneComponent* Anchor, const FLinearColor& Color)
+{
+	int32 Handle;
+
+	// reuse a free handle if we have one
+	if (FreeHandles.Num() > 0)
+	{
+		Handle = FreeHandles.Pop(EAllowShrinking::No);
+
+		Anchors[Handle] = Anchor;
+		Percentages[Handle] = 1.0f;
+		Colors[Handle] = Color;
+		VisibleFlags[Handle] = true;
+
+	} else {
+
+		Handle = Anchors.Add(Anchor);
+		Percentages.Add(1.0f);
+		Colors.Add(Color);
+		VisibleFlags.Add(true);
+	}
+
+	return Handle;
+}
+
+void UCombatLifeBarSubsystem::UnregisterLifeBar(int32& Handle)
+{
+	if (!Anchors.IsValidIndex(Handle))
+	{
+		return;
+	}
+
+	Anchors[Handle].Reset();
+	VisibleFlags[Handle] = false;
+	FreeHandles.Add(Handle);
+
+	Handle = INDEX_NONE;
+}
+
+void UCombatLifeBarSubsystem::SetLifePercentage(int32 Handle, float Percent)
+{
+	if (Percentages.IsValidIndex(Handle))
+	{
+		Percentages[Handle] = FMath::Clamp(Percent, 0.0f, 1.0f);
+	}
+}
+
+void UCombatLifeBarSubsystem::SetBarColor(int32 Handle, const FLinearColor& Color)
+{
+	if (Colors.IsValidIndex(Handle))
+	{
+		Colors[Handle] = Color;
+	}
+}
+
+void UCombatLifeBarSubsystem::SetLifeBarVisible(int32 Handle, bool bVisible)
+{
+	if (VisibleFlags.IsValidIndex(Handle))
+	{
+		VisibleFlags[Handle] = bVisible;
+	}
+}
+
+void UCombatLifeBarSubsystem::UpdateDrawItems()
+{
+	SCOPE_CYCLE_COUNTER(STAT_CombatLifeBarsUpdate);
+
+	// keep the allocation around for the next frame
+	DrawItems.Reset();
+
+	// life bars are drawn for the first local player's view
+	APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	ULocalPlayer* LocalPlayer = PlayerController ? PlayerController->GetLocalPlayer() : nullptr;
+
+	if (!LocalPlayer || !LocalPlayer->ViewportClient)
+	{
+		return;
+	}
+
+	FSceneViewProjectionData ProjectionData;
+
+	if (!LocalPlayer->GetProjectionData(LocalPlayer->ViewportClient->Viewport, ProjectionData))
+	{
+		return;
+	}
+
+	// compute the view projection once for all bars
+	const FMatrix ViewProjection = ProjectionData.ComputeViewProjectionMatrix();
+	const FIntRect ViewRect = ProjectionData.GetConstrainedViewRect();
+	const FVector ViewOrigin = ProjectionData.ViewOrigin;
+	const float MaxDistanceSquared = FMath::Square(GCombatLifeBarsMaxDistance);
+
+	for (int32 Handle = 0; Handle < Anchors.Num(); ++Handle)
+	{
+		if (!VisibleFlags[Handle])
+		{
+			continue;
+		}
+
+		const USceneComponent* Anchor = Anchors[Handle].Get();
+
+		if (!Anchor)
+		{
+			continue;
+		}
+
+		// cull by distance
+		const FVector BarLocation = Anchor->GetComponentLocation();
+		const float DistanceSquared = FVector::DistSquared(BarLocation, ViewOrigin);
+
+		if (DistanceSquared > MaxDistanceSquared)
+		{
+			continue;
+		}
+
+		// cull bars behind the camera or outside the view
+		FVector2D ScreenPosition;
+
+		if (!FSceneView::ProjectWorldToScreen(BarLocation, ViewRect, ViewProjection, ScreenPosition)
+			|| !ViewRect.Contains(FIntPoint(FMath::FloorToInt32(ScreenPosition.X), FMath::FloorToInt32(ScreenPosition.Y))))
+		{
+			continue;
+		}
+
+		FCombatLifeBarDrawItem& DrawItem = DrawItems.AddDefaulted_GetRef();
+		DrawItem.ScreenPosition = FVector2f(ScreenPosition);
+		DrawItem.Percentage = Percentages[Handle];
+		DrawItem.Color = Colors[Handle];
+		DrawItem.DistanceSquared = DistanceSquared;
+	}
+
+	// keep only the closest bars if we're over the cap
+	const int32 MaxBars = FMath::Max(GCombatLifeBarsMaxPerFrame, 0);
+
+	if (DrawItems.Num() > MaxBars)
+	{
+		DrawItems.Sort([](const FCombatLifeBarDrawItem& A, const FCombatLifeBarDrawItem& B) { return A.DistanceSquared < B.DistanceSquared; });
+		DrawItems.SetNum(MaxBars, EAllowShrinking::No);
+	}
+
+	SET_DWORD_STAT(STAT_CombatLifeBarsDrawn, DrawItems.Num());
+}
+
+void UCombatLifeBarSubsystem::Deinitialize()
+{
+	// remove the overlay from the viewport
+	if (Overlay.IsValid())
+	{
+		if (UGameViewportClient* GameViewport = GetWorld()->GetGameViewport())
+		{
+			GameViewport->RemoveViewportWidgetContent(Overlay.ToSharedRef());
+		}
+
+		Overlay.Reset();
+	}
+
+	Super::Deinitialize();
+}
+
+bool UCombatLifeBarSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCombatLifeBarSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// add the overlay to the game viewport. Dedicated servers don't have one
+	UGameViewportClient* GameViewport = InWorld.GetGameViewport();
+
+	if (GameViewport && IsBatchingEnabled())
+	{
+		SAssignNew(Overlay, SCombatLifeBarOverlay, this);
+		GameViewport->AddViewportWidgetContent(Overlay.ToSharedRef());
+	}
+}
+
+void UCombatLifeBarSubsystem::Tick(float DeltaTime)
+{
+	// tickable world subsystems tick after all actors, so bar anchors are in their final positions
+	if (Overlay.IsValid())
+	{
+		UpdateDrawItems();
+	}
+}
+
+TStatId UCombatLifeBarSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatLifeBarSubsystem, STATGROUP_Tickables);
+}
@@ -0,0 +1,105 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatLifeBarSubsystem.generated.h"
+
+class USceneComponent;
+class SCombatLifeBarOverlay;
+
+/**
+ *  A life bar that passed culling this frame, projected to viewport pixels
+ */
+struct FCombatLifeBarDrawItem
+{
+	/** Center of the bar in viewport pixels */
+	FVector2f ScreenPosition = FVector2f::ZeroVector;
+
+	/** Fill percentage in the 0-1 range */
+	float Percentage = 1.0f;
+
+	/** Fill color */
+	FLinearColor Color = FLinearColor::Red;
+
+	/** Squared distance to the camera, used to keep the closest bars when over the cap */
+	float DistanceSquared = 0.0f;
+};
+
+/**
+ *  Draws the life bars of all registered combatants from a single viewport overlay.
+ *  Bar state lives in compact arrays indexed by handle. Once per frame, every visible bar is projected with a single
+ *  view projection matrix, culled by distance and frustum, capped, and then painted in one Slate element batch.
+ *  Replaces a widget component and user widget per combatant.
+ */
+UCLASS()
+class UCombatLifeBarSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Scene component each bar is drawn above. Invalid for free handles */
+	TArray<TWeakObjectPtr<const USceneComponent>> Anchors;
+
+	/** Fill percentage of each bar */
+	TArray<float> Percentages;
+
+	/** Fill color of each bar */
+	TArray<FLinearColor> Colors;
+
+	/** Visibility flag of each bar */
+	TArray<bool> VisibleFlags;
+
+	/** Handles released by unregistered bars, reused before growing the arrays */
+	TArray<int32> FreeHandles;
+
+	/** Bars to draw this frame */
+	TArray<FCombatLifeBarDrawItem> DrawItems;
+
+	/** Overlay widget added to the game viewport */
+	TSharedPtr<SCombatLifeBarOverlay> Overlay;
+
+public:
+
+	/** Returns true if life bars should be drawn by this subsystem instead of per-actor widget components */
+	static bool IsBatchingEnabled();
+
+	/** Registers a life bar drawn above the given component. Returns its handle */
+	int32 RegisterLifeBar(const USceneComponent* Anchor, const FLinearColor& Color);
+
+	/** Unregisters a life bar and resets the handle */
+	void UnregisterLifeBar(int32& Handle);
+
+	/** Sets the fill percentage of a life bar */
+	void SetLifePercentage(int32 Handle, float Percent);
+
+	/** Sets the fill color of a life bar */
+	void SetBarColor(int32 Handle, const FLinearColor& Color);
+
+	/** Shows or hides a life bar */
+	void SetLifeBarVisible(int32 Handle, bool bVisible);
+
+	/** Returns the bars to draw this frame */
+	const TArray<FCombatLifeBarDrawItem>& GetDrawItems() const { return DrawItems; }
+
+protected:
+
+	/** Projects and culls all visible bars for the first local player's view */
+	void UpdateDrawItems();
+
+public:
+
+	// ~begin USubsystem interface
+	virtual void Deinitialize() override;
+	// ~end USubsystem interface
+
+	// ~begin UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	// ~end UWorldSubsystem interface
+
+	// ~begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	// ~end FTickableGameObject interface
+};
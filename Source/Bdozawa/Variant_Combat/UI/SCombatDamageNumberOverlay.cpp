@@ -0,0 +1,54 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "SCombatDamageNumberOverlay.h"
+#include "CombatDamageNumberSubsystem.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Fonts/FontMeasure.h"
+#include "Rendering/DrawElements.h"
+#include "Rendering/SlateRenderer.h"
+#include "Styling/CoreStyle.h"
+
+void SCombatDamageNumberOverlay::Construct(const FArguments& InArgs, UCombatDamageNumberSubsystem* InSubsystem)
+{
+	Subsystem = InSubsystem;
+
+	Font = FCoreStyle::GetDefaultFontStyle("Bold", 20);
+	Font.OutlineSettings.OutlineSize = 2;
+
+	// the overlay only draws, so let input pass through
+	SetVisibility(EVisibility::HitTestInvisible);
+}
+
+int32 SCombatDamageNumberOverlay::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
+{
+	const UCombatDamageNumberSubsystem* DamageNumbers = Subsystem.Get();
+
+	if (!DamageNumbers || DamageNumbers->GetDrawItems().IsEmpty())
+	{
+		return LayerId;
+	}
+
+	// draw items are in viewport pixels, so undo the DPI scale to get to local space
+	const float InvScale = 1.0f / AllottedGeometry.Scale;
+	const TSharedRef<FSlateFontMeasure> FontMeasure = FSlateApplication::Get().GetRenderer()->GetFontMeasureService();
+
+	for (const FCombatDamageNumberDrawItem& DrawItem : DamageNumbers->GetDrawItems())
+	{
+		const FString& Text = DamageNumbers->GetEntryText(DrawItem.EntryIndex);
+
+		// center the scaled text on the number's position. Measurements are cached by the font cache
+		const FVector2f TextSize = FVector2f(FontMeasure->Measure(Text, Font));
+		const FVector2f TopLeft = (DrawItem.ScreenPosition * InvScale) - (TextSize * DrawItem.Scale * 0.5f);
+
+		FSlateDrawElement::MakeText(OutDrawElements, LayerId, AllottedGeometry.ToPaintGeometry(TextSize, FSlateLayoutTransform(DrawItem.Scale, TopLeft)), Text, Font, ESlateDrawEffect::None, DrawItem.Color);
+	}
+
+	return LayerId;
+}
+
+FVector2D SCombatDamageNumberOverlay::ComputeDesiredSize(float LayoutScaleMultiplier) const
+{
+	// the overlay fills whatever space the viewport gives it
+	return FVector2D::ZeroVector;
+}
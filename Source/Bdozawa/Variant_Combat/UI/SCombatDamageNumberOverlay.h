@@ -0,0 +1,37 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Widgets/SLeafWidget.h"
+#include "Fonts/SlateFontInfo.h"
+
+class UCombatDamageNumberSubsystem;
+
+/**
+ *  Viewport overlay that paints every damage number animated by the damage number subsystem.
+ *  All numbers share one font and layer, so Slate batches them together.
+ */
+class SCombatDamageNumberOverlay : public SLeafWidget
+{
+public:
+
+	SLATE_BEGIN_ARGS(SCombatDamageNumberOverlay) {}
+	SLATE_END_ARGS()
+
+	/** Constructs the overlay for the given subsystem */
+	void Construct(const FArguments& InArgs, UCombatDamageNumberSubsystem* InSubsystem);
+
+	// ~begin SWidget interface
+	virtual int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
+	virtual FVector2D ComputeDesiredSize(float LayoutScaleMultiplier) const override;
+	// ~end SWidget interface
+
+protected:
+
+	/** Subsystem that owns the damage numbers */
+	TWeakObjectPtr<UCombatDamageNumberSubsystem> Subsystem;
+
+	/** Font used for all damage numbers */
+	FSlateFontInfo Font;
+};
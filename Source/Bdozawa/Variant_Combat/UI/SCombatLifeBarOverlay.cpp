@@ -0,0 +1,72 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "SCombatLifeBarOverlay.h"
+#include "CombatLifeBarSubsystem.h"
+#include "Rendering/DrawElements.h"
+#include "Styling/CoreStyle.h"
+
+namespace CombatLifeBarOverlay
+{
+	/** Size of a life bar, in viewport pixels */
+	static const FVector2f BarSize(80.0f, 8.0f);
+
+	/** Padding between the bar background and its fill */
+	static const float BarPadding = 1.0f;
+
+	/** Background color for all bars */
+	static const FLinearColor BackgroundColor(0.0f, 0.0f, 0.0f, 0.6f);
+}
+
+void SCombatLifeBarOverlay::Construct(const FArguments& InArgs, UCombatLifeBarSubsystem* InSubsystem)
+{
+	Subsystem = InSubsystem;
+	BarBrush = FCoreStyle::Get().GetBrush("GenericWhiteBox");
+
+	// the overlay only draws, so let input pass through
+	SetVisibility(EVisibility::HitTestInvisible);
+}
+
+int32 SCombatLifeBarOverlay::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
+{
+	const UCombatLifeBarSubsystem* LifeBars = Subsystem.Get();
+
+	if (!LifeBars || LifeBars->GetDrawItems().IsEmpty())
+	{
+		return LayerId;
+	}
+
+	using namespace CombatLifeBarOverlay;
+
+	// draw items are in viewport pixels, so undo the DPI scale to get to local space
+	const float InvScale = 1.0f / AllottedGeometry.Scale;
+	const FVector2f LocalBarSize = BarSize * InvScale;
+	const FVector2f LocalPadding(BarPadding * InvScale);
+
+	const int32 BackgroundLayer = LayerId;
+	const int32 FillLayer = LayerId + 1;
+
+	for (const FCombatLifeBarDrawItem& DrawItem : LifeBars->GetDrawItems())
+	{
+		const FVector2f TopLeft = (DrawItem.ScreenPosition * InvScale) - (LocalBarSize * 0.5f);
+
+		// background
+		FSlateDrawElement::MakeBox(OutDrawElements, BackgroundLayer, AllottedGeometry.ToPaintGeometry(LocalBarSize, FSlateLayoutTransform(TopLeft)), BarBrush, ESlateDrawEffect::None, BackgroundColor);
+
+		// fill
+		const FVector2f FillSize((LocalBarSize.X - LocalPadding.X * 2.0f) * DrawItem.Percentage, LocalBarSize.Y - LocalPadding.Y * 2.0f);
+
+		if (FillSize.X > 0.0f)
+		{
+			FSlateDrawElement::MakeBox(OutDrawElements, FillLayer, AllottedGeometry.ToPaintGeometry(FillSize, FSlateLayoutTransform(TopLeft + LocalPadding)), BarBrush, ESlateDrawEffect::None, DrawItem.Color);
+		}
+	}
+
+	return FillLayer;
+}
+
+FVector2D SCombatLifeBarOverlay::ComputeDesiredSize(float LayoutScaleMultiplier) const
+{
+	// the overlay fills whatever space the viewport gives it
+	return FVector2D::ZeroVector;
+}
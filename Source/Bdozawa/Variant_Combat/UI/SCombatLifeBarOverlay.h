@@ -0,0 +1,37 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Widgets/SLeafWidget.h"
+
+class UCombatLifeBarSubsystem;
+struct FSlateBrush;
+
+/**
+ *  Viewport overlay that paints every life bar projected by the life bar subsystem.
+ *  All bar backgrounds share one layer and brush, and so do all fills, so Slate batches them into two draw calls.
+ */
+class SCombatLifeBarOverlay : public SLeafWidget
+{
+public:
+
+	SLATE_BEGIN_ARGS(SCombatLifeBarOverlay) {}
+	SLATE_END_ARGS()
+
+	/** Constructs the overlay for the given subsystem */
+	void Construct(const FArguments& InArgs, UCombatLifeBarSubsystem* InSubsystem);
+
+	// ~begin SWidget interface
+	virtual int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
+	virtual FVector2D ComputeDesiredSize(float LayoutScaleMultiplier) const override;
+	// ~end SWidget interface
+
+protected:
+
+	/** Subsystem that owns the bar data */
+	TWeakObjectPtr<UCombatLifeBarSubsystem> Subsystem;
+
+	/** Brush used for both the bar backgrounds and fills */
+	const FSlateBrush* BarBrush = nullptr;
+};
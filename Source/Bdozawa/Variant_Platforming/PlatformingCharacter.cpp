@@ -12,6 +12,8 @@
 #include "EnhancedInputComponent.h"
 #include "TimerManager.h"
 #include "Engine/LocalPlayer.h"
+#include "BdozawaAllocationScope.h"
+#include "BdozawaSpawnPointSubsystem.h"
 
 APlatformingCharacter::APlatformingCharacter()
 {
@@ -102,6 +104,8 @@ void APlatformingCharacter::Dash()
 
 void APlatformingCharacter::MultiJump()
 {
+	BDOZAWA_ZERO_ALLOC_SCOPE("Platforming.MultiJump");
+
 	// ignore jumps while dashing
 	if(bIsDashing)
 		return;
@@ -120,10 +124,7 @@ void APlatformingCharacter::MultiJump()
 			const FVector TraceEnd = TraceStart + (GetActorForwardVector() * WallJumpTraceDistance);
 			const FCollisionShape TraceShape = FCollisionShape::MakeSphere(WallJumpTraceRadius);
 
-			FCollisionQueryParams QueryParams;
-			QueryParams.AddIgnoredActor(this);
-
-			if (GetWorld()->SweepSingleByChannel(OutHit, TraceStart, TraceEnd, FQuat(), ECollisionChannel::ECC_Visibility, TraceShape, QueryParams))
+			if (GetWorld()->SweepSingleByChannel(OutHit, TraceStart, TraceEnd, FQuat(), ECollisionChannel::ECC_Visibility, TraceShape, WallJumpQueryParams))
 			{
 				// rotate the character to face away from the wall, so we're correctly oriented for the next wall jump
 				FRotator WallOrientation = OutHit.ImpactNormal.ToOrientationRotator();
@@ -313,6 +314,14 @@ bool APlatformingCharacter::HasWallJumped() const
 	return bHasWallJumped;
 }
 
+void APlatformingCharacter::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// build the wall jump query params once, so the trace doesn't rebuild them every time
+	WallJumpQueryParams = FCollisionQueryParams(SCENE_QUERY_STAT(PlatformingWallJumpTrace), false, this);
+}
+
 void APlatformingCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
 	Super::EndPlay(EndPlayReason);
@@ -367,3 +376,59 @@ void APlatformingCharacter::OnMovementModeChanged(EMovementMode PrevMovementMode
 	}
 }
 
+void APlatformingCharacter::FellOutOfWorld(const UDamageType& DamageType)
+{
+	// reuse this character if we know where to respawn it
+	if (UBdozawaSpawnPointSubsystem::IsInPlaceRespawnEnabled())
+	{
+		if (UBdozawaSpawnPointSubsystem* SpawnPoints = GetWorld()->GetSubsystem<UBdozawaSpawnPointSubsystem>())
+		{
+			FTransform RespawnTransform;
+
+			if (SpawnPoints->GetRespawnTransform(GetController(), RespawnTransform))
+			{
+				RespawnInPlace(RespawnTransform);
+				return;
+			}
+		}
+	}
+
+	// destroy the character and let it be respawned by the Player Controller
+	Super::FellOutOfWorld(DamageType);
+}
+
+void APlatformingCharacter::RespawnInPlace(const FTransform& RespawnTransform)
+{
+	GetWorld()->GetTimerManager().ClearTimer(WallJumpTimer);
+
+	// cancel the dash. Interrupting the dash montage also restores gravity
+	if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
+	{
+		AnimInstance->StopAllMontages(0.0f);
+	}
+
+	if (bIsDashing)
+	{
+		EndDash();
+	}
+
+	// reset the jump and dash state
+	bHasWallJumped = false;
+	bHasDoubleJumped = false;
+	bHasDashed = false;
+
+	SetJumpTrailState(false);
+
+	// move to the respawn point
+	SetActorLocationAndRotation(RespawnTransform.GetLocation(), RespawnTransform.GetRotation(), false, nullptr, ETeleportType::ResetPhysics);
+
+	if (Controller)
+	{
+		Controller->SetControlRotation(RespawnTransform.Rotator());
+	}
+
+	// restore movement
+	GetCharacterMovement()->StopMovementImmediately();
+	GetCharacterMovement()->SetDefaultMovementMode();
+}
+
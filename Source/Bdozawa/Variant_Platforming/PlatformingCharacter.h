@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
 #include "Animation/AnimInstance.h"
+#include "CollisionQueryParams.h"
 #include "PlatformingCharacter.generated.h"
 
 
@@ -126,6 +127,9 @@ public:
 	bool HasWallJumped() const;
 
 public:	
+
+	/** Gameplay initialization */
+	virtual void BeginPlay() override;
 	
 	/** EndPlay cleanup */
 	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
@@ -139,6 +143,14 @@ public:
 	/** Handle movement mode changes to keep track of coyote time jumps */
 	virtual void OnMovementModeChanged(EMovementMode PrevMovementMode, uint8 PreviousCustomMode = 0) override;
 
+	/** Respawns the character in place instead of destroying it, if in-place respawns are enabled */
+	virtual void FellOutOfWorld(const UDamageType& DamageType) override;
+
+public:
+
+	/** Resets jump, dash and movement state, and teleports the character to the respawn transform */
+	void RespawnInPlace(const FTransform& RespawnTransform);
+
 protected:
 
 	/** movement state flag bits, packed into a uint8 for memory efficiency */
@@ -153,6 +165,9 @@ protected:
 	/** Dash montage ended delegate */
 	FOnMontageEnded OnDashMontageEnded;
 
+	/** Query params ignoring this character for wall jump traces. Built once in BeginPlay */
+	FCollisionQueryParams WallJumpQueryParams;
+
 	/** Distance to trace ahead of the character to look for walls to jump from */
 	UPROPERTY(EditAnywhere, Category="Wall Jump", meta = (ClampMin = 0, ClampMax = 1000, Units = "cm"))
 	float WallJumpTraceDistance = 50.0f;
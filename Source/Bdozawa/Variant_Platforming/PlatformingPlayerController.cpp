@@ -4,9 +4,8 @@
 #include "Variant_Platforming/PlatformingPlayerController.h"
 #include "EnhancedInputSubsystems.h"
 #include "InputMappingContext.h"
-#include "Kismet/GameplayStatics.h"
-#include "GameFramework/PlayerStart.h"
 #include "PlatformingCharacter.h"
+#include "BdozawaSpawnPointSubsystem.h"
 #include "Engine/LocalPlayer.h"
 #include "Engine/World.h"
 #include "Blueprint/UserWidget.h"
@@ -72,15 +71,13 @@ void APlatformingPlayerController::OnPossess(APawn* InPawn)
 
 void APlatformingPlayerController::OnPawnDestroyed(AActor* DestroyedActor)
 {
-	// find the player start
-	TArray<AActor*> ActorList;
-	UGameplayStatics::GetAllActorsOfClass(GetWorld(), APlayerStart::StaticClass(), ActorList);
+	// find the player start from the spawn point registry
+	UBdozawaSpawnPointSubsystem* SpawnPoints = GetWorld()->GetSubsystem<UBdozawaSpawnPointSubsystem>();
+	FTransform SpawnTransform;
 
-	if (ActorList.Num() > 0)
+	if (SpawnPoints && SpawnPoints->GetRespawnTransform(this, SpawnTransform))
 	{
 		// spawn a character at the player start
-		const FTransform SpawnTransform = ActorList[0]->GetActorTransform();
-
 		if (APlatformingCharacter* RespawnedCharacter = GetWorld()->SpawnActor<APlatformingCharacter>(CharacterClass, SpawnTransform))
 		{
 			// possess the character
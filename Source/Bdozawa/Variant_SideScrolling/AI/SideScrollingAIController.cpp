@@ -3,6 +3,7 @@
 
 #include "SideScrollingAIController.h"
 #include "GameplayStateTreeModule/Public/Components/StateTreeAIComponent.h"
+#include "Engine/World.h"
 
 ASideScrollingAIController::ASideScrollingAIController()
 {
@@ -17,3 +18,25 @@ ASideScrollingAIController::ASideScrollingAIController()
 	// this is necessary for EnvQueries to work correctly
 	bAttachToPawn = true;
 }
+
+void ASideScrollingAIController::OnPossess(APawn* InPawn)
+{
+	Super::OnPossess(InPawn);
+
+	// tick the StateTree less often while the pawn is far away from the player
+	if (UBdozawaTickLODSubsystem* TickLOD = GetWorld()->GetSubsystem<UBdozawaTickLODSubsystem>())
+	{
+		TickLOD->RegisterAgent(this, StateTreeAI, TickLODPolicy);
+	}
+}
+
+void ASideScrollingAIController::OnUnPossess()
+{
+	// restore the full StateTree tick rate
+	if (UBdozawaTickLODSubsystem* TickLOD = GetWorld()->GetSubsystem<UBdozawaTickLODSubsystem>())
+	{
+		TickLOD->UnregisterAgent(this);
+	}
+
+	Super::OnUnPossess();
+}
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "AIController.h"
+#include "BdozawaTickLODSubsystem.h"
 #include "SideScrollingAIController.generated.h"
 
 class UStateTreeAIComponent;
@@ -20,8 +21,22 @@ class ASideScrollingAIController : public AAIController
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "AI", meta = (AllowPrivateAccess = "true"))
 	UStateTreeAIComponent* StateTreeAI;
 
+protected:
+
+	/** Lowers the StateTree tick rate while the possessed pawn is far away from or out of view of the player */
+	UPROPERTY(EditAnywhere, Category="Tick LOD")
+	FBdozawaTickLODPolicy TickLODPolicy;
+
 public:
 
 	/** Constructor */
 	ASideScrollingAIController();
+
+protected:
+
+	/** Starts applying the tick LOD policy to the StateTree */
+	virtual void OnPossess(APawn* InPawn) override;
+
+	/** Stops applying the tick LOD policy to the StateTree */
+	virtual void OnUnPossess() override;
 };
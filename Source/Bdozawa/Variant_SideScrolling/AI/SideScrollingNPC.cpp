@@ -4,6 +4,10 @@
 #include "SideScrollingNPC.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "TimerManager.h"
+#include "BdozawaProximitySubsystem.h"
+#include "BdozawaTickLODSubsystem.h"
+#include "BdozawaSignificanceSubsystem.h"
+#include "Components/SkeletalMeshComponent.h"
 
 ASideScrollingNPC::ASideScrollingNPC()
 {
@@ -12,12 +16,44 @@ ASideScrollingNPC::ASideScrollingNPC()
 	GetCharacterMovement()->MaxWalkSpeed = 150.0f;
 }
 
+void ASideScrollingNPC::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// remember the mesh collision, so it can be restored when we become significant again
+	MeshCollisionEnabled = GetMesh()->GetCollisionEnabled();
+
+	// start tracking the distance to the player
+	if (UBdozawaProximitySubsystem* ProximitySubsystem = GetWorld()->GetSubsystem<UBdozawaProximitySubsystem>())
+	{
+		ProximityHandle = ProximitySubsystem->RegisterAgent(this);
+	}
+
+	// start ranking our significance
+	if (UBdozawaSignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UBdozawaSignificanceSubsystem>())
+	{
+		Significance->RegisterAgent(this, SignificanceSettings);
+	}
+}
+
 void ASideScrollingNPC::EndPlay(EEndPlayReason::Type EndPlayReason)
 {
 	Super::EndPlay(EndPlayReason);
 
 	// clear the deactivation timer
 	GetWorld()->GetTimerManager().ClearTimer(DeactivationTimer);
+
+	// stop tracking the distance to the player
+	if (UBdozawaProximitySubsystem* ProximitySubsystem = GetWorld()->GetSubsystem<UBdozawaProximitySubsystem>())
+	{
+		ProximitySubsystem->UnregisterAgent(ProximityHandle);
+	}
+
+	// stop ranking our significance
+	if (UBdozawaSignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UBdozawaSignificanceSubsystem>())
+	{
+		Significance->UnregisterAgent(this);
+	}
 }
 
 void ASideScrollingNPC::Interaction(AActor* Interactor)
@@ -31,6 +67,12 @@ void ASideScrollingNPC::Interaction(AActor* Interactor)
 	// reset the deactivation flag
 	bDeactivated = true;
 
+	// make the StateTree react at full rate
+	if (UBdozawaTickLODSubsystem* TickLOD = GetWorld()->GetSubsystem<UBdozawaTickLODSubsystem>())
+	{
+		TickLOD->BoostAgent(this);
+	}
+
 	// stop character movement immediately
 	GetCharacterMovement()->StopMovementImmediately();
 
@@ -50,3 +92,14 @@ void ASideScrollingNPC::ResetDeactivation()
 	// reset the deactivation flag
 	bDeactivated = false;
 }
+
+bool ASideScrollingNPC::IsEngaged() const
+{
+	return bDeactivated;
+}
+
+void ASideScrollingNPC::ApplySignificanceLOD(const FBdozawaSignificanceLOD& LOD)
+{
+	// far away NPCs only need their capsule
+	GetMesh()->SetCollisionEnabled(LOD.bDetailedCollision ? MeshCollisionEnabled.GetValue() : ECollisionEnabled::NoCollision);
+}
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
 #include "SideScrollingInteractable.h"
+#include "BdozawaSignificanceAgent.h"
 #include "SideScrollingNPC.generated.h"
 
 /**
@@ -13,7 +14,7 @@
  *  It can be temporarily deactivated through Actor interactions
  */
 UCLASS(abstract)
-class ASideScrollingNPC : public ACharacter, public ISideScrollingInteractable
+class ASideScrollingNPC : public ACharacter, public ISideScrollingInteractable, public IBdozawaSignificanceAgent
 {
 	GENERATED_BODY()
 
@@ -40,6 +41,18 @@ public:
 	/** Timer to reactivate the NPC */
 	FTimerHandle DeactivationTimer;
 
+protected:
+
+	/** Handle of this NPC in the proximity subsystem */
+	int32 ProximityHandle = INDEX_NONE;
+
+	/** LOD bundles applied as the NPC's significance changes */
+	UPROPERTY(EditAnywhere, Category="Significance")
+	FBdozawaSignificanceSettings SignificanceSettings;
+
+	/** Collision setting of the skeletal mesh on spawn, restored when the NPC becomes significant again */
+	TEnumAsByte<ECollisionEnabled::Type> MeshCollisionEnabled = ECollisionEnabled::QueryAndPhysics;
+
 public:
 
 	/** Constructor */
@@ -47,6 +60,9 @@ public:
 
 public:
 
+	/** Gameplay initialization */
+	virtual void BeginPlay() override;
+
 	/** Cleanup */
 	virtual void EndPlay(EEndPlayReason::Type EndPlayReason) override;
 
@@ -59,6 +75,19 @@ public:
 
 //	~end IInteractable interface
 
+	// ~begin IBdozawaSignificanceAgent interface
+
+	/** Returns true while the NPC is deactivated by a player interaction */
+	virtual bool IsEngaged() const override;
+
+	/** Enables or disables the skeletal mesh collision */
+	virtual void ApplySignificanceLOD(const FBdozawaSignificanceLOD& LOD) override;
+
+	// ~end IBdozawaSignificanceAgent interface
+
 	/** Reactivates the NPC */
 	void ResetDeactivation();
+
+	/** Returns this NPC's handle in the proximity subsystem */
+	int32 GetProximityHandle() const { return ProximityHandle; }
 };
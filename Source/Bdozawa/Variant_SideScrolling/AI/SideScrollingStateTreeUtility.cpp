@@ -5,20 +5,33 @@
 #include "StateTreeExecutionContext.h"
 #include "StateTreeExecutionTypes.h"
 #include "AIController.h"
-#include "Kismet/GameplayStatics.h"
+#include "BdozawaPlayerSnapshotSubsystem.h"
+#include "BdozawaProximitySubsystem.h"
+#include "SideScrollingNPC.h"
 
 EStateTreeRunStatus FStateTreeGetPlayerTask::Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const
 {
 	// get the instance data
 	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
 
-	// set the player pawn as the target
-	InstanceData.TargetPlayer = UGameplayStatics::GetPlayerPawn(InstanceData.Controller.Get(), 0);
+	// set the first player's pawn from this frame's player snapshot as the target
+	UBdozawaPlayerSnapshotSubsystem* PlayerSnapshot = Context.GetWorld()->GetSubsystem<UBdozawaPlayerSnapshotSubsystem>();
+	const FBdozawaPlayerSnapshotEntry* Player = PlayerSnapshot ? PlayerSnapshot->GetSnapshot().GetFirstPlayer() : nullptr;
+
+	InstanceData.TargetPlayer = Player ? Player->Pawn : nullptr;
 
 	// are the NPC and target valid?
-	if (IsValid(InstanceData.TargetPlayer) && IsValid(InstanceData.NPC))
+	if (Player && IsValid(InstanceData.NPC))
 	{
-		InstanceData.bValidTarget = FVector::Distance(InstanceData.NPC->GetActorLocation(), InstanceData.TargetPlayer->GetActorLocation()) < InstanceData.RangeMax;
+		// read the distance computed for this frame if the NPC is tracked by the proximity subsystem
+		const ASideScrollingNPC* NPC = Cast<ASideScrollingNPC>(InstanceData.NPC);
+		const UBdozawaProximitySubsystem* Proximity = Context.GetWorld()->GetSubsystem<UBdozawaProximitySubsystem>();
+
+		const float DistanceSquared = (NPC && Proximity && NPC->GetProximityHandle() != INDEX_NONE)
+			? Proximity->GetDistanceSquaredToPlayer(NPC->GetProximityHandle())
+			: FVector::DistSquared(InstanceData.NPC->GetActorLocation(), Player->Location);
+
+		InstanceData.bValidTarget = DistanceSquared < FMath::Square(InstanceData.RangeMax);
 	}
 
 	return EStateTreeRunStatus::Running;
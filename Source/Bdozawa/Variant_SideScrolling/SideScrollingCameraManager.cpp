@@ -6,9 +6,12 @@
 #include "Engine/HitResult.h"
 #include "CollisionQueryParams.h"
 #include "Engine/World.h"
+#include "BdozawaAllocationScope.h"
 
 void ASideScrollingCameraManager::UpdateViewTarget(FTViewTarget& OutVT, float DeltaTime)
 {
+	BDOZAWA_ZERO_ALLOC_SCOPE("SideScrolling.UpdateViewTarget");
+
 	// ensure the view target is a pawn
 	APawn* TargetPawn = Cast<APawn>(OutVT.Target);
 
@@ -62,11 +65,15 @@ void ASideScrollingCameraManager::UpdateViewTarget(FTViewTarget& OutVT, float De
 
 			const FVector End = CurrentActorLocation + FVector(0.0f, 0.0f, -1000.0f);
 
-			FCollisionQueryParams QueryParams;
-			QueryParams.AddIgnoredActor(TargetPawn);
+			// rebuild the query params if the view target changed
+			if (FloorQueryPawn.Get() != TargetPawn)
+			{
+				FloorQueryParams = FCollisionQueryParams(SCENE_QUERY_STAT(SideScrollingCameraFloor), false, TargetPawn);
+				FloorQueryPawn = TargetPawn;
+			}
 
 			// only update height if we're not about to hit ground
-			bZUpdate = !GetWorld()->LineTraceSingleByChannel(OutHit, CurrentActorLocation, End, ECC_Visibility, QueryParams);
+			bZUpdate = !GetWorld()->LineTraceSingleByChannel(OutHit, CurrentActorLocation, End, ECC_Visibility, FloorQueryParams);
 
 		}
 
@@ -4,8 +4,11 @@
 
 #include "CoreMinimal.h"
 #include "Camera/PlayerCameraManager.h"
+#include "CollisionQueryParams.h"
 #include "SideScrollingCameraManager.generated.h"
 
+class APawn;
+
 /**
  *  Simple side scrolling camera with smooth scrolling and horizontal bounds
  */
@@ -44,4 +47,10 @@ protected:
 
 	/** First-time update camera setup flag */
 	bool bSetup = true;
+
+	/** Query params for the floor trace, ignoring the current view target. Rebuilt only when the target changes */
+	FCollisionQueryParams FloorQueryParams;
+
+	/** View target the floor query params were built for */
+	TWeakObjectPtr<APawn> FloorQueryPawn;
 };
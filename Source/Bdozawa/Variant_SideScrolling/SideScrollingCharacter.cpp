@@ -13,6 +13,8 @@
 #include "SideScrollingInteractable.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "TimerManager.h"
+#include "BdozawaAllocationScope.h"
+#include "BdozawaSpawnPointSubsystem.h"
 
 ASideScrollingCharacter::ASideScrollingCharacter()
 {
@@ -59,6 +61,19 @@ ASideScrollingCharacter::ASideScrollingCharacter()
 	JumpMaxCount = 3;
 }
 
+void ASideScrollingCharacter::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// build the trace query params once, so traces don't rebuild them every time
+	TraceQueryParams = FCollisionQueryParams(SCENE_QUERY_STAT(SideScrollingCharacterTrace), false, this);
+
+	InteractObjectParams.AddObjectTypesToQuery(ECC_Pawn);
+	InteractObjectParams.AddObjectTypesToQuery(ECC_WorldDynamic);
+
+	SoftCollisionObjectParams.AddObjectTypesToQuery(SoftCollisionObjectType);
+}
+
 void ASideScrollingCharacter::EndPlay(EEndPlayReason::Type EndPlayReason)
 {
 	Super::EndPlay(EndPlayReason);
@@ -133,6 +148,51 @@ void ASideScrollingCharacter::OnMovementModeChanged(EMovementMode PrevMovementMo
 	}
 }
 
+void ASideScrollingCharacter::FellOutOfWorld(const UDamageType& DamageType)
+{
+	// reuse this character if we know where to respawn it
+	if (UBdozawaSpawnPointSubsystem::IsInPlaceRespawnEnabled())
+	{
+		if (UBdozawaSpawnPointSubsystem* SpawnPoints = GetWorld()->GetSubsystem<UBdozawaSpawnPointSubsystem>())
+		{
+			FTransform RespawnTransform;
+
+			if (SpawnPoints->GetRespawnTransform(GetController(), RespawnTransform))
+			{
+				RespawnInPlace(RespawnTransform);
+				return;
+			}
+		}
+	}
+
+	// destroy the character and let it be respawned by the Player Controller
+	Super::FellOutOfWorld(DamageType);
+}
+
+void ASideScrollingCharacter::RespawnInPlace(const FTransform& RespawnTransform)
+{
+	GetWorld()->GetTimerManager().ClearTimer(WallJumpTimer);
+
+	// reset the jump and platform drop state
+	bHasWallJumped = false;
+	bHasDoubleJumped = false;
+	DropValue = 0.0f;
+
+	SetSoftCollision(false);
+
+	// move to the respawn point
+	SetActorLocationAndRotation(RespawnTransform.GetLocation(), RespawnTransform.GetRotation(), false, nullptr, ETeleportType::ResetPhysics);
+
+	if (Controller)
+	{
+		Controller->SetControlRotation(RespawnTransform.Rotator());
+	}
+
+	// restore movement
+	GetCharacterMovement()->StopMovementImmediately();
+	GetCharacterMovement()->SetDefaultMovementMode();
+}
+
 void ASideScrollingCharacter::Move(const FInputActionValue& Value)
 {
 	FVector2D MoveVector = Value.Get<FVector2D>();
@@ -188,23 +248,15 @@ void ASideScrollingCharacter::DoJumpEnd()
 
 void ASideScrollingCharacter::DoInteract()
 {
+	BDOZAWA_ZERO_ALLOC_SCOPE("SideScrolling.DoInteract");
+
 	// do a sphere trace to look for interactive objects
 	FHitResult OutHit;
 
 	const FVector Start = GetActorLocation();
 	const FVector End = Start + FVector(100.0f, 0.0f, 0.0f);
 
-	FCollisionShape ColSphere;
-	ColSphere.SetSphere(InteractionRadius);
-
-	FCollisionObjectQueryParams ObjectParams;
-	ObjectParams.AddObjectTypesToQuery(ECC_Pawn);
-	ObjectParams.AddObjectTypesToQuery(ECC_WorldDynamic);
-
-	FCollisionQueryParams QueryParams;
-	QueryParams.AddIgnoredActor(this);
-
-	if (GetWorld()->SweepSingleByObjectType(OutHit, Start, End, FQuat::Identity, ObjectParams, ColSphere, QueryParams))
+	if (GetWorld()->SweepSingleByObjectType(OutHit, Start, End, FQuat::Identity, InteractObjectParams, FCollisionShape::MakeSphere(InteractionRadius), TraceQueryParams))
 	{
 		// have we hit an interactable?
 		if (ISideScrollingInteractable* Interactable = Cast<ISideScrollingInteractable>(OutHit.GetActor()))
@@ -217,6 +269,8 @@ void ASideScrollingCharacter::DoInteract()
 
 void ASideScrollingCharacter::MultiJump()
 {
+	BDOZAWA_ZERO_ALLOC_SCOPE("SideScrolling.MultiJump");
+
 	// does the user want to drop to a lower platform?
 	if (DropValue > 0.0f)
 	{
@@ -243,10 +297,7 @@ void ASideScrollingCharacter::MultiJump()
 		const FVector Start = GetActorLocation();
 		const FVector End = Start + (FVector(ActionValueY > 0.0f ? 1.0f : -1.0f, 0.0f, 0.0f) * WallJumpTraceDistance);
 
-		FCollisionQueryParams QueryParams;
-		QueryParams.AddIgnoredActor(this);
-
-		GetWorld()->LineTraceSingleByChannel(OutHit, Start, End, ECC_Visibility, QueryParams);
+		GetWorld()->LineTraceSingleByChannel(OutHit, Start, End, ECC_Visibility, TraceQueryParams);
 
 		if (OutHit.bBlockingHit)
 		{
@@ -311,13 +362,7 @@ void ASideScrollingCharacter::CheckForSoftCollision()
 	const FVector Start = GetActorLocation();
 	const FVector End = Start + (FVector::DownVector * SoftCollisionTraceDistance);
 
-	FCollisionObjectQueryParams ObjectParams;
-	ObjectParams.AddObjectTypesToQuery(SoftCollisionObjectType);
-
-	FCollisionQueryParams QueryParams;
-	QueryParams.AddIgnoredActor(this);
-
-	GetWorld()->LineTraceSingleByObjectType(OutHit, Start, End, ObjectParams, QueryParams);
+	GetWorld()->LineTraceSingleByObjectType(OutHit, Start, End, SoftCollisionObjectParams, TraceQueryParams);
 
 	// did we hit a soft floor?
 	if (OutHit.GetActor())
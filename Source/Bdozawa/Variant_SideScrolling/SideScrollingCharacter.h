@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
+#include "CollisionQueryParams.h"
 #include "SideScrollingCharacter.generated.h"
 
 class UCameraComponent;
@@ -97,6 +98,15 @@ protected:
 	/** If true, this character is moving along the side scrolling axis */
 	bool bMovingHorizontally = false;
 
+	/** Query params ignoring this character, shared by all of its traces. Built once in BeginPlay */
+	FCollisionQueryParams TraceQueryParams;
+
+	/** Object types looked for by interaction traces */
+	FCollisionObjectQueryParams InteractObjectParams;
+
+	/** Object types looked for by soft collision traces */
+	FCollisionObjectQueryParams SoftCollisionObjectParams;
+
 public:
 	
 	/** Constructor */
@@ -104,6 +114,9 @@ public:
 
 protected:
 
+	/** Gameplay initialization */
+	virtual void BeginPlay() override;
+
 	/** Gameplay cleanup */
 	virtual void EndPlay(EEndPlayReason::Type EndPlayReason) override;
 
@@ -119,6 +132,14 @@ protected:
 	/** Handle movement mode changes to keep track of coyote time jumps */
 	virtual void OnMovementModeChanged(EMovementMode PrevMovementMode, uint8 PreviousCustomMode = 0) override;
 
+	/** Respawns the character in place instead of destroying it, if in-place respawns are enabled */
+	virtual void FellOutOfWorld(const UDamageType& DamageType) override;
+
+public:
+
+	/** Resets jump, platform drop and movement state, and teleports the character to the respawn transform */
+	void RespawnInPlace(const FTransform& RespawnTransform);
+
 protected:
 
 	/** Called for movement input */